@@ -0,0 +1,364 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "config/parser.h"
+#include "spline/spline.h"
+#include "string/string.h"
+#include "file/file.h"
+#include "timer/timer.h"
+
+#define SPLINE_BENCH_PARSER_OPTION_GROUP        "spline-bench"
+#define SPLINE_BENCH_PARAMETER_MIN_SIZE         "min-size"
+#define SPLINE_BENCH_PARAMETER_MAX_SIZE         "max-size"
+#define SPLINE_BENCH_PARAMETER_NUM_EVALUATIONS  "evaluations"
+#define SPLINE_BENCH_PARAMETER_MIN_TIME         "min-time"
+#define SPLINE_BENCH_PARAMETER_FORMAT           "format"
+#define SPLINE_BENCH_PARAMETER_OUTPUT           "output"
+
+typedef enum {
+  spline_bench_format_csv,
+  spline_bench_format_json,
+} spline_bench_format_t;
+
+typedef struct spline_bench_t {
+  spline_point_t* points;
+  size_t num_points;
+  
+  spline_t spline;
+  
+  double* locations;
+  size_t num_locations;
+  spline_eval_type_t eval_type;
+  volatile double sum;
+  
+  const char* filename;
+  
+  file_t output;
+  spline_bench_format_t format;
+  double min_time;
+  size_t num_results;
+} spline_bench_t;
+
+typedef size_t (*spline_bench_routine_t)(spline_bench_t* bench, size_t arg);
+
+config_param_t spline_bench_default_options_params[] = {
+  {SPLINE_BENCH_PARAMETER_MIN_SIZE,
+    config_param_type_int,
+    "10",
+    "[10, 100000000]",
+    "The minimum number of spline knots to be benchmarked"},
+  {SPLINE_BENCH_PARAMETER_MAX_SIZE,
+    config_param_type_int,
+    "1000000",
+    "[10, 100000000]",
+    "The maximum number of spline knots to be benchmarked, where the "
+    "number of knots is increased by a factor of ten starting from the "
+    "minimum number of knots. Note that benchmarking 10^8 knots requires "
+    "several gigabytes of memory and disk space"},
+  {SPLINE_BENCH_PARAMETER_NUM_EVALUATIONS,
+    config_param_type_int,
+    "100000",
+    "[1, 100000000]",
+    "The number of spline evaluations per evaluation benchmark run"},
+  {SPLINE_BENCH_PARAMETER_MIN_TIME,
+    config_param_type_float,
+    "0.1",
+    "(0.0, inf)",
+    "The minimum time in [s] spent on repeating each benchmark run, "
+    "where each benchmark is run at least once"},
+  {SPLINE_BENCH_PARAMETER_FORMAT,
+    config_param_type_enum,
+    "csv",
+    "csv|json",
+    "The format of the benchmark results, where 'csv' produces "
+    "comma-separated values with a header line, and 'json' produces an "
+    "array of objects"},
+  {SPLINE_BENCH_PARAMETER_OUTPUT,
+    config_param_type_string,
+    "-",
+    "",
+    "Write benchmark results to the specified output file or '-' for "
+    "stdout"},
+};
+
+const config_default_t spline_bench_default_options = {
+  spline_bench_default_options_params,
+  sizeof(spline_bench_default_options_params)/sizeof(config_param_t),
+};
+
+const char* spline_bench_eval_types[] = {
+  "base",
+  "first",
+  "second",
+};
+
+size_t spline_bench_int(spline_bench_t* bench, size_t arg) {
+  const spline_point_t* points = bench->points;
+  size_t n = bench->num_points;
+  
+  switch (arg) {
+    case 0:
+      spline_int_natural(&bench->spline, points, n);
+      break;
+    case 1:
+      spline_int_clamped(&bench->spline, points, n);
+      break;
+    case 2:
+      spline_int_y1(&bench->spline, points, n, 1.0, -1.0);
+      break;
+    case 3:
+      spline_int_y2(&bench->spline, points, n, 1.0, -1.0);
+      break;
+    case 4:
+      spline_int_y1_y2(&bench->spline, points, n, 1.0, -1.0, 1.0, -1.0,
+        0.5, 0.5);
+      break;
+    case 5:
+      spline_int_periodic(&bench->spline, points, n);
+      break;
+    case 6:
+      spline_int_not_a_knot(&bench->spline, points, n);
+      break;
+    case 7:
+      spline_int_akima(&bench->spline, points, n);
+      break;
+    case 8:
+      spline_int_monotone(&bench->spline, points, n);
+      break;
+    default:
+      spline_int_catmull_rom(&bench->spline, points, n);
+  }
+  error_exit(&bench->spline.error);
+  
+  return n;
+}
+
+size_t spline_bench_eval_bisect(spline_bench_t* bench, size_t arg) {
+  double sum = 0.0;
+  size_t i;
+  
+  for (i = 0; i < bench->num_locations; ++i)
+    sum += spline_eval(&bench->spline, bench->eval_type,
+      bench->locations[i]);
+  bench->sum = sum;
+  
+  return bench->num_locations;
+}
+
+size_t spline_bench_eval_linear(spline_bench_t* bench, size_t arg) {
+  double sum = 0.0;
+  size_t i, index = 0;
+  
+  for (i = 0; i < bench->num_locations; ++i)
+    sum += spline_eval_linear(&bench->spline, bench->eval_type,
+      bench->locations[i], &index);
+  bench->sum = sum;
+  
+  return bench->num_locations;
+}
+
+size_t spline_bench_write(spline_bench_t* bench, size_t arg) {
+  spline_write(bench->filename, &bench->spline);
+  error_exit(&bench->spline.error);
+  
+  return bench->spline.num_knots;
+}
+
+size_t spline_bench_read(spline_bench_t* bench, size_t arg) {
+  spline_read(bench->filename, &bench->spline);
+  error_exit(&bench->spline.error);
+  
+  return bench->spline.num_knots;
+}
+
+void spline_bench_run(spline_bench_t* bench, const char* name,
+    spline_bench_routine_t routine, size_t arg) {
+  size_t num_runs = 0, num_operations = 0;
+  double timestamp, time = 0.0;
+  
+  timer_start(&timestamp);
+  while (!num_runs || (time < bench->min_time)) {
+    num_operations += routine(bench, arg);
+    ++num_runs;
+    time = timer_stop(timestamp);
+  }
+  
+  if (bench->format == spline_bench_format_json)
+    file_printf(&bench->output, "%s  {\"benchmark\": \"%s\", \"size\": %lu, "
+      "\"runs\": %lu, \"operations\": %lu, \"seconds\": %lg, "
+      "\"ns_per_operation\": %lg}", bench->num_results ? ",\n" : "", name,
+      (unsigned long)bench->num_points, (unsigned long)num_runs,
+      (unsigned long)num_operations, time, 1e9*time/num_operations);
+  else
+    file_printf(&bench->output, "%s,%lu,%lu,%lu,%lg,%lg\n", name,
+      (unsigned long)bench->num_points, (unsigned long)num_runs,
+      (unsigned long)num_operations, time, 1e9*time/num_operations);
+  error_exit(&bench->output.error);
+  
+  ++bench->num_results;
+}
+
+int main(int argc, char **argv) {
+  config_parser_t parser;
+  spline_bench_t bench;
+  
+  const char* int_types[] = {"natural", "clamped", "y1", "y2", "y1-y2",
+    "periodic", "not-a-knot", "akima", "monotone", "catmull-rom"};
+  
+  config_parser_init_default(&parser, 0, 0,
+    "Benchmark cubic spline interpolation, evaluation, and file input/output",
+    "The command measures the performance of the spline library for "
+    "splines with increasing numbers of knots and prints the results to a "
+    "file or stdout. The benchmarks cover spline interpolation for each "
+    "type of boundary conditions and local interpolation scheme, spline "
+    "evaluation for each evaluation type at random locations using "
+    "bisection and at increasing locations using bisection and linear "
+    "search, as well as writing and reading splines to and from a file.");
+  config_parser_add_option_group(&parser, SPLINE_BENCH_PARSER_OPTION_GROUP,
+    &spline_bench_default_options, "Spline benchmark options",
+    "These options control the benchmarks performed by the command.");
+  config_parser_parse(&parser, argc, argv, config_parser_exit_error);
+  
+  config_parser_option_group_t* spline_bench_option_group =
+    config_parser_get_option_group(&parser, SPLINE_BENCH_PARSER_OPTION_GROUP);
+  size_t min_size = config_get_int(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_MIN_SIZE);
+  size_t max_size = config_get_int(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_MAX_SIZE);
+  size_t num_evaluations = config_get_int(
+    &spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_NUM_EVALUATIONS);
+  bench.min_time = config_get_float(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_MIN_TIME);
+  bench.format = config_get_enum(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_FORMAT);
+  const char* output = config_get_string(
+    &spline_bench_option_group->options, SPLINE_BENCH_PARAMETER_OUTPUT);
+  
+  file_init_name(&bench.output, output);
+  if (string_equal(output, "-"))
+    file_open_stream(&bench.output, stdout, file_mode_write);
+  else
+    file_open(&bench.output, file_mode_write);
+  error_exit(&bench.output.error);
+  
+  char* filename = 0;
+  int fd;
+  
+  string_printf(&filename, "%s/spline-bench-XXXXXX", P_tmpdir);
+  if ((fd = mkstemp(filename)) < 0) {
+    file_t temp;
+    
+    file_init_name(&temp, filename);
+    error_setf(&temp.error, FILE_ERROR_OPEN, "%s", filename);
+    error_exit(&temp.error);
+  }
+  close(fd);
+  bench.filename = filename;
+  
+  if (bench.format == spline_bench_format_json)
+    file_printf(&bench.output, "[\n");
+  else
+    file_printf(&bench.output,
+      "benchmark,size,runs,operations,seconds,ns_per_operation\n");
+  error_exit(&bench.output.error);
+  
+  bench.points = 0;
+  bench.num_points = 0;
+  bench.locations = malloc(num_evaluations*sizeof(double));
+  bench.num_locations = num_evaluations;
+  bench.sum = 0.0;
+  bench.num_results = 0;
+  spline_init(&bench.spline);
+  
+  size_t size, i;
+  for (size = min_size; size <= max_size; size *= 10) {
+    bench.points = realloc(bench.points, size*sizeof(spline_point_t));
+    bench.num_points = size;
+    
+    for (i = 0; i < size; ++i)
+      spline_point_init(&bench.points[i], i+0.25*sin(i), sin(0.1*i));
+    
+    for (i = 0; i < sizeof(int_types)/sizeof(const char*); ++i) {
+      char* name = 0;
+      
+      string_printf(&name, "int_%s", int_types[i]);
+      spline_bench_run(&bench, name, spline_bench_int, i);
+      string_destroy(&name);
+    }
+    
+    spline_int_natural(&bench.spline, bench.points, size);
+    error_exit(&bench.spline.error);
+    
+    double x_min = bench.spline.knots[0].x;
+    double x_range = bench.spline.knots[bench.spline.num_knots-1].x-x_min;
+    unsigned long seed = 1;
+    
+    for (bench.eval_type = spline_eval_type_base_function;
+        bench.eval_type <= spline_eval_type_second_derivative;
+        ++bench.eval_type) {
+      char* name = 0;
+      
+      for (i = 0; i < num_evaluations; ++i) {
+        seed = seed*6364136223846793005UL+1442695040888963407UL;
+        bench.locations[i] = x_min+x_range*(seed >> 11)*0x1.0p-53;
+      }
+      string_printf(&name, "eval_%s_bisect_random",
+        spline_bench_eval_types[bench.eval_type]);
+      spline_bench_run(&bench, name, spline_bench_eval_bisect, 0);
+      
+      for (i = 0; i < num_evaluations; ++i)
+        bench.locations[i] = x_min+x_range*i/num_evaluations;
+      string_printf(&name, "eval_%s_bisect_sorted",
+        spline_bench_eval_types[bench.eval_type]);
+      spline_bench_run(&bench, name, spline_bench_eval_bisect, 0);
+      string_printf(&name, "eval_%s_linear_sorted",
+        spline_bench_eval_types[bench.eval_type]);
+      spline_bench_run(&bench, name, spline_bench_eval_linear, 0);
+      
+      string_destroy(&name);
+    }
+    
+    spline_bench_run(&bench, "write", spline_bench_write, 0);
+    spline_bench_run(&bench, "read", spline_bench_read, 0);
+    
+    if (max_size/10 < size)
+      break;
+  }
+  
+  if (bench.format == spline_bench_format_json)
+    file_printf(&bench.output, "\n]\n");
+  error_exit(&bench.output.error);
+  
+  unlink(filename);
+  string_destroy(&filename);
+  
+  free(bench.points);
+  free(bench.locations);
+  spline_destroy(&bench.spline);
+  file_destroy(&bench.output);
+  config_parser_destroy(&parser);
+  
+  return 0;
+}
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
 #include "config/parser.h"
@@ -32,6 +33,10 @@
 #define SPLINE_EVAL_PARSER_OPTION_GROUP         "spline-eval"
 #define SPLINE_EVAL_PARAMETER_TYPE              "type"
 #define SPLINE_EVAL_PARAMETER_OUTPUT            "output"
+#define SPLINE_EVAL_PARAMETER_INPUT             "input"
+#define SPLINE_EVAL_PARAMETER_TOLERANCE         "tolerance"
+
+#define SPLINE_EVAL_BLOCK_SIZE                  65536
 
 config_param_t spline_eval_default_arguments_params[] = {
   {SPLINE_EVAL_PARAMETER_FILE,
@@ -65,6 +70,24 @@ config_param_t spline_eval_default_options_params[] = {
     "-",
     "",
     "Write values to the specified output file or '-' for stdout"},
+  {SPLINE_EVAL_PARAMETER_INPUT,
+    config_param_type_string,
+    "",
+    "",
+    "If non-empty, read the locations from the specified input file or "
+    "'-' for stdin instead of generating equidistant locations. The input "
+    "is expected to provide one location per line in its first column, "
+    "where empty lines and lines starting with '#' will be skipped. Each "
+    "location is reproduced verbatim in the output, followed by its "
+    "function value at full precision. The step size will be ignored"},
+  {SPLINE_EVAL_PARAMETER_TOLERANCE,
+    config_param_type_float,
+    "0.0",
+    "[0.0, inf)",
+    "If non-zero, generate curvature-adaptive instead of equidistant "
+    "locations such that the chord error of the output does not exceed "
+    "the specified tolerance, where the step size limits the distance "
+    "between consecutive locations"},
 };
 
 const config_default_t spline_eval_default_options = {
@@ -72,17 +95,104 @@ const config_default_t spline_eval_default_options = {
   sizeof(spline_eval_default_options_params)/sizeof(config_param_t),
 };
 
+void spline_eval_input(spline_t* spline, spline_eval_type_t eval_type,
+    file_t* input_file, file_t* output_file) {
+  char* input = malloc(SPLINE_EVAL_BLOCK_SIZE+1);
+  char* output = 0;
+  size_t max_num_values = SPLINE_EVAL_BLOCK_SIZE/2+1;
+  double* x = malloc(max_num_values*sizeof(double));
+  double* f_x = malloc(max_num_values*sizeof(double));
+  char** tokens = malloc(max_num_values*sizeof(char*));
+  size_t* token_lengths = malloc(max_num_values*sizeof(size_t));
+  size_t length = 0, index = 0, done = 0;
+  
+  output = malloc(SPLINE_EVAL_BLOCK_SIZE+max_num_values*32);
+  
+  while (!done) {
+    size_t num_values = 0, output_length = 0, end, i;
+    ssize_t result = file_read(input_file, (unsigned char*)&input[length],
+      SPLINE_EVAL_BLOCK_SIZE-length);
+    error_exit(&input_file->error);
+    
+    done = ((size_t)result < SPLINE_EVAL_BLOCK_SIZE-length);
+    length += result;
+    
+    end = length;
+    if (!done) {
+      while (end && (input[end-1] != '\n'))
+        --end;
+      if (!end) {
+        error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT,
+          "Line exceeds %d characters", SPLINE_EVAL_BLOCK_SIZE);
+        error_exit(&spline->error);
+      }
+    }
+    char remainder = input[end];
+    input[end] = 0;
+    
+    char* line = input;
+    while (line < &input[end]) {
+      char* line_end = strchr(line, '\n');
+      if (!line_end)
+        line_end = &input[end];
+      *line_end = 0;
+      
+      while ((*line == ' ') || (*line == '\t'))
+        ++line;
+      if (*line && (*line != '#') && (*line != '\r')) {
+        char* token_end;
+        
+        x[num_values] = strtod(line, &token_end);
+        if (token_end == line) {
+          error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT, "%s", line);
+          error_exit(&spline->error);
+        }
+        tokens[num_values] = line;
+        token_lengths[num_values] = token_end-line;
+        ++num_values;
+      }
+      
+      line = line_end+1;
+    }
+    
+    spline_eval_array(spline, eval_type, x, f_x, num_values, &index);
+    
+    for (i = 0; i < num_values; ++i) {
+      memcpy(&output[output_length], tokens[i], token_lengths[i]);
+      output_length += token_lengths[i];
+      output_length += sprintf(&output[output_length], " %.17lg\n", f_x[i]);
+    }
+    if (output_length) {
+      file_write(output_file, (unsigned char*)output, output_length);
+      error_exit(&output_file->error);
+    }
+    
+    input[end] = remainder;
+    length -= end;
+    memmove(input, &input[end], length);
+  }
+  
+  free(input);
+  free(output);
+  free(x);
+  free(f_x);
+  free(tokens);
+  free(token_lengths);
+}
+
 int main(int argc, char **argv) {
   config_parser_t parser;
   spline_t spline;
   file_t output_file;
 
   config_parser_init_default(&parser, &spline_eval_default_arguments, 0,
-    "Evaluate a cubic spline at equidistant locations",
+    "Evaluate a cubic spline at equidistant, adaptive, or given locations",
     "The command evaluates a cubic input spline at equidistant "
     "locations and prints the corresponding function values to a file "
     "or stdout. Depending on the options provided, these values may be "
-    "generated from the base function or its derivatives.");
+    "generated from the base function or its derivatives, the "
+    "locations may be adapted to the curvature of the spline, or they "
+    "may be read from another file.");
   config_parser_add_option_group(&parser, SPLINE_EVAL_PARSER_OPTION_GROUP,
     &spline_eval_default_options, "Spline evaluation options",
     "These options control the spline evaluation performed by the command.");
@@ -99,6 +209,10 @@ int main(int argc, char **argv) {
     &spline_eval_option_group->options, SPLINE_EVAL_PARAMETER_TYPE);
   const char* output = config_get_string(
     &spline_eval_option_group->options, SPLINE_EVAL_PARAMETER_OUTPUT);
+  const char* input = config_get_string(
+    &spline_eval_option_group->options, SPLINE_EVAL_PARAMETER_INPUT);
+  double tolerance = config_get_float(&spline_eval_option_group->options,
+    SPLINE_EVAL_PARAMETER_TOLERANCE);
 
   spline_init(&spline);
   
@@ -116,12 +230,42 @@ int main(int argc, char **argv) {
   double f_x;
   size_t i = 0, j = 0;
   
-  while (!isnan(f_x = spline_eval_linear(&spline, eval_type, x, &i))) {
-    file_printf(&output_file, "%10lg %10lg\n", x, f_x);
-    error_exit(&output_file.error);
+  if (!string_empty(input)) {
+    file_t input_file;
+    
+    file_init_name(&input_file, input);
+    if (string_equal(input, "-"))
+      file_open_stream(&input_file, stdin, file_mode_read);
+    else
+      file_open(&input_file, file_mode_read);
+    error_exit(&input_file.error);
     
-    ++j;
-    x = spline.knots[0].x+step_size*j;
+    spline_eval_input(&spline, eval_type, &input_file, &output_file);
+    
+    file_destroy(&input_file);
+  }
+  else if (tolerance > 0.0) {
+    double* locations = 0;
+    ssize_t num_locations = spline_sample_adaptive(&spline, eval_type,
+      tolerance, step_size, &locations);
+    error_exit(&spline.error);
+    
+    for (j = 0; j < num_locations; ++j) {
+      f_x = spline_eval_linear(&spline, eval_type, locations[j], &i);
+      file_printf(&output_file, "%10lg %10lg\n", locations[j], f_x);
+      error_exit(&output_file.error);
+    }
+    
+    free(locations);
+  }
+  else {
+    while (!isnan(f_x = spline_eval_linear(&spline, eval_type, x, &i))) {
+      file_printf(&output_file, "%10lg %10lg\n", x, f_x);
+      error_exit(&output_file.error);
+      
+      ++j;
+      x = spline.knots[0].x+step_size*j;
+    }
   }
 
   spline_destroy(&spline);
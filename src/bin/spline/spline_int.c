@@ -22,6 +22,7 @@
 
 #include "config/parser.h"
 #include "spline/spline.h"
+#include "spline/stream.h"
 #include "string/string.h"
 #include "file/file.h"
 
@@ -30,6 +31,7 @@
 #define SPLINE_INT_PARSER_OPTION_GROUP        "spline-int"
 #define SPLINE_INT_PARAMETER_TYPE             "type"
 #define SPLINE_INT_PARAMETER_OUTPUT           "output"
+#define SPLINE_INT_PARAMETER_OUT_OF_CORE      "out-of-core"
 #define SPLINE_INT_PARAMETER_Y1_0             "y1_0"
 #define SPLINE_INT_PARAMETER_Y1_N             "y1_n"
 #define SPLINE_INT_PARAMETER_Y2_0             "y2_0"
@@ -116,6 +118,15 @@ config_param_t spline_int_default_options_params[] = {
     "",
     "Write interpolating spline to the specified output file or '-' for "
     "stdout"},
+  {SPLINE_INT_PARAMETER_OUT_OF_CORE,
+    config_param_type_bool,
+    "false",
+    "false|true",
+    "Perform out-of-core interpolation which streams the data points from "
+    "the input file and spills intermediate results to a temporary file, "
+    "thus bounding memory consumption for arbitrarily large inputs. This "
+    "requires the interpolation type to be 'y2' or 'natural' and the "
+    "output file to be an uncompressed file other than stdout"},
 };
 
 const config_default_t spline_int_default_options = {
@@ -160,6 +171,27 @@ int main(int argc, char **argv) {
     SPLINE_INT_PARAMETER_R_N);
   const char* output = config_get_string(&spline_int_option_group->options,
     SPLINE_INT_PARAMETER_OUTPUT);
+  config_param_bool_t out_of_core = config_get_bool(
+    &spline_int_option_group->options, SPLINE_INT_PARAMETER_OUT_OF_CORE);
+  
+  if (out_of_core) {
+    ssize_t result = -SPLINE_ERROR_INTERPOLATION;
+    
+    spline_init(&spline);
+    if (type == spline_type_y2)
+      result = spline_int_file_y2(file, output, y2_0, y2_n);
+    else if (type == spline_type_natural)
+      result = spline_int_file_natural(file, output);
+    
+    if (result < 0)
+      error_set(&spline.error, -result);
+    error_exit(&spline.error);
+    
+    spline_destroy(&spline);
+    config_parser_destroy(&parser);
+    
+    return 0;
+  }
   
   file_init_name(&input_file, file);
   if (string_equal(file, "-"))
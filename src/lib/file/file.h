@@ -255,7 +255,8 @@ ssize_t file_tell(
   * \param[in,out] data An array of sufficient size to hold the read data.
   * \param[in] size The requested number of bytes to read from the file.
   * \return The number of bytes actually read from the file or the negative
-  *   error code.
+  *   error code. Fewer bytes than requested will be read at the end of the
+  *   file.
   */
 ssize_t file_read(
   file_t* file,
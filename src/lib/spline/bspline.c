@@ -0,0 +1,361 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <string.h>
+#include <math.h>
+
+#include "bspline.h"
+
+#include "spline/segment.h"
+
+#define SPLINE_BSPLINE_DEFINE_EVAL(name, p) \
+  static size_t name(const spline_bspline_t* bspline, const double* x, \
+      double* y, size_t num_values) { \
+    const double* t = bspline->knots; \
+    const double* c = bspline->control_points; \
+    size_t n = bspline->num_control_points, k = bspline->degree; \
+    size_t num_undefined = 0, i, j, r; \
+    double d[(p)+1]; \
+    \
+    for (i = 0; i < num_values; ++i) { \
+      if (!spline_bspline_update_span(t, bspline->degree, n, x[i], &k)) { \
+        y[i] = NAN; \
+        ++num_undefined; \
+        continue; \
+      } \
+      \
+      for (j = 0; j <= (p); ++j) \
+        d[j] = c[k-(p)+j]; \
+      for (r = 1; r <= (p); ++r) \
+        for (j = (p); j >= r; --j) { \
+          double t_j = t[k-(p)+j]; \
+          double alpha = (x[i]-t_j)/(t[k+1+j-r]-t_j); \
+          d[j] = d[j-1]+alpha*(d[j]-d[j-1]); \
+        } \
+      y[i] = d[p]; \
+    } \
+    \
+    return num_undefined; \
+  }
+
+const char* spline_bspline_errors[] = {
+  "Success",
+  "Invalid B-spline knot vector",
+  "Invalid B-spline degree",
+  "B-spline undefined at value",
+  "B-spline conversion failed",
+};
+
+static int spline_bspline_update_span(const double* t, size_t p, size_t n,
+    double x, size_t* k) {
+  if (!(x >= t[p]) || !(x <= t[n]))
+    return 0;
+  
+  if ((x >= t[*k]) && (x < t[*k+1]))
+    return 1;
+  else if ((*k+2 <= n) && (x >= t[*k+1]) && (x < t[*k+2])) {
+    ++*k;
+    return 1;
+  }
+  
+  if (x < t[n]) {
+    size_t k_min = p, k_max = n;
+    
+    while (k_max-k_min > 1) {
+      size_t k_mid = (k_min+k_max)/2;
+      
+      if (t[k_mid] > x)
+        k_max = k_mid;
+      else
+        k_min = k_mid;
+    }
+    *k = k_min;
+  }
+  else {
+    *k = n-1;
+    while (t[*k] == t[n])
+      --*k;
+  }
+  
+  return 1;
+}
+
+SPLINE_BSPLINE_DEFINE_EVAL(spline_bspline_eval_array_1, 1)
+SPLINE_BSPLINE_DEFINE_EVAL(spline_bspline_eval_array_2, 2)
+SPLINE_BSPLINE_DEFINE_EVAL(spline_bspline_eval_array_3, 3)
+SPLINE_BSPLINE_DEFINE_EVAL(spline_bspline_eval_array_5, 5)
+SPLINE_BSPLINE_DEFINE_EVAL(spline_bspline_eval_array_p, bspline->degree)
+
+void spline_bspline_init(spline_bspline_t* bspline) {
+  bspline->degree = 0;
+  
+  bspline->knots = 0;
+  bspline->control_points = 0;
+  bspline->num_control_points = 0;
+  
+  error_init(&bspline->error, spline_bspline_errors);
+}
+
+void spline_bspline_destroy(spline_bspline_t* bspline) {
+  spline_bspline_clear(bspline);
+  
+  error_destroy(&bspline->error);
+}
+
+void spline_bspline_clear(spline_bspline_t* bspline) {
+  if (bspline->num_control_points) {
+    free(bspline->knots);
+    free(bspline->control_points);
+    
+    bspline->knots = 0;
+    bspline->control_points = 0;
+    bspline->num_control_points = 0;
+  }
+  
+  error_clear(&bspline->error);
+}
+
+size_t spline_bspline_get_num_knots(const spline_bspline_t* bspline) {
+  return bspline->num_control_points ?
+    bspline->num_control_points+bspline->degree+1 : 0;
+}
+
+static ssize_t spline_bspline_resize(spline_bspline_t* bspline, size_t
+    degree, size_t num_control_points) {
+  spline_bspline_clear(bspline);
+  
+  if (num_control_points <= degree) {
+    error_set(&bspline->error, SPLINE_BSPLINE_ERROR_DEGREE);
+    return -bspline->error.code;
+  }
+  
+  bspline->degree = degree;
+  bspline->knots = malloc((num_control_points+degree+1)*sizeof(double));
+  bspline->control_points = malloc(num_control_points*sizeof(double));
+  bspline->num_control_points = num_control_points;
+  
+  return num_control_points;
+}
+
+ssize_t spline_bspline_set(spline_bspline_t* bspline, size_t degree, const
+    double* knots, const double* control_points, size_t num_control_points) {
+  size_t i;
+  
+  if (spline_bspline_resize(bspline, degree, num_control_points) < 0)
+    return -bspline->error.code;
+  
+  memcpy(bspline->knots, knots, (num_control_points+degree+1)*
+    sizeof(double));
+  memcpy(bspline->control_points, control_points, num_control_points*
+    sizeof(double));
+  
+  for (i = 0; i+1 < num_control_points+degree+1; ++i)
+    if (!(knots[i+1] >= knots[i]))
+      break;
+  if ((i+1 < num_control_points+degree+1) ||
+      !(knots[num_control_points] > knots[degree])) {
+    spline_bspline_clear(bspline);
+    error_set(&bspline->error, SPLINE_BSPLINE_ERROR_KNOTS);
+    
+    return -bspline->error.code;
+  }
+  
+  return bspline->num_control_points;
+}
+
+ssize_t spline_bspline_find_span(spline_bspline_t* bspline, double x) {
+  size_t k = bspline->degree;
+  
+  error_clear(&bspline->error);
+  
+  if (!bspline->num_control_points || !spline_bspline_update_span(
+      bspline->knots, bspline->degree, bspline->num_control_points, x, &k)) {
+    error_setf(&bspline->error, SPLINE_BSPLINE_ERROR_UNDEFINED, "%lg", x);
+    return -bspline->error.code;
+  }
+  
+  return k;
+}
+
+double spline_bspline_eval(spline_bspline_t* bspline, double x) {
+  double y;
+  
+  spline_bspline_eval_array(bspline, &x, &y, 1);
+  
+  return y;
+}
+
+ssize_t spline_bspline_eval_array(spline_bspline_t* bspline, const double* x,
+    double* y, size_t num_values) {
+  size_t num_undefined;
+  
+  error_clear(&bspline->error);
+  
+  if (!bspline->num_control_points) {
+    size_t i;
+    for (i = 0; i < num_values; ++i)
+      y[i] = NAN;
+    num_undefined = num_values;
+  }
+  else switch (bspline->degree) {
+    case 1:
+      num_undefined = spline_bspline_eval_array_1(bspline, x, y, num_values);
+      break;
+    case 2:
+      num_undefined = spline_bspline_eval_array_2(bspline, x, y, num_values);
+      break;
+    case 3:
+      num_undefined = spline_bspline_eval_array_3(bspline, x, y, num_values);
+      break;
+    case 5:
+      num_undefined = spline_bspline_eval_array_5(bspline, x, y, num_values);
+      break;
+    default:
+      num_undefined = spline_bspline_eval_array_p(bspline, x, y, num_values);
+  }
+  
+  if (num_undefined)
+    error_set(&bspline->error, SPLINE_BSPLINE_ERROR_UNDEFINED);
+  
+  return bspline->error.code ? -bspline->error.code : num_values;
+}
+
+ssize_t spline_bspline_derive(const spline_bspline_t* bspline,
+    spline_bspline_t* derivative) {
+  size_t p = bspline->degree, n = bspline->num_control_points, i;
+  
+  if (!p || !n) {
+    spline_bspline_clear(derivative);
+    error_set(&derivative->error, SPLINE_BSPLINE_ERROR_DEGREE);
+    
+    return -derivative->error.code;
+  }
+  
+  spline_bspline_resize(derivative, p-1, n-1);
+  
+  memcpy(derivative->knots, &bspline->knots[1], (n+p-1)*sizeof(double));
+  for (i = 0; i+1 < n; ++i) {
+    double h = bspline->knots[i+p+1]-bspline->knots[i+1];
+    
+    derivative->control_points[i] = (h > 0.0) ?
+      p*(bspline->control_points[i+1]-bspline->control_points[i])/h : 0.0;
+  }
+  
+  return derivative->num_control_points;
+}
+
+ssize_t spline_bspline_from_spline(spline_bspline_t* bspline, spline_t*
+    spline) {
+  size_t multiplicity = (spline->knot_type == spline_knot_type_y1) ? 2 : 1;
+  size_t num_knots = spline->num_knots, i, j;
+  spline_segment_t segment;
+  
+  if (num_knots < 2) {
+    spline_bspline_clear(bspline);
+    error_set(&bspline->error, SPLINE_BSPLINE_ERROR_CONVERSION);
+    
+    return -bspline->error.code;
+  }
+  
+  spline_bspline_resize(bspline, 3, 4+(num_knots-2)*multiplicity);
+  double* t = bspline->knots;
+  
+  for (i = 0; i < 4; ++i) {
+    t[i] = spline->knots[0].x;
+    t[bspline->num_control_points+i] = spline->knots[num_knots-1].x;
+  }
+  for (i = 1; i+1 < num_knots; ++i)
+    for (j = 0; j < multiplicity; ++j)
+      t[4+(i-1)*multiplicity+j] = spline->knots[i].x;
+  
+  for (i = 0; i+1 < num_knots; ++i) {
+    size_t k = 3+i*multiplicity;
+    
+    spline_get_segment(spline, i, &segment);
+    for (j = k-3; j <= k; ++j) {
+      double u_1 = t[j+1]-segment.x_0;
+      double u_2 = t[j+2]-segment.x_0;
+      double u_3 = t[j+3]-segment.x_0;
+      
+      bspline->control_points[j] = segment.d+
+        segment.c*(u_1+u_2+u_3)/3.0+
+        segment.b*(u_1*u_2+u_1*u_3+u_2*u_3)/3.0+
+        segment.a*u_1*u_2*u_3;
+    }
+  }
+  
+  return bspline->num_control_points;
+}
+
+ssize_t spline_bspline_to_spline(spline_bspline_t* bspline, spline_t*
+    spline) {
+  size_t p = bspline->degree, n = bspline->num_control_points;
+  size_t max_multiplicity = 0, multiplicity = 0, num_knots = 1, i;
+  const double* t = bspline->knots;
+  
+  error_clear(&bspline->error);
+  
+  for (i = p+1; i <= n; ++i) {
+    multiplicity = (t[i] == t[i-1]) ? multiplicity+1 : 1;
+    if (t[i] > t[i-1])
+      ++num_knots;
+    if ((t[i] > t[p]) && (t[i] < t[n]) && (multiplicity > max_multiplicity))
+      max_multiplicity = multiplicity;
+  }
+  
+  if (!n || ((p != 1) && (p != 3)) ||
+      (max_multiplicity > ((p == 3) ? 2 : 1))) {
+    error_set(&bspline->error, SPLINE_BSPLINE_ERROR_CONVERSION);
+    return -bspline->error.code;
+  }
+  
+  spline_bspline_t derivatives[2];
+  spline_bspline_t* derivative = &derivatives[0];
+  spline_bspline_init(&derivatives[0]);
+  spline_bspline_init(&derivatives[1]);
+  
+  spline->knots = realloc(spline->knots, num_knots*sizeof(spline_knot_t));
+  spline->num_knots = 0;
+  spline->knot_type = (max_multiplicity > 1) ? spline_knot_type_y1 :
+    spline_knot_type_y2;
+  
+  if (p == 3) {
+    spline_bspline_derive(bspline, &derivatives[0]);
+    if (spline->knot_type == spline_knot_type_y2) {
+      spline_bspline_derive(&derivatives[0], &derivatives[1]);
+      derivative = &derivatives[1];
+    }
+  }
+  
+  for (i = p; i <= n; ++i) {
+    if ((i > p) && (t[i] == t[i-1]))
+      continue;
+    
+    spline_knot_init(&spline->knots[spline->num_knots], t[i],
+      spline_bspline_eval(bspline, t[i]), (p == 3) ?
+      spline_bspline_eval(derivative, t[i]) : 0.0);
+    ++spline->num_knots;
+  }
+  
+  spline_bspline_destroy(&derivatives[0]);
+  spline_bspline_destroy(&derivatives[1]);
+  
+  return spline->num_knots;
+}
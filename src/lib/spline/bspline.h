@@ -0,0 +1,212 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_BSPLINE_H
+#define SPLINE_BSPLINE_H
+
+/** \file spline/bspline.h
+  * \ingroup spline
+  * \brief B-spline definition of arbitrary degree
+  * \author Ralf Kaestner
+  * 
+  * A B-spline of degree p is defined by a non-decreasing knot vector
+  * t = (t_0, ..., t_M) and N = M-p control points c = (c_0, ..., c_N-1),
+  * representing the function f(x) = sum_i c_i*B_i,p(x) over the range
+  * [t_p, t_N]. At a knot of multiplicity m, the B-spline is p-m times
+  * continuously differentiable. Evaluation employs the de Boor algorithm,
+  * which is specialized at compile time for the common degrees 1, 2, 3,
+  * and 5.
+  */
+
+#include <stdlib.h>
+
+#include "spline/spline.h"
+
+#include "error/error.h"
+
+/** \name Error Codes
+  * \brief Predefined B-spline error codes
+  */
+//@{
+#define SPLINE_BSPLINE_ERROR_NONE          0
+//!< Success
+#define SPLINE_BSPLINE_ERROR_KNOTS         1
+//!< Invalid B-spline knot vector
+#define SPLINE_BSPLINE_ERROR_DEGREE        2
+//!< Invalid B-spline degree
+#define SPLINE_BSPLINE_ERROR_UNDEFINED     3
+//!< B-spline undefined at value
+#define SPLINE_BSPLINE_ERROR_CONVERSION    4
+//!< B-spline conversion failed
+//@}
+
+/** \brief Predefined B-spline error descriptions
+  */
+extern const char* spline_bspline_errors[];
+
+/** \brief Structure defining the B-spline
+  */
+typedef struct spline_bspline_t {
+  size_t degree;              //!< The degree of the B-spline.
+  
+  double* knots;              //!< The knot vector of the B-spline.
+  double* control_points;     //!< The control points of the B-spline.
+  size_t num_control_points;  //!< The number of control points.
+  
+  error_t error;              //!< The most recent B-spline error.
+} spline_bspline_t;
+
+/** \brief Initialize an empty B-spline
+  * \param[in] bspline The B-spline to be initialized.
+  */
+void spline_bspline_init(
+  spline_bspline_t* bspline);
+
+/** \brief Destroy a B-spline
+  * \param[in] bspline The B-spline to be destroyed.
+  */
+void spline_bspline_destroy(
+  spline_bspline_t* bspline);
+
+/** \brief Clear a B-spline
+  * \param[in] bspline The B-spline to be cleared.
+  */
+void spline_bspline_clear(
+  spline_bspline_t* bspline);
+
+/** \brief Retrieve the number of knots of a B-spline
+  * \param[in] bspline The B-spline to retrieve the number of knots for.
+  * \return The length of the B-spline's knot vector, i.e., the number of
+  *   control points plus the degree plus one, or zero for an empty
+  *   B-spline.
+  */
+size_t spline_bspline_get_num_knots(
+  const spline_bspline_t* bspline);
+
+/** \brief Define a B-spline from its degree, knots, and control points
+  * \param[in,out] bspline The B-spline to be defined.
+  * \param[in] degree The degree of the B-spline.
+  * \param[in] knots The non-decreasing knot vector of the B-spline,
+  *   an array holding the number of control points plus the degree plus
+  *   one values.
+  * \param[in] control_points The control points of the B-spline.
+  * \param[in] num_control_points The number of control points, which must
+  *   exceed the degree.
+  * \return The number of control points of the B-spline or the negative
+  *   error code.
+  */
+ssize_t spline_bspline_set(
+  spline_bspline_t* bspline,
+  size_t degree,
+  const double* knots,
+  const double* control_points,
+  size_t num_control_points);
+
+/** \brief Find the knot span of the B-spline at a given location
+  * \param[in] bspline The B-spline to find the knot span for.
+  * \param[in] x The location at which to find the knot span.
+  * \return The index k of the knot span [t_k, t_k+1) containing the
+  *   location or the negative error code.
+  * 
+  * The upper bound t_N of the B-spline's range is considered part of the
+  * last non-empty knot span.
+  */
+ssize_t spline_bspline_find_span(
+  spline_bspline_t* bspline,
+  double x);
+
+/** \brief Evaluate the B-spline at a given location
+  * \param[in] bspline The B-spline to be evaluated.
+  * \param[in] x The location at which to evaluate the B-spline.
+  * \return The function value of the B-spline at the given location or
+  *   NaN if the B-spline is undefined at that location.
+  */
+double spline_bspline_eval(
+  spline_bspline_t* bspline,
+  double x);
+
+/** \brief Evaluate the B-spline at an array of locations
+  * \param[in] bspline The B-spline to be evaluated.
+  * \param[in] x The locations at which to evaluate the B-spline.
+  * \param[out] y The function values of the B-spline at the given
+  *   locations. Values at locations outside the B-spline's range will
+  *   be set to NaN.
+  * \param[in] num_values The number of locations to be evaluated.
+  * \return The number of evaluated locations or the negative error code.
+  * 
+  * Batched evaluation amortizes the dispatch to the de Boor algorithm
+  * specialized for the degree of the B-spline over all locations. The
+  * knot span of each location is searched starting from the span of the
+  * previous location, such that sorted locations are evaluated without
+  * bisection.
+  */
+ssize_t spline_bspline_eval_array(
+  spline_bspline_t* bspline,
+  const double* x,
+  double* y,
+  size_t num_values);
+
+/** \brief Compute the derivative of a B-spline
+  * \param[in] bspline The B-spline to be differentiated. Its degree must
+  *   be positive.
+  * \param[in,out] derivative The B-spline of one degree less representing
+  *   the derivative.
+  * \return The number of control points of the derivative or the negative
+  *   error code.
+  */
+ssize_t spline_bspline_derive(
+  const spline_bspline_t* bspline,
+  spline_bspline_t* derivative);
+
+/** \brief Convert a cubic spline into a B-spline
+  * \param[in,out] bspline The resulting cubic B-spline.
+  * \param[in] spline The cubic spline to be converted.
+  * \return The number of control points of the B-spline or the negative
+  *   error code.
+  * 
+  * The conversion is exact. The B-spline's knot vector is clamped at the
+  * outer spline knots. Interior knots are simple for spline knots of type
+  * spline_knot_type_y2 and double for spline knots of type
+  * spline_knot_type_y1, reflecting the continuity of the cubic spline.
+  * The control points result from evaluating the polar forms of the
+  * spline segments at consecutive knots.
+  */
+ssize_t spline_bspline_from_spline(
+  spline_bspline_t* bspline,
+  spline_t* spline);
+
+/** \brief Convert a B-spline into a cubic spline
+  * \param[in] bspline The B-spline to be converted.
+  * \param[in,out] spline The resulting cubic spline.
+  * \return The number of knots of the cubic spline or the negative error
+  *   code.
+  * 
+  * A B-spline can be represented exactly if it is linear, or if it is
+  * cubic with interior knots of multiplicity at most two. The resulting
+  * spline knots are placed at the distinct knots within the B-spline's
+  * range. Their type is spline_knot_type_y2 for linear B-splines and
+  * cubic B-splines with simple interior knots, and spline_knot_type_y1
+  * otherwise.
+  */
+ssize_t spline_bspline_to_spline(
+  spline_bspline_t* bspline,
+  spline_t* spline);
+
+#endif
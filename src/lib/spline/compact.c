@@ -0,0 +1,441 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <math.h>
+
+#include "compact.h"
+
+#include "spline/segment.h"
+
+#include "string/string.h"
+
+#include "file/file.h"
+
+#define sqr(a) ((a)*(a))
+
+const char* spline_compact_errors[] = {
+  "Success",
+  "Invalid spline",
+  "Compact spline tolerance not attainable",
+  "Compact spline undefined at value",
+  "Failed to read compact spline from file",
+  "Invalid compact spline file format",
+  "Failed to write compact spline to file",
+};
+
+void spline_compact_init(spline_compact_t* compact) {
+  compact->knot_type = spline_knot_type_y2;
+  
+  compact->x_min = 0.0;
+  compact->x_step = 0.0;
+  
+  compact->blocks = 0;
+  compact->x = 0;
+  compact->y = 0;
+  compact->y2 = 0;
+  compact->num_knots = 0;
+  
+  compact->error_bound = 0.0;
+  
+  error_init(&compact->error, spline_compact_errors);
+}
+
+void spline_compact_destroy(spline_compact_t* compact) {
+  spline_compact_clear(compact);
+  
+  error_destroy(&compact->error);
+}
+
+void spline_compact_clear(spline_compact_t* compact) {
+  if (compact->num_knots) {
+    free(compact->blocks);
+    if (compact->x)
+      free(compact->x);
+    free(compact->y);
+    free(compact->y2);
+    
+    compact->blocks = 0;
+    compact->x = 0;
+    compact->y = 0;
+    compact->y2 = 0;
+    compact->num_knots = 0;
+  }
+  
+  compact->x_min = 0.0;
+  compact->x_step = 0.0;
+  compact->error_bound = 0.0;
+  
+  error_clear(&compact->error);
+}
+
+static size_t spline_compact_get_num_blocks(const spline_compact_t* compact) {
+  return (compact->num_knots+SPLINE_COMPACT_BLOCK_SIZE-1)/
+    SPLINE_COMPACT_BLOCK_SIZE;
+}
+
+size_t spline_compact_get_size(const spline_compact_t* compact) {
+  return spline_compact_get_num_blocks(compact)*
+    sizeof(spline_compact_block_t)+compact->num_knots*(2*sizeof(uint16_t)+
+    (compact->x ? sizeof(uint32_t) : 0));
+}
+
+static double spline_compact_quantize(double value, double offset, double
+    scale, double max_value) {
+  return (scale > 0.0) ? fmin(round((value-offset)/scale), max_value) : 0.0;
+}
+
+ssize_t spline_compact_encode(spline_compact_t* compact, spline_t* spline,
+    double tolerance) {
+  size_t num_knots = spline->num_knots, i, j, k;
+  
+  spline_compact_clear(compact);
+  
+  if (num_knots < 2) {
+    error_set(&compact->error, SPLINE_COMPACT_ERROR_SPLINE);
+    return -compact->error.code;
+  }
+  
+  const spline_knot_t* knots = spline->knots;
+  double x_step = (knots[num_knots-1].x-knots[0].x)/(num_knots-1);
+  
+  compact->knot_type = spline->knot_type;
+  compact->x_min = knots[0].x;
+  compact->x_step = x_step;
+  for (i = 0; i < num_knots; ++i)
+    if (fabs(knots[i].x-(knots[0].x+i*x_step)) >
+        SPLINE_COMPACT_GRID_TOLERANCE*x_step) {
+      compact->x_step = 0.0;
+      break;
+    }
+  
+  compact->num_knots = num_knots;
+  size_t num_blocks = spline_compact_get_num_blocks(compact);
+  
+  compact->blocks = malloc(num_blocks*sizeof(spline_compact_block_t));
+  compact->x = (compact->x_step > 0.0) ? 0 :
+    malloc(num_knots*sizeof(uint32_t));
+  compact->y = malloc(num_knots*sizeof(uint16_t));
+  compact->y2 = malloc(num_knots*sizeof(uint16_t));
+  
+  for (k = 0; k < num_blocks; ++k) {
+    spline_compact_block_t* block = &compact->blocks[k];
+    size_t i_min = k*SPLINE_COMPACT_BLOCK_SIZE;
+    size_t i_max = (i_min+SPLINE_COMPACT_BLOCK_SIZE < num_knots) ?
+      i_min+SPLINE_COMPACT_BLOCK_SIZE : num_knots;
+    double y_max = knots[i_min].y, y2_max = knots[i_min].y2;
+    
+    block->y_0 = knots[i_min].y;
+    block->y2_0 = knots[i_min].y2;
+    for (i = i_min+1; i < i_max; ++i) {
+      block->y_0 = fmin(block->y_0, knots[i].y);
+      y_max = fmax(y_max, knots[i].y);
+      block->y2_0 = fmin(block->y2_0, knots[i].y2);
+      y2_max = fmax(y2_max, knots[i].y2);
+    }
+    
+    block->x_0 = knots[i_min].x;
+    block->x_scale = compact->x ? (knots[i_max-1].x-block->x_0)/UINT32_MAX :
+      0.0;
+    block->y_scale = (y_max-block->y_0)/UINT16_MAX;
+    block->y2_scale = (y2_max-block->y2_0)/UINT16_MAX;
+    
+    for (i = i_min; i < i_max; ++i) {
+      if (compact->x)
+        compact->x[i] = spline_compact_quantize(knots[i].x, block->x_0,
+          block->x_scale, UINT32_MAX);
+      compact->y[i] = spline_compact_quantize(knots[i].y, block->y_0,
+        block->y_scale, UINT16_MAX);
+      compact->y2[i] = spline_compact_quantize(knots[i].y2, block->y2_0,
+        block->y2_scale, UINT16_MAX);
+    }
+  }
+  
+  spline_knot_t knot_min, knot_max;
+  spline_segment_t segment;
+  
+  spline_compact_get_knot(compact, 0, &knot_max);
+  for (i = 0; i+1 < num_knots; ++i) {
+    knot_min = knot_max;
+    spline_compact_get_knot(compact, i+1, &knot_max);
+    
+    double h = knot_max.x-knot_min.x;
+    if (!(h > 0.0)) {
+      error_set(&compact->error, SPLINE_COMPACT_ERROR_TOLERANCE);
+      break;
+    }
+    
+    double e_x = 0.0, e_y = 0.0, e_y2 = 0.0;
+    for (j = i; j < i+2; ++j) {
+      const spline_knot_t* knot = (j > i) ? &knot_max : &knot_min;
+      
+      e_x = fmax(e_x, fabs(knot->x-knots[j].x));
+      e_y = fmax(e_y, fabs(knot->y-knots[j].y));
+      e_y2 = fmax(e_y2, fabs(knot->y2-knots[j].y2));
+    }
+    
+    double error_bound = e_y+((compact->knot_type == spline_knot_type_y1) ?
+      0.25*h*e_y2 : 0.125*sqr(h)*e_y2);
+    
+    if (e_x > 0.0) {
+      double h_0 = knots[i+1].x-knots[i].x, u;
+      
+      spline_get_segment(spline, i, &segment);
+      double y1_max = fmax(fabs(segment.c), fabs(segment.c+
+        2.0*segment.b*h_0+3.0*segment.a*sqr(h_0)));
+      if ((segment.a != 0.0) && ((u = -segment.b/(3.0*segment.a)) > 0.0) &&
+          (u < h_0))
+        y1_max = fmax(y1_max, fabs(segment.c+segment.b*u));
+      
+      error_bound += 2.0*e_x*y1_max;
+    }
+    
+    compact->error_bound = fmax(compact->error_bound, error_bound);
+  }
+  
+  if (!compact->error.code && (tolerance > 0.0) &&
+      (compact->error_bound > tolerance))
+    error_set(&compact->error, SPLINE_COMPACT_ERROR_TOLERANCE);
+  
+  if (compact->error.code) {
+    int code = compact->error.code;
+    
+    spline_compact_clear(compact);
+    error_set(&compact->error, code);
+    
+    return -code;
+  }
+  else
+    return compact->num_knots;
+}
+
+ssize_t spline_compact_decode(const spline_compact_t* compact, spline_t*
+    spline) {
+  size_t i;
+  
+  error_clear(&spline->error);
+  
+  spline->knots = realloc(spline->knots, compact->num_knots*
+    sizeof(spline_knot_t));
+  spline->num_knots = compact->num_knots;
+  spline->knot_type = compact->knot_type;
+  
+  for (i = 0; i < compact->num_knots; ++i)
+    spline_compact_get_knot(compact, i, &spline->knots[i]);
+  
+  return spline->num_knots;
+}
+
+void spline_compact_get_knot(const spline_compact_t* compact, size_t index,
+    spline_knot_t* knot) {
+  const spline_compact_block_t* block =
+    &compact->blocks[index/SPLINE_COMPACT_BLOCK_SIZE];
+  
+  knot->x = compact->x ? block->x_0+compact->x[index]*block->x_scale :
+    compact->x_min+index*compact->x_step;
+  knot->y = block->y_0+compact->y[index]*block->y_scale;
+  knot->y2 = block->y2_0+compact->y2[index]*block->y2_scale;
+}
+
+ssize_t spline_compact_find_segment(spline_compact_t* compact, double x) {
+  spline_knot_t knot;
+  ssize_t index;
+  
+  error_clear(&compact->error);
+  
+  if (compact->num_knots < 2) {
+    error_set(&compact->error, SPLINE_COMPACT_ERROR_UNDEFINED);
+    return -compact->error.code;
+  }
+  
+  spline_compact_get_knot(compact, compact->num_knots-1, &knot);
+  if ((x < compact->x_min) || (x > knot.x)) {
+    error_setf(&compact->error, SPLINE_COMPACT_ERROR_UNDEFINED, "%lg", x);
+    return -compact->error.code;
+  }
+  
+  if (compact->x)  {
+    size_t block_min = 0, block_max = spline_compact_get_num_blocks(compact);
+    
+    while (block_max-block_min > 1) {
+      size_t block_mid = (block_min+block_max)/2;
+      
+      if (compact->blocks[block_mid].x_0 > x)
+        block_max = block_mid;
+      else
+        block_min = block_mid;
+    }
+    
+    const spline_compact_block_t* block = &compact->blocks[block_min];
+    size_t index_min = block_min*SPLINE_COMPACT_BLOCK_SIZE;
+    size_t index_max = (index_min+SPLINE_COMPACT_BLOCK_SIZE <
+      compact->num_knots) ? index_min+SPLINE_COMPACT_BLOCK_SIZE :
+      compact->num_knots;
+    
+    while (index_max-index_min > 1) {
+      size_t index_mid = (index_min+index_max)/2;
+      
+      if (block->x_0+compact->x[index_mid]*block->x_scale > x)
+        index_max = index_mid;
+      else
+        index_min = index_mid;
+    }
+    index = index_min;
+  }
+  else
+    index = (x-compact->x_min)/compact->x_step;
+  
+  return (index+1 < compact->num_knots) ? index : compact->num_knots-2;
+}
+
+double spline_compact_eval(spline_compact_t* compact, spline_eval_type_t
+    eval_type, double x) {
+  spline_knot_t knot_min, knot_max;
+  ssize_t index;
+  
+  if ((index = spline_compact_find_segment(compact, x)) < 0)
+    return NAN;
+  
+  spline_compact_get_knot(compact, index, &knot_min);
+  spline_compact_get_knot(compact, index+1, &knot_max);
+  
+  if (compact->knot_type == spline_knot_type_y1)
+    return spline_knot_eval_hermite(&knot_min, &knot_max, eval_type, x);
+  else
+    return spline_knot_eval(&knot_min, &knot_max, eval_type, x);
+}
+
+static int spline_compact_read_data(file_t* file, void* data, size_t size) {
+  return !size || (file_read(file, data, size) == size);
+}
+
+static int spline_compact_write_data(file_t* file, const void* data, size_t
+    size) {
+  return !size || (file_write(file, data, size) == size);
+}
+
+ssize_t spline_compact_read(const char* filename, spline_compact_t*
+    compact) {
+  uint32_t knot_type;
+  uint64_t num_knots;
+  file_t file;
+  
+  spline_compact_clear(compact);
+  
+  file_init_name(&file, filename);
+  if (string_equal(filename, "-"))
+    file_open_stream(&file, stdin, file_mode_read);
+  else
+    file_open(&file, file_mode_read);
+  
+  if (!file.handle) {
+    error_blame(&compact->error, &file.error, SPLINE_COMPACT_ERROR_FILE_READ);
+    file_destroy(&file);
+    
+    return -error_get(&compact->error);
+  }
+  
+  if (spline_compact_read_data(&file, &knot_type, sizeof(knot_type)) &&
+      spline_compact_read_data(&file, &num_knots, sizeof(num_knots)) &&
+      spline_compact_read_data(&file, &compact->x_min, sizeof(double)) &&
+      spline_compact_read_data(&file, &compact->x_step, sizeof(double)) &&
+      spline_compact_read_data(&file, &compact->error_bound,
+        sizeof(double))) {
+    if ((knot_type > spline_knot_type_y1) || (num_knots < 2))
+      error_setf(&compact->error, SPLINE_COMPACT_ERROR_FILE_FORMAT, "%s",
+        filename);
+    else {
+      compact->knot_type = knot_type;
+      compact->num_knots = num_knots;
+      size_t num_blocks = spline_compact_get_num_blocks(compact);
+      
+      compact->blocks = malloc(num_blocks*sizeof(spline_compact_block_t));
+      compact->x = (compact->x_step > 0.0) ? 0 :
+        malloc(num_knots*sizeof(uint32_t));
+      compact->y = malloc(num_knots*sizeof(uint16_t));
+      compact->y2 = malloc(num_knots*sizeof(uint16_t));
+      
+      if (!spline_compact_read_data(&file, compact->blocks,
+            num_blocks*sizeof(spline_compact_block_t)) ||
+          (compact->x && !spline_compact_read_data(&file, compact->x,
+            num_knots*sizeof(uint32_t))) ||
+          !spline_compact_read_data(&file, compact->y,
+            num_knots*sizeof(uint16_t)) ||
+          !spline_compact_read_data(&file, compact->y2,
+            num_knots*sizeof(uint16_t)))
+        error_setf(&compact->error, SPLINE_COMPACT_ERROR_FILE_FORMAT, "%s",
+          filename);
+    }
+  }
+  else
+    error_setf(&compact->error, SPLINE_COMPACT_ERROR_FILE_FORMAT, "%s",
+      filename);
+  
+  if (file.error.code)
+    error_blame(&compact->error, &file.error, SPLINE_COMPACT_ERROR_FILE_READ);
+  file_destroy(&file);
+  
+  if (compact->error.code) {
+    int code = compact->error.code;
+    
+    spline_compact_clear(compact);
+    error_set(&compact->error, code);
+    
+    return -code;
+  }
+  else
+    return compact->num_knots;
+}
+
+ssize_t spline_compact_write(const char* filename, spline_compact_t*
+    compact) {
+  uint32_t knot_type = compact->knot_type;
+  uint64_t num_knots = compact->num_knots;
+  size_t num_blocks = spline_compact_get_num_blocks(compact);
+  file_t file;
+  
+  error_clear(&compact->error);
+  
+  file_init_name(&file, filename);
+  if (string_equal(filename, "-"))
+    file_open_stream(&file, stdout, file_mode_write);
+  else
+    file_open(&file, file_mode_write);
+  
+  if (!file.handle ||
+      !spline_compact_write_data(&file, &knot_type, sizeof(knot_type)) ||
+      !spline_compact_write_data(&file, &num_knots, sizeof(num_knots)) ||
+      !spline_compact_write_data(&file, &compact->x_min, sizeof(double)) ||
+      !spline_compact_write_data(&file, &compact->x_step, sizeof(double)) ||
+      !spline_compact_write_data(&file, &compact->error_bound,
+        sizeof(double)) ||
+      !spline_compact_write_data(&file, compact->blocks,
+        num_blocks*sizeof(spline_compact_block_t)) ||
+      (compact->x && !spline_compact_write_data(&file, compact->x,
+        num_knots*sizeof(uint32_t))) ||
+      !spline_compact_write_data(&file, compact->y,
+        num_knots*sizeof(uint16_t)) ||
+      !spline_compact_write_data(&file, compact->y2,
+        num_knots*sizeof(uint16_t)))
+    error_blame(&compact->error, &file.error,
+      SPLINE_COMPACT_ERROR_FILE_WRITE);
+  file_destroy(&file);
+  
+  return compact->error.code ? -compact->error.code : compact->num_knots;
+}
@@ -0,0 +1,238 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_COMPACT_H
+#define SPLINE_COMPACT_H
+
+/** \file spline/compact.h
+  * \ingroup spline
+  * \brief Quantized compact storage of cubic splines
+  * \author Ralf Kaestner
+  * 
+  * A compact spline stores the knots of a cubic spline in quantized form.
+  * The knots are grouped into blocks of SPLINE_COMPACT_BLOCK_SIZE knots,
+  * each of which provides offsets and scale factors for 16-bit quantized
+  * values and derivatives. Knot locations on a regular grid are reproduced
+  * from the grid spacing, otherwise they are stored as 32-bit quantized
+  * offsets with respect to the first knot of their block. This reduces the
+  * storage from 24 bytes to 4 or 8 bytes per knot, respectively. Knots
+  * are decoded on demand, such that a compact spline may be evaluated
+  * without decompressing the entire spline.
+  */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "spline/spline.h"
+
+#include "error/error.h"
+
+/** \name Constants
+  * \brief Predefined compact spline constants
+  */
+//@{
+#define SPLINE_COMPACT_BLOCK_SIZE          64
+//!< The number of knots per block of a compact spline
+#define SPLINE_COMPACT_GRID_TOLERANCE      1e-9
+//!< The tolerated deviation of grid knot locations relative to the spacing
+//@}
+
+/** \name Error Codes
+  * \brief Predefined compact spline error codes
+  */
+//@{
+#define SPLINE_COMPACT_ERROR_NONE          0
+//!< Success
+#define SPLINE_COMPACT_ERROR_SPLINE        1
+//!< Invalid spline
+#define SPLINE_COMPACT_ERROR_TOLERANCE     2
+//!< Tolerance not attainable
+#define SPLINE_COMPACT_ERROR_UNDEFINED     3
+//!< Compact spline undefined at value
+#define SPLINE_COMPACT_ERROR_FILE_READ     4
+//!< Error reading compact spline from file
+#define SPLINE_COMPACT_ERROR_FILE_FORMAT   5
+//!< Invalid compact spline file format
+#define SPLINE_COMPACT_ERROR_FILE_WRITE    6
+//!< Error writing compact spline to file
+//@}
+
+/** \brief Predefined compact spline error descriptions
+  */
+extern const char* spline_compact_errors[];
+
+/** \brief Structure defining a block of compact spline knots
+  * 
+  * The decoded value of a quantized component q is given by the offset
+  * plus q times the scale factor of the block.
+  */
+typedef struct spline_compact_block_t {
+  double x_0;                 //!< The location offset of the block.
+  double x_scale;             //!< The location scale factor of the block.
+  double y_0;                 //!< The value offset of the block.
+  double y_scale;             //!< The value scale factor of the block.
+  double y2_0;                //!< The derivative offset of the block.
+  double y2_scale;            //!< The derivative scale factor of the block.
+} spline_compact_block_t;
+
+/** \brief Structure defining the compact spline
+  */
+typedef struct spline_compact_t {
+  spline_knot_type_t knot_type; //!< The type of the encoded spline knots.
+  
+  double x_min;               //!< The location of the first knot.
+  double x_step;              //!< The grid spacing or zero if off-grid.
+  
+  spline_compact_block_t* blocks; //!< The blocks of the compact spline.
+  uint32_t* x;                //!< The quantized knot locations if off-grid.
+  uint16_t* y;                //!< The quantized knot values.
+  uint16_t* y2;               //!< The quantized knot derivatives.
+  size_t num_knots;           //!< The number of knots.
+  
+  double error_bound;         //!< The maximum deviation from the spline.
+  
+  error_t error;              //!< The most recent compact spline error.
+} spline_compact_t;
+
+/** \brief Initialize an empty compact spline
+  * \param[in] compact The compact spline to be initialized.
+  */
+void spline_compact_init(
+  spline_compact_t* compact);
+
+/** \brief Destroy a compact spline
+  * \param[in] compact The compact spline to be destroyed.
+  */
+void spline_compact_destroy(
+  spline_compact_t* compact);
+
+/** \brief Clear a compact spline
+  * \param[in] compact The compact spline to be cleared.
+  */
+void spline_compact_clear(
+  spline_compact_t* compact);
+
+/** \brief Retrieve the storage size of a compact spline
+  * \param[in] compact The compact spline to retrieve the storage size for.
+  * \return The number of bytes occupied by the encoded knots of the
+  *   compact spline.
+  */
+size_t spline_compact_get_size(
+  const spline_compact_t* compact);
+
+/** \brief Encode a cubic spline into a compact spline
+  * \param[in,out] compact The compact spline to be encoded.
+  * \param[in] spline The cubic spline to be encoded. The spline must have
+  *   at least two knots.
+  * \param[in] tolerance If positive, the maximum tolerated deviation of the
+  *   compact spline from the base function of the cubic spline.
+  * \return The number of encoded knots or the negative error code.
+  * 
+  * The error bound of the compact spline accounts for the quantization
+  * errors of the values and derivatives at the knots of each segment.
+  * For knots carrying second derivatives, a segment of length h deviates
+  * by at most e_y+h^2/8*e_y2, where e_y and e_y2 denote the quantization
+  * errors of the values and second derivatives. For knots carrying first
+  * derivatives, the deviation is bounded by e_y+h/4*e_y1. The deviation
+  * resulting from quantized knot locations is accounted for to first
+  * order, involving the maximum first derivative of the spline.
+  */
+ssize_t spline_compact_encode(
+  spline_compact_t* compact,
+  spline_t* spline,
+  double tolerance);
+
+/** \brief Decode a compact spline into a cubic spline
+  * \param[in] compact The compact spline to be decoded.
+  * \param[in,out] spline The decoded cubic spline. Its knots will be
+  *   re-allocated to accommodate the decoded knots.
+  * \return The number of decoded knots or the negative error code.
+  */
+ssize_t spline_compact_decode(
+  const spline_compact_t* compact,
+  spline_t* spline);
+
+/** \brief Decode a single knot of the compact spline
+  * \param[in] compact The compact spline to decode the knot from.
+  * \param[in] index The index of the knot to be decoded. This index will
+  *   not be checked nor enforced by the function.
+  * \param[out] knot The decoded spline knot.
+  */
+void spline_compact_get_knot(
+  const spline_compact_t* compact,
+  size_t index,
+  spline_knot_t* knot);
+
+/** \brief Find the segment of the compact spline at a given location
+  * \param[in] compact The compact spline to find the segment for.
+  * \param[in] x The location at which to find the segment.
+  * \return The index of the segment at the given location or the negative
+  *   error code.
+  * 
+  * On a regular grid, the segment is found in constant time. Otherwise,
+  * this function bisects the block offsets before bisecting the quantized
+  * locations within the block.
+  */
+ssize_t spline_compact_find_segment(
+  spline_compact_t* compact,
+  double x);
+
+/** \brief Evaluate the compact spline at a given location
+  * \param[in] compact The compact spline to be evaluated.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The location at which to evaluate the compact spline.
+  * \return The function value of the compact spline at the given location
+  *   or NaN if the compact spline is undefined at that location.
+  * 
+  * Only the two knots bounding the segment at the given location will be
+  * decoded.
+  */
+double spline_compact_eval(
+  spline_compact_t* compact,
+  spline_eval_type_t eval_type,
+  double x);
+
+/** \brief Read compact spline from file
+  * \param[in] filename The name of the file containing the compact spline.
+  *   The special filename '-' indicates that the compact spline shall be
+  *   read from stdin.
+  * \param[in,out] compact The read compact spline.
+  * \return The number of knots read from the file or the negative error
+  *   code.
+  * 
+  * Compact splines are stored in a binary format of native byte order.
+  */
+ssize_t spline_compact_read(
+  const char* filename,
+  spline_compact_t* compact);
+
+/** \brief Write compact spline to file
+  * \param[in] filename The name of the file the compact spline will be
+  *   written to. The special filename '-' indicates that the compact
+  *   spline shall be written to stdout.
+  * \param[in] compact The compact spline to be written.
+  * \return The number of knots written to the file or the negative error
+  *   code.
+  */
+ssize_t spline_compact_write(
+  const char* filename,
+  spline_compact_t* compact);
+
+#endif
@@ -0,0 +1,43 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_EXTRAPOLATION_TYPE_H
+#define SPLINE_EXTRAPOLATION_TYPE_H
+
+/** \file spline/extrapolation_type.h
+  * \ingroup spline
+  * \brief Definition of the spline extrapolation type
+  * \author Ralf Kaestner
+  * 
+  * The spline extrapolation type determines the evaluation of a spline
+  * at locations outside the range of its knots.
+  */
+
+/** \brief Spline extrapolation type
+  */
+typedef enum {
+  spline_extrapolation_type_error,      //!< Report undefined spline.
+  spline_extrapolation_type_nan,        //!< Return NaN silently.
+  spline_extrapolation_type_clamp,      //!< Clamp to the outer knots.
+  spline_extrapolation_type_linear,     //!< Extrapolate outer tangents.
+  spline_extrapolation_type_cubic,      //!< Extrapolate outer segments.
+} spline_extrapolation_type_t;
+
+#endif
@@ -23,6 +23,11 @@
 #define sqr(a) ((a)*(a))
 #define cub(a) ((a)*(a)*(a))
 
+const char* spline_knot_types[] = {
+  "y2",
+  "y1",
+};
+
 void spline_knot_init(spline_knot_t* knot, double x, double y, double y2) {
   knot->x = x;
   knot->y = y;
@@ -57,3 +62,21 @@ double spline_knot_eval(const spline_knot_t* knot_min, const spline_knot_t*
     return a*knot_min->y+b*knot_max->y+((cub(a)-a)*knot_min->y2+
       (cub(b)-b)*knot_max->y2)*sqr(h_i)/6.0;
 }
+
+double spline_knot_eval_hermite(const spline_knot_t* knot_min, const
+    spline_knot_t* knot_max, spline_eval_type_t eval_type, double x) {
+  double h_i = knot_max->x-knot_min->x;
+  double t = (x-knot_min->x)/h_i;
+  double d_y = (knot_max->y-knot_min->y)/h_i;
+
+  if (eval_type == spline_eval_type_first_derivative)
+    return 6.0*(t-sqr(t))*d_y+(3.0*sqr(t)-4.0*t+1.0)*knot_min->y2+
+      (3.0*sqr(t)-2.0*t)*knot_max->y2;
+  else if (eval_type == spline_eval_type_second_derivative)
+    return ((6.0-12.0*t)*d_y+(6.0*t-4.0)*knot_min->y2+
+      (6.0*t-2.0)*knot_max->y2)/h_i;
+  else
+    return (2.0*cub(t)-3.0*sqr(t)+1.0)*knot_min->y+
+      (3.0*sqr(t)-2.0*cub(t))*knot_max->y+
+      ((cub(t)-2.0*sqr(t)+t)*knot_min->y2+(cub(t)-sqr(t))*knot_max->y2)*h_i;
+}
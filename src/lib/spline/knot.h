@@ -35,9 +35,25 @@
 
 #include "spline/eval_type.h"
 
+/** \brief Spline knot type
+  * 
+  * The spline knot type determines the interpretation of the third
+  * component of a spline knot.
+  */
+typedef enum {
+  spline_knot_type_y2,         //!< Knot carries the second derivative.
+  spline_knot_type_y1,         //!< Knot carries the first derivative.
+} spline_knot_type_t;
+
+/** \brief Predefined spline knot type strings
+  */
+extern const char* spline_knot_types[];
+
 /** \brief Structure defining a spline knot
   * 
   * A spline knot is defined by an x and y-component, and its curvature.
+  * For knots of type spline_knot_type_y1, the third component instead
+  * holds the first derivative at the knot.
   */
 typedef struct spline_knot_t {
   double x;                    //!< The x-component of the spline knot.
@@ -93,4 +109,27 @@ double spline_knot_eval(
   spline_eval_type_t eval_type,
   double x);
 
+/** \brief Evaluate the third-order Hermite polynomial defined by two cubic
+  *   spline knots of type spline_knot_type_y1
+  * \param[in] knot_min The spline knot whose location defines the lower
+  *   bound of the spline interval defined by both knots. This bound will
+  *   not be checked nor enforced by the function.
+  * \param[in] knot_max The spline knot whose location defines the upper
+  *   bound of the spline interval defined by both knots. This bound will
+  *   not be checked nor enforced by the function.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The location at which to evaluate the third-order
+  *   Hermite polynomial defined by the knots.
+  * \return The value of the third-order Hermite polynomial at the given
+  *   location.
+  * 
+  * The third component of both knots is interpreted as the first
+  * derivative at the knot.
+  */
+double spline_knot_eval_hermite(
+  const spline_knot_t* knot_min,
+  const spline_knot_t* knot_max,
+  spline_eval_type_t eval_type,
+  double x);
+
 #endif
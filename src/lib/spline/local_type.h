@@ -0,0 +1,42 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_LOCAL_TYPE_H
+#define SPLINE_LOCAL_TYPE_H
+
+/** \file spline/local_type.h
+  * \ingroup spline
+  * \brief Definition of the local spline interpolation type
+  * \author Ralf Kaestner
+  * 
+  * The local spline interpolation type determines the scheme used for
+  * estimating the first derivatives at the knots of a cubic Hermite spline
+  * from the neighboring data points.
+  */
+
+/** \brief Local spline interpolation type
+  */
+typedef enum {
+  spline_local_type_akima,              //!< Akima's weighted slopes.
+  spline_local_type_monotone,           //!< Fritsch-Carlson (PCHIP) slopes.
+  spline_local_type_catmull_rom,        //!< Catmull-Rom central slopes.
+} spline_local_type_t;
+
+#endif
@@ -26,6 +26,7 @@
 #include "spline.h"
 
 #include "spline/segment.h"
+#include "spline/tridiag.h"
 
 #include "string/string.h"
 
@@ -42,12 +43,103 @@ const char* spline_errors[] = {
   "Failed to write spline to file",
   "Spline undefined at value",
   "Spline interpolation failed",
+  "Spline sampling failed",
 };
 
+static int spline_int_solve_tridiag(thread_pool_t* pool, const gsl_vector*
+    d, const gsl_vector* e, const gsl_vector* c, const gsl_vector* b,
+    gsl_vector* x) {
+  if (pool && (d->size >= SPLINE_INT_PARALLEL_THRESHOLD))
+    return spline_tridiag_solve_parallel(pool, d->data, e->data, c->data,
+      b->data, x->data, d->size);
+  else
+    return gsl_linalg_solve_tridiag(d, e, c, b, x);
+}
+
+static double spline_int_local_slope(const spline_knot_t* knots, size_t
+    num_knots, ssize_t index) {
+  if (index < 0)
+    return 2.0*spline_int_local_slope(knots, num_knots, index+1)-
+      spline_int_local_slope(knots, num_knots, index+2);
+  else if (index+1 >= num_knots)
+    return 2.0*spline_int_local_slope(knots, num_knots, index-1)-
+      spline_int_local_slope(knots, num_knots, index-2);
+  else
+    return (knots[index+1].y-knots[index].y)/(knots[index+1].x-
+      knots[index].x);
+}
+
+static double spline_int_local_y1(const spline_knot_t* knots, size_t
+    num_knots, size_t index, spline_local_type_t local_type) {
+  if (num_knots < 3)
+    return (num_knots > 1) ? spline_int_local_slope(knots, num_knots, 0) :
+      0.0;
+  
+  if (local_type == spline_local_type_akima) {
+    double m_0 = spline_int_local_slope(knots, num_knots, index-2);
+    double m_1 = spline_int_local_slope(knots, num_knots, index-1);
+    double m_2 = spline_int_local_slope(knots, num_knots, index);
+    double m_3 = spline_int_local_slope(knots, num_knots, index+1);
+    double w_1 = fabs(m_3-m_2), w_2 = fabs(m_1-m_0);
+    
+    return (w_1+w_2 > 0.0) ? (w_1*m_1+w_2*m_2)/(w_1+w_2) : 0.5*(m_1+m_2);
+  }
+  else if (local_type == spline_local_type_monotone) {
+    if (!index || (index+1 == num_knots)) {
+      size_t i = index ? index-1 : 0, j = index ? index-2 : 1;
+      double h_i = knots[i+1].x-knots[i].x, h_j = knots[j+1].x-knots[j].x;
+      double d_i = spline_int_local_slope(knots, num_knots, i);
+      double d_j = spline_int_local_slope(knots, num_knots, j);
+      double y1 = ((2.0*h_i+h_j)*d_i-h_i*d_j)/(h_i+h_j);
+      
+      if (y1*d_i <= 0.0)
+        return 0.0;
+      else if ((d_i*d_j <= 0.0) && (fabs(y1) > 3.0*fabs(d_i)))
+        return 3.0*d_i;
+      else
+        return y1;
+    }
+    else {
+      double h_i = knots[index].x-knots[index-1].x;
+      double h_j = knots[index+1].x-knots[index].x;
+      double d_i = spline_int_local_slope(knots, num_knots, index-1);
+      double d_j = spline_int_local_slope(knots, num_knots, index);
+      
+      if (d_i*d_j <= 0.0)
+        return 0.0;
+      else {
+        double w_i = 2.0*h_j+h_i, w_j = h_j+2.0*h_i;
+        return (w_i+w_j)/(w_i/d_i+w_j/d_j);
+      }
+    }
+  }
+  else {
+    if (!index)
+      return spline_int_local_slope(knots, num_knots, 0);
+    else if (index+1 == num_knots)
+      return spline_int_local_slope(knots, num_knots, index-1);
+    else
+      return (knots[index+1].y-knots[index-1].y)/(knots[index+1].x-
+        knots[index-1].x);
+  }
+}
+
+static void spline_int_local_update_y1(spline_t* spline, spline_local_type_t
+    local_type) {
+  size_t i = (spline->num_knots > 4) ? spline->num_knots-4 : 0;
+  
+  for ( ; i < spline->num_knots; ++i)
+    spline->knots[i].y2 = spline_int_local_y1(spline->knots,
+      spline->num_knots, i, local_type);
+}
+
 void spline_init(spline_t* spline) {
   spline->knots = 0;
   spline->num_knots = 0;
   
+  spline->knot_type = spline_knot_type_y2;
+  spline->extrapolation_type = spline_extrapolation_type_error;
+  
   error_init(&spline->error, spline_errors);
 }
 
@@ -64,6 +156,7 @@ void spline_clear(spline_t* spline) {
     spline->knots = 0;
     spline->num_knots = 0;
   }
+  spline->knot_type = spline_knot_type_y2;
   
   error_clear(&spline->error);
 }
@@ -76,7 +169,21 @@ int spline_get_segment(spline_t* spline, size_t index, spline_segment_t*
     segment) {
   error_clear(&spline->error);
   
-  if ((index >= 0) && (index+1 < spline->num_knots)) {
+  if ((index >= 0) && (index+1 < spline->num_knots) &&
+      (spline->knot_type == spline_knot_type_y1)) {
+    double x_1 = spline->knots[index+1].x-spline->knots[index].x;
+    double d_y = (spline->knots[index+1].y-spline->knots[index].y)/x_1;
+    
+    segment->a = (spline->knots[index].y2+spline->knots[index+1].y2-
+      2.0*d_y)/sqr(x_1);
+    segment->b = (3.0*d_y-2.0*spline->knots[index].y2-
+      spline->knots[index+1].y2)/x_1;
+    segment->c = spline->knots[index].y2;
+    segment->d = spline->knots[index].y;
+
+    segment->x_0 = spline->knots[index].x;
+  }
+  else if ((index >= 0) && (index+1 < spline->num_knots)) {
     double x_1 = spline->knots[index+1].x-spline->knots[index].x;
       
     segment->a = (spline->knots[index+1].y2-spline->knots[index].y2)/(6.0*x_1);
@@ -84,6 +191,8 @@ int spline_get_segment(spline_t* spline, size_t index, spline_segment_t*
     segment->c = (spline->knots[index+1].y-segment->a*cub(x_1)-
       segment->b*sqr(x_1)-spline->knots[index].y)/x_1;
     segment->d = spline->knots[index].y;
+
+    segment->x_0 = spline->knots[index].x;
   }
   else
     error_setf(&spline->error, SPLINE_ERROR_SEGMENT, "%d", (int)index);
@@ -129,8 +238,8 @@ ssize_t spline_find_segment_linear(spline_t* spline, double x, size_t
   
   if ((spline->num_knots > 1) && (x >= spline->knots[0].x) &&
       (x <= spline->knots[spline->num_knots-1].x)) {
-    size_t i = (index_start < spline->num_knots) ? index_start : 
-      spline->num_knots-1;
+    size_t i = (index_start+1 < spline->num_knots) ? index_start : 
+      spline->num_knots-2;
       
     while (1) {
       if (x >= spline->knots[i].x) {
@@ -179,11 +288,27 @@ int spline_read(const char* filename, spline_t* spline) {
   
   char* line = 0;
   while (!file_eof(&file) && (file_read_line(&file, &line, 128) >= 0)) {
-    if (string_empty(line) || string_starts_with(line, "#"))
+    if (string_empty(line))
       continue;
+    else if (string_starts_with(line, "#")) {
+      char type[16];
+      
+      if (string_scanf(line, "# knot-type %15s", type) == 1) {
+        if (string_equal(type, spline_knot_types[spline_knot_type_y1]))
+          spline->knot_type = spline_knot_type_y1;
+        else if (string_equal(type,
+            spline_knot_types[spline_knot_type_y2]))
+          spline->knot_type = spline_knot_type_y2;
+        else {
+          error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT, "%s", line);
+          break;
+        }
+      }
+      continue;
+    }
       
     if (string_scanf(line, "%lg %lg %lg", &knot.x, &knot.y, &knot.y2) != 3) {
-      error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT, line);
+      error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT, "%s", line);
       break;
     }
 
@@ -210,12 +335,14 @@ int spline_write(const char* filename, spline_t* spline) {
     file_open(&file, file_mode_write);
 
   size_t i;
-  for (i = 0; i < spline->num_knots; ++i)
-    if (file_printf(&file, "%10lg %10lg %10lg\n",
-      spline->knots[i].x,
-      spline->knots[i].y,
-      spline->knots[i].y2) < 0)
-    break;
+  if (file_printf(&file, "# knot-type %s\n",
+      spline_knot_types[spline->knot_type]) >= 0)
+    for (i = 0; i < spline->num_knots; ++i)
+      if (file_printf(&file, "%10lg %10lg %10lg\n",
+        spline->knots[i].x,
+        spline->knots[i].y,
+        spline->knots[i].y2) < 0)
+        break;
 
   if (file.error.code)
     error_blame(&spline->error, &file.error, SPLINE_ERROR_FILE_WRITE);
@@ -263,6 +390,11 @@ size_t spline_add_knot(spline_t* spline, const spline_knot_t* knot) {
 
 ssize_t spline_int_y1(spline_t* spline, const spline_point_t* points,
     size_t num_points, double y1_0, double y1_n) {
+  return spline_int_y1_parallel(0, spline, points, num_points, y1_0, y1_n);
+}
+
+ssize_t spline_int_y1_parallel(thread_pool_t* pool, spline_t* spline, const
+    spline_point_t* points, size_t num_points, double y1_0, double y1_n) {
   error_clear(&spline->error);
   
   if (num_points > 2) {
@@ -276,10 +408,11 @@ ssize_t spline_int_y1(spline_t* spline, const spline_point_t* points,
     double* y2 = 0;
     ssize_t result;
     
-    if ((result = spline_int_solve_tridiag_y2(points, num_points, 2.0, 2.0,
-        1.0, 1.0, b_1, b_n, &y2)) > 0) {    
+    if ((result = spline_int_solve_tridiag_y2_parallel(pool, points,
+        num_points, 2.0, 2.0, 1.0, 1.0, b_1, b_n, &y2)) > 0) {    
       spline->knots = realloc(spline->knots, result*sizeof(spline_knot_t));
       spline->num_knots = result;
+      spline->knot_type = spline_knot_type_y2;
     
       size_t i;
       for (i = 0; i < spline->num_knots; ++i) {
@@ -302,16 +435,22 @@ ssize_t spline_int_y1(spline_t* spline, const spline_point_t* points,
 
 ssize_t spline_int_y2(spline_t* spline, const spline_point_t* points,
     size_t num_points, double y2_0, double y2_n) {
+  return spline_int_y2_parallel(0, spline, points, num_points, y2_0, y2_n);
+}
+
+ssize_t spline_int_y2_parallel(thread_pool_t* pool, spline_t* spline, const
+    spline_point_t* points, size_t num_points, double y2_0, double y2_n) {
   error_clear(&spline->error);
   
   if (num_points > 2) {
     double* y2 = 0;
     ssize_t result;
     
-    if ((result = spline_int_solve_tridiag_y2(points, num_points, 1.0, 1.0,
-        0.0, 0.0, y2_0, y2_n, &y2)) > 0) {    
+    if ((result = spline_int_solve_tridiag_y2_parallel(pool, points,
+        num_points, 1.0, 1.0, 0.0, 0.0, y2_0, y2_n, &y2)) > 0) {    
       spline->knots = realloc(spline->knots, result*sizeof(spline_knot_t));
       spline->num_knots = result;
+      spline->knot_type = spline_knot_type_y2;
     
       size_t i;
       for (i = 0; i < spline->num_knots; ++i) {
@@ -335,6 +474,13 @@ ssize_t spline_int_y2(spline_t* spline, const spline_point_t* points,
 ssize_t spline_int_y1_y2(spline_t* spline, const spline_point_t* points,
     size_t num_points, double y1_0, double y1_n, double y2_0, double y2_n,
     double r_0, double r_n) {
+  return spline_int_y1_y2_parallel(0, spline, points, num_points, y1_0,
+    y1_n, y2_0, y2_n, r_0, r_n);
+}
+
+ssize_t spline_int_y1_y2_parallel(thread_pool_t* pool, spline_t* spline,
+    const spline_point_t* points, size_t num_points, double y1_0, double
+    y1_n, double y2_0, double y2_n, double r_0, double r_n) {
   error_clear(&spline->error);
   
   if (num_points > 4) {
@@ -405,10 +551,11 @@ ssize_t spline_int_y1_y2(spline_t* spline, const spline_point_t* points,
     gsl_vector_set(d, num_points-1, d_n);
     gsl_vector_set(b, num_points-1, b_n);
 
-    if (!gsl_linalg_solve_tridiag(d, e, c, b, x)) {
+    if (!spline_int_solve_tridiag(pool, d, e, c, b, x)) {
       spline->knots = realloc(spline->knots, (num_points+2)*
         sizeof(spline_knot_t));
       spline->num_knots = num_points+2;
+      spline->knot_type = spline_knot_type_y2;
 
       spline->knots[0].x = points[0].x;
       spline->knots[0].y = points[0].y;
@@ -456,11 +603,21 @@ ssize_t spline_int_natural(spline_t* spline, const spline_point_t*  points,
   return spline_int_y2(spline, points, num_points, 0.0, 0.0);
 }
 
+ssize_t spline_int_natural_parallel(thread_pool_t* pool, spline_t* spline,
+    const spline_point_t* points, size_t num_points) {
+  return spline_int_y2_parallel(pool, spline, points, num_points, 0.0, 0.0);
+}
+
 ssize_t spline_int_clamped(spline_t* spline, const spline_point_t* points,
     size_t num_points) {
   return spline_int_y1(spline, points, num_points, 0.0, 0.0);
 }
 
+ssize_t spline_int_clamped_parallel(thread_pool_t* pool, spline_t* spline,
+    const spline_point_t* points, size_t num_points) {
+  return spline_int_y1_parallel(pool, spline, points, num_points, 0.0, 0.0);
+}
+
 ssize_t spline_int_periodic(spline_t* spline, const spline_point_t* points,
     size_t num_points) {
   error_clear(&spline->error);
@@ -482,6 +639,7 @@ ssize_t spline_int_periodic(spline_t* spline, const spline_point_t* points,
       spline->knots = realloc(spline->knots, (result+1)*
         sizeof(spline_knot_t));
       spline->num_knots = result+1;
+      spline->knot_type = spline_knot_type_y2;
       
       size_t i;
       for (i = 0; i < spline->num_knots; ++i) {
@@ -504,6 +662,11 @@ ssize_t spline_int_periodic(spline_t* spline, const spline_point_t* points,
 
 ssize_t spline_int_not_a_knot(spline_t* spline, const spline_point_t* points,
     size_t num_points) {
+  return spline_int_not_a_knot_parallel(0, spline, points, num_points);
+}
+
+ssize_t spline_int_not_a_knot_parallel(thread_pool_t* pool, spline_t* spline,
+    const spline_point_t* points, size_t num_points) {
   error_clear(&spline->error);
   
   if (num_points > 4) {
@@ -524,10 +687,11 @@ ssize_t spline_int_not_a_knot(spline_t* spline, const spline_point_t* points,
     double* y2 = 0;
     ssize_t result;
     
-    if ((result = spline_int_solve_tridiag_y2(&points[1], num_points-2,
-        d_1, d_n, e_1, c_m, b_1, b_n, &y2)) > 0) {    
+    if ((result = spline_int_solve_tridiag_y2_parallel(pool, &points[1],
+        num_points-2, d_1, d_n, e_1, c_m, b_1, b_n, &y2)) > 0) {    
       spline->knots = realloc(spline->knots, result*sizeof(spline_knot_t));
       spline->num_knots = result;
+      spline->knot_type = spline_knot_type_y2;
     
       size_t i;
       for (i = 0; i < spline->num_knots; ++i) {
@@ -561,9 +725,172 @@ ssize_t spline_int_not_a_knot(spline_t* spline, const spline_point_t* points,
   return spline->error.code ? -spline->error.code : spline->num_knots;
 }
 
+ssize_t spline_int_akima(spline_t* spline, const spline_point_t* points,
+    size_t num_points) {
+  return spline_int_local(spline, points, num_points,
+    spline_local_type_akima);
+}
+
+ssize_t spline_int_monotone(spline_t* spline, const spline_point_t* points,
+    size_t num_points) {
+  return spline_int_local(spline, points, num_points,
+    spline_local_type_monotone);
+}
+
+ssize_t spline_int_catmull_rom(spline_t* spline, const spline_point_t*
+    points, size_t num_points) {
+  return spline_int_local(spline, points, num_points,
+    spline_local_type_catmull_rom);
+}
+
+ssize_t spline_int_local(spline_t* spline, const spline_point_t* points,
+    size_t num_points, spline_local_type_t local_type) {
+  error_clear(&spline->error);
+  
+  if (num_points > 1) {
+    spline->knots = realloc(spline->knots, num_points*sizeof(spline_knot_t));
+    spline->num_knots = 0;
+    spline->knot_type = spline_knot_type_y1;
+    
+    size_t i;
+    for (i = 0; i < num_points; ++i) {
+      if (i && (points[i].x <= points[i-1].x)) {
+        error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+        break;
+      }
+      
+      spline_knot_init(&spline->knots[i], points[i].x, points[i].y, 0.0);
+      ++spline->num_knots;
+      
+      spline_int_local_update_y1(spline, local_type);
+    }
+  }
+  else
+    error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+  
+  return spline->error.code ? -spline->error.code : spline->num_knots;
+}
+
+ssize_t spline_int_local_append(spline_t* spline, const spline_point_t*
+    point, spline_local_type_t local_type) {
+  error_clear(&spline->error);
+  
+  if (!spline->num_knots)
+    spline->knot_type = spline_knot_type_y1;
+  
+  if ((spline->knot_type == spline_knot_type_y1) && (!spline->num_knots ||
+      (point->x > spline->knots[spline->num_knots-1].x))) {
+    size_t capacity = 1;
+    while (capacity <= spline->num_knots)
+      capacity <<= 1;
+    
+    spline->knots = realloc(spline->knots, capacity*sizeof(spline_knot_t));
+    spline_knot_init(&spline->knots[spline->num_knots], point->x, point->y,
+      0.0);
+    ++spline->num_knots;
+    
+    spline_int_local_update_y1(spline, local_type);
+  }
+  else
+    error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+  
+  return spline->error.code ? -spline->error.code : spline->num_knots;
+}
+
+ssize_t spline_int_update(spline_t* spline, size_t index, double y, double
+    tolerance, size_t* index_min, size_t* index_max) {
+  error_clear(&spline->error);
+  
+  if ((spline->num_knots > 2) && (index < spline->num_knots) &&
+      (spline->knot_type == spline_knot_type_y2)) {
+    spline_knot_t* knots = spline->knots;
+    size_t n = spline->num_knots;
+    double y_k = knots[index].y;
+    
+    size_t i_min = index, i_max = index, w = 8;
+    size_t num_knots = 0;
+    
+    knots[index].y = y;
+    if (y != y_k) {
+      double* d = 0, * e = 0, * c = 0, * b = 0, * y2 = 0;
+      
+      while (1) {
+        i_min = (index > w+1) ? index-w : 1;
+        i_max = (index+w < n-2) ? index+w : n-2;
+        
+        size_t i, m = i_max-i_min+1;
+        d = realloc(d, m*sizeof(double));
+        e = realloc(e, m*sizeof(double));
+        c = realloc(c, m*sizeof(double));
+        b = realloc(b, m*sizeof(double));
+        y2 = realloc(y2, m*sizeof(double));
+        
+        for (i = i_min; i <= i_max; ++i) {
+          double h_i = knots[i].x-knots[i-1].x;
+          double h_j = knots[i+1].x-knots[i].x;
+          
+          d[i-i_min] = 2.0*(h_i+h_j);
+          e[i-i_min] = h_j;
+          c[i-i_min] = h_i;
+          
+          if (i+1 == index)
+            b[i-i_min] = 6.0*(y-y_k)/h_j;
+          else if (i == index)
+            b[i-i_min] = -6.0*(y-y_k)*(1.0/h_i+1.0/h_j);
+          else if (i == index+1)
+            b[i-i_min] = 6.0*(y-y_k)/h_i;
+          else
+            b[i-i_min] = 0.0;
+        }
+        
+        if (spline_tridiag_solve(d, e, &c[1], b, y2, m)) {
+          error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+          break;
+        }
+        
+        if (((i_min == 1) || (fabs(y2[0]) <= tolerance)) &&
+            ((i_max == n-2) || (fabs(y2[m-1]) <= tolerance))) {
+          for (i = i_min; i <= i_max; ++i)
+            knots[i].y2 += y2[i-i_min];
+          num_knots = m;
+          
+          break;
+        }
+        
+        w *= 2;
+      }
+      
+      free(d);
+      free(e);
+      free(c);
+      free(b);
+      free(y2);
+    }
+    
+    if (index_min)
+      *index_min = i_min;
+    if (index_max)
+      *index_max = i_max;
+    
+    if (!spline->error.code)
+      return num_knots;
+  }
+  else
+    error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+  
+  return -spline->error.code;
+}
+
 ssize_t spline_int_solve_tridiag_y1(const spline_point_t* points, size_t
     num_points, double d_1, double d_n, double e_1, double c_m, double b_1,
     double b_n, double** y1) {
+  return spline_int_solve_tridiag_y1_parallel(0, points, num_points, d_1,
+    d_n, e_1, c_m, b_1, b_n, y1);
+}
+
+ssize_t spline_int_solve_tridiag_y1_parallel(thread_pool_t* pool, const
+    spline_point_t* points, size_t num_points, double d_1, double d_n, double
+    e_1, double c_m, double b_1, double b_n, double** y1) {
   if (num_points > 2) {
     *y1 = realloc(*y1, num_points*sizeof(double));
     
@@ -599,7 +926,7 @@ ssize_t spline_int_solve_tridiag_y1(const spline_point_t* points, size_t
     gsl_vector_set(d, num_points-1, d_n);
     gsl_vector_set(b, num_points-1, b_n);
 
-    int result = gsl_linalg_solve_tridiag(d, e, c, b, &x.vector);
+    int result = spline_int_solve_tridiag(pool, d, e, c, b, &x.vector);
     
     gsl_vector_free(c);
     gsl_vector_free(d);
@@ -620,6 +947,13 @@ ssize_t spline_int_solve_tridiag_y1(const spline_point_t* points, size_t
 ssize_t spline_int_solve_tridiag_y2(const spline_point_t* points, size_t
     num_points, double d_1, double d_n, double e_1, double c_m, double b_1,
     double b_n, double** y2) {
+  return spline_int_solve_tridiag_y2_parallel(0, points, num_points, d_1,
+    d_n, e_1, c_m, b_1, b_n, y2);
+}
+
+ssize_t spline_int_solve_tridiag_y2_parallel(thread_pool_t* pool, const
+    spline_point_t* points, size_t num_points, double d_1, double d_n, double
+    e_1, double c_m, double b_1, double b_n, double** y2) {
   if (num_points > 2) {
     *y2 = realloc(*y2, num_points*sizeof(double));
     
@@ -655,7 +989,7 @@ ssize_t spline_int_solve_tridiag_y2(const spline_point_t* points, size_t
     gsl_vector_set(d, num_points-1, d_n);
     gsl_vector_set(b, num_points-1, b_n);
 
-    int result = gsl_linalg_solve_tridiag(d, e, c, b, &x.vector);
+    int result = spline_int_solve_tridiag(pool, d, e, c, b, &x.vector);
     
     gsl_vector_free(c);
     gsl_vector_free(d);
@@ -722,6 +1056,47 @@ ssize_t spline_int_solve_symm_cyc_tridiag_y2(const spline_point_t* points,
   return -SPLINE_ERROR_INTERPOLATION;
 }
 
+static double spline_eval_segment(const spline_t* spline, size_t index,
+    spline_eval_type_t eval_type, double x) {
+  if (spline->knot_type == spline_knot_type_y1)
+    return spline_knot_eval_hermite(&spline->knots[index],
+      &spline->knots[index+1], eval_type, x);
+  else
+    return spline_knot_eval(&spline->knots[index], &spline->knots[index+1],
+      eval_type, x);
+}
+
+static int spline_is_extrapolated(const spline_t* spline, double x) {
+  return (spline->extrapolation_type != spline_extrapolation_type_error) &&
+    (spline->num_knots > 1) && ((x < spline->knots[0].x) ||
+    (x > spline->knots[spline->num_knots-1].x));
+}
+
+static double spline_extrapolate(const spline_t* spline, spline_eval_type_t
+    eval_type, double x, size_t index) {
+  const spline_knot_t* knot = (x < spline->knots[0].x) ? &spline->knots[0] :
+    &spline->knots[spline->num_knots-1];
+  
+  switch (spline->extrapolation_type) {
+    case spline_extrapolation_type_clamp:
+      return (eval_type == spline_eval_type_base_function) ? knot->y : 0.0;
+    case spline_extrapolation_type_linear:
+      if (eval_type == spline_eval_type_second_derivative)
+        return 0.0;
+      else {
+        double y1 = spline_eval_segment(spline, index,
+          spline_eval_type_first_derivative, knot->x);
+        
+        return (eval_type == spline_eval_type_base_function) ?
+          knot->y+y1*(x-knot->x) : y1;
+      }
+    case spline_extrapolation_type_cubic:
+      return spline_eval_segment(spline, index, eval_type, x);
+    default:
+      return NAN;
+  }
+}
+
 double spline_eval(spline_t* spline, spline_eval_type_t eval_type, double x) {
   return spline_eval_bisect(spline, eval_type, x, 0,
     spline->num_knots > 1 ? spline->num_knots-1 : 0);
@@ -731,9 +1106,12 @@ double spline_eval_bisect(spline_t* spline, spline_eval_type_t eval_type,
     double x, size_t index_min, size_t index_max) {
   ssize_t i;
   
-  if ((i = spline_find_segment_bisect(spline, x, index_min, index_max)) >= 0)
-    return spline_knot_eval(&spline->knots[i], &spline->knots[i+1],
-      eval_type, x);
+  if (spline_is_extrapolated(spline, x))
+    return spline_extrapolate(spline, eval_type, x,
+      (x < spline->knots[0].x) ? 0 : spline->num_knots-2);
+  else if ((i = spline_find_segment_bisect(spline, x, index_min,
+      index_max)) >= 0)
+    return spline_eval_segment(spline, i, eval_type, x);
   else
     return NAN;
 }
@@ -742,11 +1120,95 @@ double spline_eval_linear(spline_t* spline, spline_eval_type_t eval_type,
     double x, size_t* index) {
   ssize_t i;
   
-  if ((i = spline_find_segment_linear(spline, x, *index)) >= 0) {
+  if (spline_is_extrapolated(spline, x)) {
+    *index = (x < spline->knots[0].x) ? 0 : spline->num_knots-2;
+    return spline_extrapolate(spline, eval_type, x, *index);
+  }
+  else if ((i = spline_find_segment_linear(spline, x, *index)) >= 0) {
     *index = i;
-    return spline_knot_eval(&spline->knots[i], &spline->knots[i+1],
-      eval_type, x);
+    return spline_eval_segment(spline, i, eval_type, x);
   }
   else
     return NAN;
 }
+
+ssize_t spline_eval_array(spline_t* spline, spline_eval_type_t eval_type,
+    const double* x, double* f_x, size_t num_values, size_t* index) {
+  size_t num_undefined = 0, i, j = *index;
+  double x_undefined = 0.0;
+  ssize_t k;
+  
+  for (i = 0; i < num_values; ++i) {
+    if (spline_is_extrapolated(spline, x[i])) {
+      j = (x[i] < spline->knots[0].x) ? 0 : spline->num_knots-2;
+      f_x[i] = spline_extrapolate(spline, eval_type, x[i], j);
+    }
+    else if ((j+1 < spline->num_knots) && (x[i] >= spline->knots[j].x) &&
+        (x[i] <= spline->knots[j+1].x))
+      f_x[i] = spline_eval_segment(spline, j, eval_type, x[i]);
+    else if ((j+2 < spline->num_knots) && (x[i] > spline->knots[j+1].x) &&
+        (x[i] <= spline->knots[j+2].x))
+      f_x[i] = spline_eval_segment(spline, ++j, eval_type, x[i]);
+    else if ((k = spline_find_segment(spline, x[i])) >= 0) {
+      j = k;
+      f_x[i] = spline_eval_segment(spline, j, eval_type, x[i]);
+    }
+    else if (!num_undefined++) {
+      x_undefined = x[i];
+      f_x[i] = NAN;
+    }
+    else
+      f_x[i] = NAN;
+  }
+  *index = j;
+  
+  if (num_undefined)
+    error_setf(&spline->error, SPLINE_ERROR_UNDEFINED, "%lg", x_undefined);
+  else
+    error_clear(&spline->error);
+  
+  return spline->error.code ? -spline->error.code : num_values;
+}
+
+ssize_t spline_sample_adaptive(spline_t* spline, spline_eval_type_t
+    eval_type, double tolerance, double max_step_size, double** x) {
+  size_t num_samples = 0, capacity = 0, i, j;
+  spline_segment_t segment;
+
+  error_clear(&spline->error);
+
+  if ((spline->num_knots < 2) || !(tolerance > 0.0)) {
+    error_set(&spline->error, SPLINE_ERROR_SAMPLING);
+    return -spline->error.code;
+  }
+
+  for (i = 0; i+1 < spline->num_knots; ++i) {
+    double h = spline->knots[i+1].x-spline->knots[i].x;
+    double f_xx = 0.0;
+
+    spline_get_segment(spline, i, &segment);
+    if (eval_type == spline_eval_type_base_function)
+      f_xx = fmax(fabs(2.0*segment.b), fabs(2.0*segment.b+6.0*segment.a*h));
+    else if (eval_type == spline_eval_type_first_derivative)
+      f_xx = fabs(6.0*segment.a);
+
+    double step_size = (f_xx > 0.0) ? sqrt(8.0*tolerance/f_xx) : INFINITY;
+    if ((max_step_size > 0.0) && (max_step_size < step_size))
+      step_size = max_step_size;
+    size_t num_steps = ceil(h/step_size);
+    if (!num_steps)
+      num_steps = 1;
+
+    if (num_samples+num_steps+1 > capacity) {
+      while (num_samples+num_steps+1 > capacity)
+        capacity = capacity ? 2*capacity : 64;
+      *x = realloc(*x, capacity*sizeof(double));
+    }
+
+    for (j = 0; j < num_steps; ++j)
+      (*x)[num_samples++] = spline->knots[i].x+j*h/num_steps;
+  }
+  (*x)[num_samples++] = spline->knots[spline->num_knots-1].x;
+
+  return num_samples;
+}
@@ -47,6 +47,10 @@
 #include "spline/knot.h"
 #include "spline/segment.h"
 #include "spline/eval_type.h"
+#include "spline/extrapolation_type.h"
+#include "spline/local_type.h"
+
+#include "thread/pool.h"
 
 #include "error/error.h"
 
@@ -68,6 +72,16 @@
 //!< Spline undefined at value
 #define SPLINE_ERROR_INTERPOLATION         6
 //!< Spline interpolation failed
+#define SPLINE_ERROR_SAMPLING              7
+//!< Spline sampling failed
+//@}
+
+/** \name Constants
+  * \brief Predefined spline constants
+  */
+//@{
+#define SPLINE_INT_PARALLEL_THRESHOLD      1048576
+//!< The minimum number of unknowns for solving in parallel
 //@}
 
 /** \brief Predefined spline error descriptions
@@ -82,12 +96,21 @@ struct spline_segment_t;
 typedef struct spline_t {
   spline_knot_t* knots;       //!< The knots of the spline.
   size_t num_knots;           //!< The number of spline knots.
+  spline_knot_type_t knot_type;
+                              //!< The type of the spline knots.
+
+  spline_extrapolation_type_t extrapolation_type;
+                              //!< The extrapolation type of the spline.
 
   error_t error;              //!< The most recent spline error.
 } spline_t;
 
 /** \brief Initialize an empty cubic spline
   * \param[in] spline The cubic spline to be initialized.
+  * 
+  * The knots of the initialized spline will be of type
+  * spline_knot_type_y2, its extrapolation type will be
+  * spline_extrapolation_type_error.
   */
 void spline_init(
   spline_t* spline);
@@ -204,7 +227,9 @@ void spline_print(
   *   error code.
   * 
   * The spline knots will be re-allocated to accommodate the read file
-  * content.
+  * content. The knot type is given by a comment line of the form
+  * "# knot-type y1" as written by spline_write(). Files without such a
+  * line yield knots of type spline_knot_type_y2.
   */
 int spline_read(
   const char* filename,
@@ -217,6 +242,9 @@ int spline_read(
   * \param[in] spline The cubic spline to be written.
   * \return The number of spline knots written to the file or the negative
   *   error code.
+  *
+  * The knot type of the spline is recorded in a leading comment line,
+  * such that spline_read() will restore it.
   */
 int spline_write(
   const char* filename,
@@ -264,6 +292,34 @@ ssize_t spline_int_y1(
   double y1_0,
   double y1_n);
 
+/** \brief Cubic spline interpolation from data points with known first
+  *   derivatives at the outer knots, using a thread pool
+  * \param[in] pool The thread pool used for solving the tridiagonal
+  *   system. If null, the system will be solved sequentially.
+  * \param[in,out] spline The cubic spline to be generated from the data.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline.
+  * \param[in] num_points The number of spline data points.
+  * \param[in] y1_0 The first derivative at the first knot of the resulting
+  *   cubic spline.
+  * \param[in] y1_n The first derivative at the last knot of the resulting
+  *   cubic spline.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  *
+  * This function behaves like spline_int_y1(), but systems of at least
+  * SPLINE_INT_PARALLEL_THRESHOLD unknowns are solved by
+  * spline_tridiag_solve_parallel(). Since the pool processes the work of a
+  * single caller at a time, concurrent interpolations must not share it.
+  */
+ssize_t spline_int_y1_parallel(
+  thread_pool_t* pool,
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points,
+  double y1_0,
+  double y1_n);
+
 /** \brief Cubic spline interpolation from data points with known second
   *   derivatives at the outer knots
   * \param[in,out] spline The cubic spline to be generated from the data.
@@ -288,6 +344,31 @@ ssize_t spline_int_y2(
   double y2_0,
   double y2_n);
 
+/** \brief Cubic spline interpolation from data points with known second
+  *   derivatives at the outer knots, using a thread pool
+  * \param[in] pool The thread pool used for solving the tridiagonal
+  *   system. If null, the system will be solved sequentially.
+  * \param[in,out] spline The cubic spline to be generated from the data.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline.
+  * \param[in] num_points The number of spline data points.
+  * \param[in] y2_0 The second derivative at the first knot of the resulting
+  *   cubic spline.
+  * \param[in] y2_n The second derivative at the last knot of the resulting
+  *   cubic spline.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  *
+  * See spline_int_y1_parallel() for the use of the pool.
+  */
+ssize_t spline_int_y2_parallel(
+  thread_pool_t* pool,
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points,
+  double y2_0,
+  double y2_n);
+
 /** \brief Cubic spline interpolation from data points with known first and
   *   second derivatives at the outer knots
   * \param[in,out] spline The cubic spline to be generated from the data.
@@ -332,6 +413,39 @@ ssize_t spline_int_y1_y2(
   double r_0,
   double r_n);
 
+/** \brief Cubic spline interpolation from data points with known first and
+  *   second derivatives at the outer knots, using a thread pool
+  * \param[in] pool The thread pool used for solving the tridiagonal
+  *   system. If null, the system will be solved sequentially.
+  * \param[in,out] spline The cubic spline to be generated from the data.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline.
+  * \param[in] num_points The number of spline data points.
+  * \param[in] y1_0 The first derivative at the first knot.
+  * \param[in] y1_n The first derivative at the last knot.
+  * \param[in] y2_0 The second derivative at the first knot.
+  * \param[in] y2_n The second derivative at the last knot.
+  * \param[in] r_0 The relative location of the first intermediate knot,
+  *   see spline_int_y1_y2().
+  * \param[in] r_n The relative location of the last intermediate knot,
+  *   see spline_int_y1_y2().
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  *
+  * See spline_int_y1_parallel() for the use of the pool.
+  */
+ssize_t spline_int_y1_y2_parallel(
+  thread_pool_t* pool,
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points,
+  double y1_0,
+  double y1_n,
+  double y2_0,
+  double y2_n,
+  double r_0,
+  double r_n);
+
 /** \brief Natural cubic spline interpolation from data points
   * \param[in,out] spline The cubic spline to be generated from the data.
   * \param[in] points An array of spline data points which will define the
@@ -350,6 +464,25 @@ ssize_t spline_int_natural(
   const spline_point_t* points,
   size_t num_points);
 
+/** \brief Natural cubic spline interpolation from data points using a
+  *   thread pool
+  * \param[in] pool The thread pool used for solving the tridiagonal
+  *   system. If null, the system will be solved sequentially.
+  * \param[in,out] spline The cubic spline to be generated from the data.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline.
+  * \param[in] num_points The number of spline data points.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  *
+  * See spline_int_natural() and spline_int_y1_parallel().
+  */
+ssize_t spline_int_natural_parallel(
+  thread_pool_t* pool,
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points);
+
 /** \brief Clamped cubic spline interpolation from data points
   * \param[in,out] spline The cubic spline to be generated from the data.
   * \param[in] points An array of spline data points which will define the
@@ -368,6 +501,25 @@ ssize_t spline_int_clamped(
   const spline_point_t* points,
   size_t num_points);
 
+/** \brief Clamped cubic spline interpolation from data points using a
+  *   thread pool
+  * \param[in] pool The thread pool used for solving the tridiagonal
+  *   system. If null, the system will be solved sequentially.
+  * \param[in,out] spline The cubic spline to be generated from the data.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline.
+  * \param[in] num_points The number of spline data points.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  *
+  * See spline_int_clamped() and spline_int_y1_parallel().
+  */
+ssize_t spline_int_clamped_parallel(
+  thread_pool_t* pool,
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points);
+
 /** \brief Periodic cubic spline interpolation from data points
   * \param[in,out] spline The cubic spline to be generated from the data.
   * \param[in] points An array of spline data points which will define the
@@ -406,6 +558,162 @@ ssize_t spline_int_not_a_knot(
   const spline_point_t* points,
   size_t num_points);
 
+/** \brief Not-a-knot cubic spline interpolation from data points using a
+  *   thread pool
+  * \param[in] pool The thread pool used for solving the tridiagonal
+  *   system. If null, the system will be solved sequentially.
+  * \param[in,out] spline The cubic spline to be generated from the data.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline.
+  * \param[in] num_points The number of spline data points.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  *
+  * See spline_int_not_a_knot() and spline_int_y1_parallel().
+  */
+ssize_t spline_int_not_a_knot_parallel(
+  thread_pool_t* pool,
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points);
+
+/** \brief Local cubic Hermite spline interpolation
+  * \param[in,out] spline The cubic spline to be generated from the data
+  *   points.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline. The points must
+  *   be ordered by strictly increasing x-components.
+  * \param[in] num_points The number of spline data points.
+  * \param[in] local_type The local interpolation scheme used to determine
+  *   the first derivatives at the spline knots.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  * 
+  * Other than the global interpolation methods, local interpolation does
+  * not solve any system of equations. The first derivative at each knot
+  * follows from the neighboring data points only, such that the knots of
+  * the resulting spline are of type spline_knot_type_y1. The resulting
+  * spline is continuously differentiable, but its second derivatives will
+  * generally be discontinuous at the knots.
+  */
+ssize_t spline_int_local(
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points,
+  spline_local_type_t local_type);
+
+/** \brief Append a data point to a locally interpolating cubic spline
+  * \param[in,out] spline The locally interpolating cubic spline to which
+  *   the data point shall be appended. An empty spline will be accepted.
+  * \param[in] point The data point to be appended. Its x-component must
+  *   be strictly larger than the location of the spline's last knot.
+  * \param[in] local_type The local interpolation scheme used to determine
+  *   the first derivatives at the spline knots.
+  * \return The number of knots of the resulting cubic spline or the
+  *   negative error code.
+  * 
+  * Since local interpolation schemes only involve neighboring data points,
+  * appending a data point affects the first derivatives of the last few
+  * knots only. The knot array grows geometrically, and appending thus
+  * requires amortized constant time, making this function suitable for
+  * building splines from streaming data.
+  */
+ssize_t spline_int_local_append(
+  spline_t* spline,
+  const spline_point_t* point,
+  spline_local_type_t local_type);
+
+/** \brief Akima cubic spline interpolation
+  * \param[in,out] spline The cubic spline to be generated from the data
+  *   points.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline.
+  * \param[in] num_points The number of spline data points.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  * 
+  * This is a convenience function which calls spline_int_local() with
+  * spline_local_type_akima.
+  */
+ssize_t spline_int_akima(
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points);
+
+/** \brief Monotone cubic spline interpolation
+  * \param[in,out] spline The cubic spline to be generated from the data
+  *   points.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline.
+  * \param[in] num_points The number of spline data points.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  * 
+  * This is a convenience function which calls spline_int_local() with
+  * spline_local_type_monotone. The first derivatives at the knots follow
+  * the Fritsch-Carlson scheme as used by PCHIP, i.e., weighted harmonic
+  * means of the neighboring secant slopes, which are set to zero at local
+  * extrema of the data.
+  */
+ssize_t spline_int_monotone(
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points);
+
+/** \brief Catmull-Rom cubic spline interpolation
+  * \param[in,out] spline The cubic spline to be generated from the data
+  *   points.
+  * \param[in] points An array of spline data points which will define the
+  *   interpolation points of the resulting cubic spline.
+  * \param[in] num_points The number of spline data points.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  * 
+  * This is a convenience function which calls spline_int_local() with
+  * spline_local_type_catmull_rom.
+  */
+ssize_t spline_int_catmull_rom(
+  spline_t* spline,
+  const spline_point_t* points,
+  size_t num_points);
+
+/** \brief Update a data point of an interpolating cubic spline
+  * \param[in,out] spline The interpolating cubic spline to be updated.
+  * \param[in] index The index of the spline knot whose data point shall
+  *   be updated.
+  * \param[in] y The updated y-component of the data point.
+  * \param[in] tolerance The maximum tolerated deviation of the knots'
+  *   second derivatives from the result of a full interpolation. A
+  *   tolerance of zero enforces re-solving all knots.
+  * \param[out] index_min If not null, the lower bound of the window of
+  *   spline knots whose second derivatives have been re-solved.
+  * \param[out] index_max If not null, the upper bound of the window of
+  *   spline knots whose second derivatives have been re-solved.
+  * \return The number of re-solved spline knots or the negative error
+  *   code.
+  * 
+  * Since the tridiagonal system of the interpolation problem is diagonally
+  * dominant, the influence of a changed data point on the knots' second
+  * derivatives decays exponentially with the distance from the point. This
+  * function therefore solves the system for the change in the second
+  * derivatives within a window around the updated knot only, assuming
+  * zero change outside. Starting from a small window, its size is doubled
+  * until the change at the window's bounds falls below the tolerance.
+  * 
+  * The second derivatives at the outer spline knots remain fixed, which
+  * is consistent with splines generated by spline_int_y2() and
+  * spline_int_natural(). For other boundary conditions, updates close to
+  * the outer knots may deviate from a full interpolation. Splines with
+  * knots of type spline_knot_type_y1 are not supported.
+  */
+ssize_t spline_int_update(
+  spline_t* spline,
+  size_t index,
+  double y,
+  double tolerance,
+  size_t* index_min,
+  size_t* index_max);
+
 /** \brief Cubic spline interpolation solving a tridiagonal system for the
   *   knots' first derivatives
   * \param[in] points An array of spline data points which will define the
@@ -452,6 +760,38 @@ ssize_t spline_int_solve_tridiag_y1(
   double b_n,
   double** y1);
 
+/** \brief Cubic spline interpolation solving a tridiagonal system for the
+  *   knots' first derivatives using a thread pool
+  * \param[in] pool The thread pool used for solving the tridiagonal
+  *   system. If null, the system will be solved sequentially.
+  * \param[in] points An array of spline data points.
+  * \param[in] num_points The number of spline data points.
+  * \param[in] d_1 The first boundary element of the main diagonal.
+  * \param[in] d_n The last boundary element of the main diagonal.
+  * \param[in] e_1 The first boundary element of the upper sub-diagonal.
+  * \param[in] c_m The last boundary element of the lower sub-diagonal.
+  * \param[in] b_1 The first boundary element of the right-hand side vector.
+  * \param[in] b_n The last boundary element of the right-hand side vector.
+  * \param[in,out] y1 The resulting first derivatives at the spline knots.
+  *   The array will be re-allocated to accommodate the values and must be
+  *   freed by the caller.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  *
+  * See spline_int_solve_tridiag_y1() and spline_int_y1_parallel().
+  */
+ssize_t spline_int_solve_tridiag_y1_parallel(
+  thread_pool_t* pool,
+  const spline_point_t* points,
+  size_t num_points,
+  double d_1,
+  double d_n,
+  double e_1,
+  double c_m,
+  double b_1,
+  double b_n,
+  double** y1);
+
 /** \brief Cubic spline interpolation solving a tridiagonal system for the
   *   knots' second derivatives
   * \param[in] points An array of spline data points which will define the
@@ -498,6 +838,38 @@ ssize_t spline_int_solve_tridiag_y2(
   double b_n,
   double** y2);
 
+/** \brief Cubic spline interpolation solving a tridiagonal system for the
+  *   knots' second derivatives using a thread pool
+  * \param[in] pool The thread pool used for solving the tridiagonal
+  *   system. If null, the system will be solved sequentially.
+  * \param[in] points An array of spline data points.
+  * \param[in] num_points The number of spline data points.
+  * \param[in] d_1 The first boundary element of the main diagonal.
+  * \param[in] d_n The last boundary element of the main diagonal.
+  * \param[in] e_1 The first boundary element of the upper sub-diagonal.
+  * \param[in] c_m The last boundary element of the lower sub-diagonal.
+  * \param[in] b_1 The first boundary element of the right-hand side vector.
+  * \param[in] b_n The last boundary element of the right-hand side vector.
+  * \param[in,out] y2 The resulting second derivatives at the spline knots.
+  *   The array will be re-allocated to accommodate the values and must be
+  *   freed by the caller.
+  * \return The number of segments in the resulting cubic spline or the
+  *   negative error code.
+  *
+  * See spline_int_solve_tridiag_y2() and spline_int_y1_parallel().
+  */
+ssize_t spline_int_solve_tridiag_y2_parallel(
+  thread_pool_t* pool,
+  const spline_point_t* points,
+  size_t num_points,
+  double d_1,
+  double d_n,
+  double e_1,
+  double c_m,
+  double b_1,
+  double b_n,
+  double** y2);
+
 /** \brief Cubic spline interpolation solving a symmetric cyclic tridiagonal
   *   system for the knots' second derivatives
   * \param[in] points An array of spline data points which will define the
@@ -548,6 +920,12 @@ ssize_t spline_int_solve_symm_cyc_tridiag_y2(
   * This is a convenience function which evaluates the spline value by 
   * means of the function spline_eval_bisect(), allowing for the 
   * corresponding segment to be searched on the entire spline.
+  * 
+  * For locations outside the range of the spline knots, the spline's
+  * extrapolation type determines the result. Except for
+  * spline_extrapolation_type_error, which yields NaN and sets the
+  * spline error, the result is computed without modifying the spline
+  * error.
   */
 double spline_eval(
   spline_t* spline,
@@ -567,7 +945,9 @@ double spline_eval(
   * 
   * This method calls the function spline_find_segment_bisect() in order
   * to identify the spline segment at the given location. This is optimal
-  * if sequential calls to this function involve random locations.
+  * if sequential calls to this function involve random locations. Outside
+  * the range of the spline knots, the spline's extrapolation type applies
+  * as described for spline_eval().
   */
 double spline_eval_bisect(
   spline_t* spline,
@@ -590,7 +970,9 @@ double spline_eval_bisect(
   * This method calls the function spline_find_segment_linear() in order
   * to identify the spline segment at the given location. This is optimal
   * if sequential calls to this function involve incremental or decremental
-  * locations.
+  * locations. Outside the range of the spline knots, the spline's
+  * extrapolation type applies as described for spline_eval(), and the
+  * index will be set to the outer segment.
   */
 double spline_eval_linear(
   spline_t* spline,
@@ -598,4 +980,63 @@ double spline_eval_linear(
   double x,
   size_t* index);
 
+/** \brief Evaluate the spline at an array of locations
+  * \param[in] spline The cubic spline to be evaluated.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The locations at which to evaluate the cubic spline.
+  * \param[out] f_x The function values of the cubic spline at the given
+  *   locations. For locations at which the spline is undefined, the
+  *   function value will be NaN.
+  * \param[in] num_values The number of locations to be evaluated.
+  * \param[in,out] index The segment index at which to start searching for
+  *   the first location. On return, the index will be modified to indicate
+  *   the spline segment of the last defined location.
+  * \return The number of evaluated locations or the negative error code
+  *   if the spline is undefined at any of the locations.
+  * 
+  * For each location, this function first tests the segment of the
+  * previous location and its successor before resorting to bisection.
+  * Sorted locations are thus evaluated without searching, whereas the
+  * cost for unsorted locations is bounded by the cost of bisection.
+  * Outside the range of the spline knots, the spline's extrapolation type
+  * applies as described for spline_eval().
+  */
+ssize_t spline_eval_array(
+  spline_t* spline,
+  spline_eval_type_t eval_type,
+  const double* x,
+  double* f_x,
+  size_t num_values,
+  size_t* index);
+
+/** \brief Generate curvature-adaptive sampling locations of the spline
+  * \param[in] spline The cubic spline to be sampled.
+  * \param[in] eval_type The evaluation type the sampling locations shall
+  *   be generated for.
+  * \param[in] tolerance The maximum tolerated chord error, i.e., the
+  *   deviation of the piecewise linear interpolation of the samples from
+  *   the evaluated spline function. The tolerance must be positive.
+  * \param[in] max_step_size If positive, the maximum distance between
+  *   two consecutive sampling locations.
+  * \param[in,out] x The resulting sampling locations in increasing order.
+  *   The array will be re-allocated to accommodate the values and must be
+  *   freed by the caller.
+  * \return The number of sampling locations or the negative error code.
+  * 
+  * The chord error of a function with second derivative bounded by M
+  * over a step of size h is bounded by M*h^2/8. This function therefore
+  * subdivides each spline segment into equidistant steps, choosing the
+  * step size from the maximum magnitude of the second derivative of the
+  * evaluated function over the segment. Since this bound follows from the
+  * segment's polynomial coefficients, the locations are generated in a
+  * single pass over the segments. All spline knots are included in the
+  * resulting locations.
+  */
+ssize_t spline_sample_adaptive(
+  spline_t* spline,
+  spline_eval_type_t eval_type,
+  double tolerance,
+  double max_step_size,
+  double** x);
+
 #endif
@@ -0,0 +1,222 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <unistd.h>
+
+#include "stream.h"
+
+#include "file/file.h"
+#include "string/string.h"
+
+#define SPLINE_STREAM_LINE_FORMAT          "%24.16le %24.16le %24.16le\n"
+#define SPLINE_STREAM_LINE_LENGTH          75
+
+typedef struct spline_stream_record_t {
+  double x;
+  double y;
+  double g;
+  double z;
+} spline_stream_record_t;
+
+static ssize_t spline_stream_eliminate(file_t* input, file_t* spill, double
+    y2_0, double y2_n) {
+  spline_stream_record_t record;
+  spline_point_t points[3];
+  size_t num_points = 0;
+  double g = 0.0, z = y2_0;
+  int result = SPLINE_ERROR_NONE;
+  
+  char* line = 0;
+  while (!file_eof(input) && (file_read_line(input, &line, 128) >= 0)) {
+    if (string_empty(line) || string_starts_with(line, "#"))
+      continue;
+    
+    double x, y;
+    if (string_scanf(line, "%lg %lg", &x, &y) != 2) {
+      result = SPLINE_ERROR_FILE_FORMAT;
+      break;
+    }
+    if (num_points && !(x > points[2].x)) {
+      result = SPLINE_ERROR_INTERPOLATION;
+      break;
+    }
+    
+    points[0] = points[1];
+    points[1] = points[2];
+    spline_point_init(&points[2], x, y);
+    ++num_points;
+    
+    if (num_points == 1) {
+      record.x = points[2].x;
+      record.y = points[2].y;
+      record.g = g;
+      record.z = z;
+    }
+    else if (num_points > 2) {
+      double h_i = points[1].x-points[0].x;
+      double h_j = points[2].x-points[1].x;
+      double b_i = 6.0*((points[2].y-points[1].y)/h_j-
+        (points[1].y-points[0].y)/h_i);
+      double m = 2.0*(h_i+h_j)-h_i*g;
+      
+      if (m == 0.0) {
+        result = SPLINE_ERROR_INTERPOLATION;
+        break;
+      }
+      z = (b_i-h_i*z)/m;
+      g = h_j/m;
+      
+      record.x = points[1].x;
+      record.y = points[1].y;
+      record.g = g;
+      record.z = z;
+    }
+    else
+      continue;
+    
+    if (file_write(spill, (unsigned char*)&record, sizeof(record)) < 0) {
+      result = SPLINE_ERROR_FILE_WRITE;
+      break;
+    }
+  }
+  string_destroy(&line);
+  
+  if (!result && input->error.code)
+    result = SPLINE_ERROR_FILE_READ;
+  if (!result && (num_points < 3))
+    result = SPLINE_ERROR_INTERPOLATION;
+  
+  if (!result) {
+    record.x = points[2].x;
+    record.y = points[2].y;
+    record.g = 0.0;
+    record.z = y2_n;
+    
+    if (file_write(spill, (unsigned char*)&record, sizeof(record)) < 0)
+      result = SPLINE_ERROR_FILE_WRITE;
+  }
+  
+  return result ? -result : num_points;
+}
+
+static ssize_t spline_stream_substitute(file_t* spill, file_t* output,
+    size_t num_knots) {
+  spline_stream_record_t* records = malloc(SPLINE_STREAM_BLOCK_SIZE*
+    sizeof(spline_stream_record_t));
+  char* lines = malloc(SPLINE_STREAM_BLOCK_SIZE*SPLINE_STREAM_LINE_LENGTH+1);
+  size_t index_max = num_knots;
+  double y2 = 0.0;
+  int result = SPLINE_ERROR_NONE;
+  
+  while (index_max) {
+    size_t index_min = (index_max > SPLINE_STREAM_BLOCK_SIZE) ?
+      index_max-SPLINE_STREAM_BLOCK_SIZE : 0;
+    size_t num_records = index_max-index_min, i;
+    
+    if ((file_seek(spill, index_min*sizeof(spline_stream_record_t),
+          file_whence_start) < 0) ||
+        (file_read(spill, (unsigned char*)records,
+          num_records*sizeof(spline_stream_record_t)) !=
+          num_records*sizeof(spline_stream_record_t))) {
+      result = SPLINE_ERROR_FILE_READ;
+      break;
+    }
+    
+    for (i = num_records; i > 0; --i) {
+      y2 = records[i-1].z-records[i-1].g*y2;
+      records[i-1].z = y2;
+    }
+    for (i = 0; i < num_records; ++i)
+      snprintf(&lines[i*SPLINE_STREAM_LINE_LENGTH],
+        SPLINE_STREAM_LINE_LENGTH+1, SPLINE_STREAM_LINE_FORMAT,
+        records[i].x, records[i].y, records[i].z);
+    
+    if ((file_seek(output, index_min*SPLINE_STREAM_LINE_LENGTH,
+          file_whence_start) < 0) ||
+        (file_write(output, (unsigned char*)lines,
+          num_records*SPLINE_STREAM_LINE_LENGTH) < 0)) {
+      result = SPLINE_ERROR_FILE_WRITE;
+      break;
+    }
+    
+    index_max = index_min;
+  }
+  
+  free(records);
+  free(lines);
+  
+  return result ? -result : num_knots;
+}
+
+ssize_t spline_int_file_y2(const char* input, const char* output, double
+    y2_0, double y2_n) {
+  file_t input_file, output_file, spill_file;
+  char* spill_name = 0;
+  ssize_t result;
+  int fd;
+
+  file_init_name(&output_file, output);
+  if (string_equal(output, "-") ||
+      (output_file.compression != file_compression_none) ||
+      file_open(&output_file, file_mode_write)) {
+    file_destroy(&output_file);
+    return -SPLINE_ERROR_FILE_WRITE;
+  }
+  
+  string_printf(&spill_name, "%s/spline-XXXXXX", P_tmpdir);
+  if ((fd = mkstemp(spill_name)) < 0) {
+    string_destroy(&spill_name);
+    file_destroy(&output_file);
+    return -SPLINE_ERROR_FILE_WRITE;
+  }
+  close(fd);
+  
+  file_init(&spill_file, spill_name, file_compression_none);
+  file_init_name(&input_file, input);
+  if (string_equal(input, "-"))
+    file_open_stream(&input_file, stdin, file_mode_read);
+  else
+    file_open(&input_file, file_mode_read);
+  
+  if (input_file.error.code)
+    result = -SPLINE_ERROR_FILE_READ;
+  else if (file_open(&spill_file, file_mode_write))
+    result = -SPLINE_ERROR_FILE_WRITE;
+  else if ((result = spline_stream_eliminate(&input_file, &spill_file,
+      y2_0, y2_n)) > 0) {
+    if (file_open(&spill_file, file_mode_read))
+      result = -SPLINE_ERROR_FILE_READ;
+    else
+      result = spline_stream_substitute(&spill_file, &output_file, result);
+  }
+  
+  file_destroy(&input_file);
+  file_destroy(&spill_file);
+  file_destroy(&output_file);
+  
+  unlink(spill_name);
+  string_destroy(&spill_name);
+  
+  return result;
+}
+
+ssize_t spline_int_file_natural(const char* input, const char* output) {
+  return spline_int_file_y2(input, output, 0.0, 0.0);
+}
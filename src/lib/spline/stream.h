@@ -0,0 +1,95 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_STREAM_H
+#define SPLINE_STREAM_H
+
+/** \file spline/stream.h
+  * \ingroup spline
+  * \brief Out-of-core cubic spline interpolation
+  * \author Ralf Kaestner
+  * 
+  * Out-of-core spline interpolation generates a cubic spline from a file
+  * of data points without ever holding the data points, the tridiagonal
+  * system, or the spline knots in memory. The data points are streamed
+  * from the input file during the forward elimination of the tridiagonal
+  * system, whose coefficients are spilled to a temporary file. Back
+  * substitution then reads the temporary file in reverse order and writes
+  * the resulting spline knots to the output file. Peak memory consumption
+  * is therefore bounded by SPLINE_STREAM_BLOCK_SIZE, independently of the
+  * number of data points.
+  */
+
+#include <stdlib.h>
+
+#include "spline/spline.h"
+
+/** \name Constants
+  * \brief Predefined out-of-core spline interpolation constants
+  */
+//@{
+#define SPLINE_STREAM_BLOCK_SIZE           4096
+//!< The number of knots processed per block during back substitution
+//@}
+
+/** \brief Out-of-core cubic spline interpolation with known second
+  *   derivatives at the boundaries
+  * \param[in] input The name of the file containing the data points, one
+  *   point per line. The special filename '-' indicates that the data points
+  *   shall be read from stdin. Empty lines and lines starting with '#' will
+  *   be ignored.
+  * \param[in] output The name of the file the resulting spline will be
+  *   written to. Since the spline knots are generated in reverse order,
+  *   the output file must be seekable and can thus neither be stdout nor
+  *   a compressed file.
+  * \param[in] y2_0 The second derivative at the first data point.
+  * \param[in] y2_n The second derivative at the last data point.
+  * \return The number of spline knots written to the output file or the
+  *   negative error code.
+  * 
+  * The resulting spline is identical to the one generated by
+  * spline_int_y2() and may be read by spline_read(). The data points must
+  * be ordered by strictly increasing x-components. Knots are written at a
+  * fixed line width, such that the output file can be filled in reverse
+  * order during back substitution. The temporary file will be created in
+  * the system's default directory for temporary files and requires 32
+  * bytes per data point.
+  */
+ssize_t spline_int_file_y2(
+  const char* input,
+  const char* output,
+  double y2_0,
+  double y2_n);
+
+/** \brief Out-of-core natural cubic spline interpolation
+  * \param[in] input The name of the file containing the data points.
+  * \param[in] output The name of the file the resulting spline will be
+  *   written to.
+  * \return The number of spline knots written to the output file or the
+  *   negative error code.
+  * 
+  * This is a convenience function which calls spline_int_file_y2() with
+  * zero second derivatives at the boundaries.
+  */
+ssize_t spline_int_file_natural(
+  const char* input,
+  const char* output);
+
+#endif
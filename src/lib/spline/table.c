@@ -0,0 +1,389 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include "table.h"
+
+#include "spline/segment.h"
+
+#include "string/string.h"
+
+#include "file/file.h"
+
+#define sqr(a) ((a)*(a))
+
+const char* spline_table_errors[] = {
+  "Success",
+  "Invalid spline",
+  "Spline lookup table tolerance not attainable",
+  "Failed to read spline lookup table from file",
+  "Invalid spline lookup table file format",
+  "Failed to write spline lookup table to file",
+};
+
+const char* spline_table_types[] = {
+  "linear",
+  "cubic",
+};
+
+void spline_table_init(spline_table_t* table) {
+  table->type = spline_table_type_linear;
+
+  table->x_min = 0.0;
+  table->x_max = 0.0;
+  table->scale = 0.0;
+
+  table->coefficients = 0;
+  table->num_cells = 0;
+
+  table->error_bound = 0.0;
+
+  error_init(&table->error, spline_table_errors);
+}
+
+void spline_table_destroy(spline_table_t* table) {
+  spline_table_clear(table);
+
+  error_destroy(&table->error);
+}
+
+void spline_table_clear(spline_table_t* table) {
+  if (table->num_cells) {
+    free(table->coefficients);
+
+    table->coefficients = 0;
+    table->num_cells = 0;
+  }
+
+  table->x_min = 0.0;
+  table->x_max = 0.0;
+  table->scale = 0.0;
+  table->error_bound = 0.0;
+
+  error_clear(&table->error);
+}
+
+size_t spline_table_get_num_coefficients(spline_table_type_t type) {
+  return (type == spline_table_type_linear) ? 2 : 4;
+}
+
+static double spline_table_max_deviation(const double* r, double t_min,
+    double t_max) {
+  double t[4] = {t_min, t_max, t_min, t_min};
+  double a = 3.0*r[3], b = 2.0*r[2], c = r[1];
+  double max_deviation = 0.0;
+  size_t i;
+
+  if (a != 0.0) {
+    double discriminant = sqr(b)-4.0*a*c;
+
+    if (discriminant >= 0.0) {
+      double q = -0.5*(b+copysign(sqrt(discriminant), b));
+
+      t[2] = q/a;
+      if (q != 0.0)
+        t[3] = c/q;
+    }
+  }
+  else if (b != 0.0)
+    t[2] = -c/b;
+
+  for (i = 0; i < 4; ++i) {
+    if ((t[i] >= t_min) && (t[i] <= t_max)) {
+      double deviation = fabs(r[0]+t[i]*(r[1]+t[i]*(r[2]+t[i]*r[3])));
+
+      if (deviation > max_deviation)
+        max_deviation = deviation;
+    }
+  }
+
+  return max_deviation;
+}
+
+static double spline_table_fill(spline_table_t* table, spline_t* spline) {
+  size_t num_coefficients = spline_table_get_num_coefficients(table->type);
+  double h = (table->x_max-table->x_min)/table->num_cells;
+  double max_deviation = 0.0;
+  spline_segment_t segment;
+  size_t i, j = 0;
+
+  spline_get_segment(spline, 0, &segment);
+  double f_a = spline_segment_eval(&segment,
+    spline_eval_type_base_function, table->x_min);
+  double f1_a = spline_segment_eval(&segment,
+    spline_eval_type_first_derivative, table->x_min);
+
+  for (i = 0; i < table->num_cells; ++i) {
+    double x_a = table->x_min+i*h;
+    double x_b = (i+1 < table->num_cells) ? table->x_min+(i+1)*h :
+      table->x_max;
+    double* c = &table->coefficients[i*num_coefficients];
+    double p[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t j_b = j, k;
+
+    while ((j_b+2 < spline->num_knots) && (spline->knots[j_b+1].x < x_b))
+      ++j_b;
+
+    spline_get_segment(spline, j_b, &segment);
+    double f_b = spline_segment_eval(&segment,
+      spline_eval_type_base_function, x_b);
+    double f1_b = spline_segment_eval(&segment,
+      spline_eval_type_first_derivative, x_b);
+
+    if (table->type == spline_table_type_linear) {
+      c[0] = f_a;
+      c[1] = f_b-f_a;
+    }
+    else {
+      c[0] = f_a;
+      c[1] = h*f1_a;
+      c[2] = 3.0*(f_b-f_a)-h*(2.0*f1_a+f1_b);
+      c[3] = 2.0*(f_a-f_b)+h*(f1_a+f1_b);
+    }
+
+    for (k = 0; k < num_coefficients; ++k)
+      p[k] = c[k]/pow(h, k);
+
+    for (k = j; k <= j_b; ++k) {
+      double t_min = fmax(spline->knots[k].x, x_a)-x_a;
+      double t_max = fmin(spline->knots[k+1].x, x_b)-x_a;
+      double r[4];
+
+      spline_get_segment(spline, k, &segment);
+      double d = x_a-segment.x_0;
+
+      r[3] = p[3]-segment.a;
+      r[2] = p[2]-(3.0*segment.a*d+segment.b);
+      r[1] = p[1]-((3.0*segment.a*d+2.0*segment.b)*d+segment.c);
+      r[0] = p[0]-(((segment.a*d+segment.b)*d+segment.c)*d+segment.d);
+
+      double deviation = spline_table_max_deviation(r, t_min, t_max);
+      if (deviation > max_deviation)
+        max_deviation = deviation;
+    }
+
+    j = j_b;
+    f_a = f_b;
+    f1_a = f1_b;
+  }
+
+  return max_deviation;
+}
+
+ssize_t spline_table_compile(spline_table_t* table, spline_t* spline,
+    spline_table_type_t type, double tolerance) {
+  spline_table_clear(table);
+
+  if ((spline->num_knots < 2) || !(tolerance > 0.0)) {
+    error_set(&table->error, SPLINE_TABLE_ERROR_SPLINE);
+    return -table->error.code;
+  }
+
+  size_t num_coefficients = spline_table_get_num_coefficients(type);
+  size_t num_cells = spline_get_num_segments(spline);
+  double length = spline->knots[spline->num_knots-1].x-spline->knots[0].x;
+
+  if (type == spline_table_type_linear) {
+    spline_segment_t segment;
+    double y2_max = 0.0;
+    size_t i;
+
+    for (i = 0; i < spline_get_num_segments(spline); ++i) {
+      spline_get_segment(spline, i, &segment);
+      double h = spline->knots[i+1].x-spline->knots[i].x;
+
+      y2_max = fmax(y2_max, fabs(2.0*segment.b));
+      y2_max = fmax(y2_max, fabs(6.0*segment.a*h+2.0*segment.b));
+    }
+
+    num_cells = fmin(ceil(length*sqrt(y2_max/(8.0*tolerance))),
+      SPLINE_TABLE_MAX_NUM_CELLS+1.0);
+  }
+
+  table->type = type;
+  table->x_min = spline->knots[0].x;
+  table->x_max = spline->knots[spline->num_knots-1].x;
+
+  if (!num_cells)
+    num_cells = 1;
+
+  while (num_cells <= SPLINE_TABLE_MAX_NUM_CELLS) {
+    table->coefficients = realloc(table->coefficients,
+      num_cells*num_coefficients*sizeof(double));
+    table->num_cells = num_cells;
+    table->scale = num_cells/length;
+
+    table->error_bound = spline_table_fill(table, spline);
+    if (table->error_bound <= tolerance)
+      return table->num_cells;
+
+    double ratio = pow(table->error_bound/tolerance,
+      (type == spline_table_type_linear) ? 1.0/2.0 : 1.0/3.0);
+    size_t num_cells_min = num_cells+1;
+
+    num_cells = fmin(ceil(1.05*ratio*num_cells),
+      SPLINE_TABLE_MAX_NUM_CELLS+1.0);
+    if (num_cells < num_cells_min)
+      num_cells = num_cells_min;
+  }
+
+  spline_table_clear(table);
+  error_setf(&table->error, SPLINE_TABLE_ERROR_TOLERANCE, "%lg", tolerance);
+
+  return -table->error.code;
+}
+
+ssize_t spline_table_read(const char* filename, spline_table_t* table) {
+  file_t file;
+  size_t num_coefficients = 0, num_cells = 0, i = 0;
+
+  spline_table_clear(table);
+
+  file_init_name(&file, filename);
+  if (string_equal(filename, "-"))
+    file_open_stream(&file, stdin, file_mode_read);
+  else
+    file_open(&file, file_mode_read);
+
+  if (!file.handle) {
+    error_blame(&table->error, &file.error, SPLINE_TABLE_ERROR_FILE_READ);
+    file_destroy(&file);
+
+    return -error_get(&table->error);
+  }
+
+  char* line = 0;
+  while (!file_eof(&file) && (file_read_line(&file, &line, 128) >= 0)) {
+    if (string_empty(line) || string_starts_with(line, "#"))
+      continue;
+
+    if (!num_coefficients) {
+      char type[16];
+      unsigned long cells;
+
+      if ((string_scanf(line, "%15s %lg %lg %lu %lg", type, &table->x_min,
+          &table->x_max, &cells, &table->error_bound) != 5) || !cells ||
+          (cells > SPLINE_TABLE_MAX_NUM_CELLS) ||
+          !(table->x_max > table->x_min)) {
+        error_setf(&table->error, SPLINE_TABLE_ERROR_FILE_FORMAT, "%s",
+          line);
+        break;
+      }
+
+      if (string_equal(type, spline_table_types[spline_table_type_linear]))
+        table->type = spline_table_type_linear;
+      else if (string_equal(type,
+          spline_table_types[spline_table_type_cubic]))
+        table->type = spline_table_type_cubic;
+      else {
+        error_setf(&table->error, SPLINE_TABLE_ERROR_FILE_FORMAT, "%s",
+          line);
+        break;
+      }
+
+      num_cells = cells;
+      num_coefficients = spline_table_get_num_coefficients(table->type);
+      table->coefficients = malloc(num_cells*num_coefficients*
+        sizeof(double));
+      if (!table->coefficients) {
+        error_setf(&table->error, SPLINE_TABLE_ERROR_FILE_READ, "%s",
+          filename);
+        break;
+      }
+      table->num_cells = num_cells;
+      table->scale = num_cells/(table->x_max-table->x_min);
+    }
+    else if (i < num_cells) {
+      double c[4];
+
+      if (string_scanf(line, "%lg %lg %lg %lg", &c[0], &c[1], &c[2],
+          &c[3]) != num_coefficients) {
+        error_setf(&table->error, SPLINE_TABLE_ERROR_FILE_FORMAT, "%s",
+          line);
+        break;
+      }
+      memcpy(&table->coefficients[i*num_coefficients], c,
+        num_coefficients*sizeof(double));
+      ++i;
+    }
+  }
+  string_destroy(&line);
+
+  if (!table->error.code && (!num_cells || (i < num_cells)))
+    error_setf(&table->error, SPLINE_TABLE_ERROR_FILE_FORMAT, "%s",
+      filename);
+  if (file.error.code)
+    error_blame(&table->error, &file.error, SPLINE_TABLE_ERROR_FILE_READ);
+  file_destroy(&file);
+
+  if (table->error.code) {
+    int code = table->error.code;
+
+    if (table->num_cells) {
+      free(table->coefficients);
+
+      table->coefficients = 0;
+      table->num_cells = 0;
+    }
+
+    return -code;
+  }
+  else
+    return table->num_cells;
+}
+
+ssize_t spline_table_write(const char* filename, spline_table_t* table) {
+  size_t num_coefficients = spline_table_get_num_coefficients(table->type);
+  file_t file;
+
+  error_clear(&table->error);
+
+  file_init_name(&file, filename);
+  if (string_equal(filename, "-"))
+    file_open_stream(&file, stdout, file_mode_write);
+  else
+    file_open(&file, file_mode_write);
+
+  if (file_printf(&file, "%s %.17lg %.17lg %lu %.17lg\n",
+      spline_table_types[table->type],
+      table->x_min,
+      table->x_max,
+      (unsigned long)table->num_cells,
+      table->error_bound) >= 0) {
+    size_t i, j;
+
+    for (i = 0; i < table->num_cells; ++i) {
+      const double* c = &table->coefficients[i*num_coefficients];
+
+      for (j = 0; j < num_coefficients; ++j)
+        if (file_printf(&file, j ? " %.17lg" : "%.17lg", c[j]) < 0)
+          break;
+      if ((j < num_coefficients) || (file_printf(&file, "\n") < 0))
+        break;
+    }
+  }
+
+  if (file.error.code)
+    error_blame(&table->error, &file.error, SPLINE_TABLE_ERROR_FILE_WRITE);
+  file_destroy(&file);
+
+  return table->error.code ? -table->error.code : table->num_cells;
+}
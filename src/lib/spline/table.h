@@ -0,0 +1,205 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_TABLE_H
+#define SPLINE_TABLE_H
+
+/** \file spline/table.h
+  * \ingroup spline
+  * \brief Uniform lookup table compiled from a cubic spline
+  * \author Ralf Kaestner
+  *
+  * A spline lookup table samples the base function of a cubic spline on
+  * a uniform grid of cells, each of which holds a linear or cubic
+  * polynomial. Since the cell of a location follows from a single
+  * multiplication, table lookups require constant time independent of
+  * the distribution of the spline knots. The number of cells is chosen
+  * such as to keep the maximum deviation from the spline below a given
+  * tolerance.
+  */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "spline/spline.h"
+
+#include "error/error.h"
+
+/** \name Constants
+  * \brief Predefined spline lookup table constants
+  */
+//@{
+#define SPLINE_TABLE_MAX_NUM_CELLS         (1 << 24)
+//!< The maximum number of cells of a spline lookup table
+//@}
+
+/** \name Error Codes
+  * \brief Predefined spline lookup table error codes
+  */
+//@{
+#define SPLINE_TABLE_ERROR_NONE            0
+//!< Success
+#define SPLINE_TABLE_ERROR_SPLINE          1
+//!< Invalid spline
+#define SPLINE_TABLE_ERROR_TOLERANCE       2
+//!< Tolerance not attainable
+#define SPLINE_TABLE_ERROR_FILE_READ       3
+//!< Error reading spline lookup table from file
+#define SPLINE_TABLE_ERROR_FILE_FORMAT     4
+//!< Invalid spline lookup table file format
+#define SPLINE_TABLE_ERROR_FILE_WRITE      5
+//!< Error writing spline lookup table to file
+//@}
+
+/** \brief Predefined spline lookup table error descriptions
+  */
+extern const char* spline_table_errors[];
+
+/** \brief Spline lookup table type
+  */
+typedef enum {
+  spline_table_type_linear,       //!< Linear polynomial per cell.
+  spline_table_type_cubic,        //!< Cubic Hermite polynomial per cell.
+} spline_table_type_t;
+
+/** \brief Predefined spline lookup table type strings
+  */
+extern const char* spline_table_types[];
+
+/** \brief Structure defining the spline lookup table
+  *
+  * Each cell stores the coefficients of its polynomial with respect to
+  * the normalized cell coordinate u in [0, 1], starting with the constant
+  * coefficient.
+  */
+typedef struct spline_table_t {
+  spline_table_type_t type;   //!< The type of the lookup table.
+
+  double x_min;               //!< The lower bound of the table range.
+  double x_max;               //!< The upper bound of the table range.
+  double scale;               //!< The number of cells per unit length.
+
+  double* coefficients;       //!< The polynomial coefficients of the cells.
+  size_t num_cells;           //!< The number of cells.
+
+  double error_bound;         //!< The maximum deviation from the spline.
+
+  error_t error;              //!< The most recent lookup table error.
+} spline_table_t;
+
+/** \brief Initialize an empty spline lookup table
+  * \param[in] table The spline lookup table to be initialized.
+  */
+void spline_table_init(
+  spline_table_t* table);
+
+/** \brief Destroy a spline lookup table
+  * \param[in] table The spline lookup table to be destroyed.
+  */
+void spline_table_destroy(
+  spline_table_t* table);
+
+/** \brief Clear a spline lookup table
+  * \param[in] table The spline lookup table to be cleared.
+  */
+void spline_table_clear(
+  spline_table_t* table);
+
+/** \brief Retrieve the number of coefficients per cell
+  * \param[in] type The spline lookup table type to retrieve the number of
+  *   coefficients per cell for.
+  * \return The number of polynomial coefficients per table cell.
+  */
+size_t spline_table_get_num_coefficients(
+  spline_table_type_t type);
+
+/** \brief Compile a spline lookup table from a cubic spline
+  * \param[in,out] table The spline lookup table to be compiled.
+  * \param[in] spline The cubic spline to be compiled into the lookup table.
+  * \param[in] type The type of the lookup table.
+  * \param[in] tolerance The maximum tolerated deviation of the lookup table
+  *   from the base function of the cubic spline.
+  * \return The number of table cells or the negative error code.
+  *
+  * The lookup table covers the range between the first and the last knot
+  * of the spline. For each cell, the deviation from the spline is computed
+  * exactly by locating the extrema of the cubic difference polynomials
+  * over the spline segments overlapping with the cell. The number of cells
+  * will be increased until the maximum deviation falls below the tolerance,
+  * failing if this requires more than SPLINE_TABLE_MAX_NUM_CELLS cells.
+  */
+ssize_t spline_table_compile(
+  spline_table_t* table,
+  spline_t* spline,
+  spline_table_type_t type,
+  double tolerance);
+
+/** \brief Read spline lookup table from file
+  * \param[in] filename The name of the file containing the lookup table.
+  *   The special filename '-' indicates that the lookup table shall be
+  *   read from stdin.
+  * \param[in,out] table The read spline lookup table.
+  * \return The number of table cells read from the file or the negative
+  *   error code.
+  */
+ssize_t spline_table_read(
+  const char* filename,
+  spline_table_t* table);
+
+/** \brief Write spline lookup table to file
+  * \param[in] filename The name of the file the lookup table will be
+  *   written to. The special filename '-' indicates that the lookup table
+  *   shall be written to stdout.
+  * \param[in] table The spline lookup table to be written.
+  * \return The number of table cells written to the file or the negative
+  *   error code.
+  */
+ssize_t spline_table_write(
+  const char* filename,
+  spline_table_t* table);
+
+/** \brief Evaluate the spline lookup table at a given location
+  * \param[in] table The compiled spline lookup table to be evaluated.
+  * \param[in] x The location at which to evaluate the lookup table.
+  * \return The value of the lookup table at the given location.
+  *
+  * Locations outside the table range are clamped to the range. The
+  * evaluation does not involve any data-dependent branches.
+  */
+static inline double spline_table_eval(
+  const spline_table_t* table,
+  double x) {
+  double u = fmin(fmax((x-table->x_min)*table->scale, 0.0),
+    table->num_cells);
+  size_t i = fmin(u, table->num_cells-1);
+  u -= i;
+
+  if (table->type == spline_table_type_linear) {
+    const double* a = &table->coefficients[2*i];
+    return a[0]+u*a[1];
+  }
+  else {
+    const double* a = &table->coefficients[4*i];
+    return a[0]+u*(a[1]+u*(a[2]+u*a[3]));
+  }
+}
+
+#endif
@@ -0,0 +1,347 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <math.h>
+
+#include "trajectory.h"
+
+#include "spline/spline.h"
+#include "spline/tridiag.h"
+
+#define SPLINE_TRAJECTORY_DIFFERENCE_STEP 1e-5
+
+const char* spline_trajectory_errors[] = {
+  "Success",
+  "Invalid trajectory samples",
+  "Trajectory interpolation failed",
+  "Trajectory undefined at time",
+};
+
+void spline_trajectory_init(spline_trajectory_t* trajectory) {
+  trajectory->t = 0;
+  trajectory->num_knots = 0;
+
+  trajectory->positions = 0;
+  trajectory->accelerations = 0;
+  trajectory->rotations = 0;
+  trajectory->controls = 0;
+
+  error_init(&trajectory->error, spline_trajectory_errors);
+}
+
+void spline_trajectory_destroy(spline_trajectory_t* trajectory) {
+  spline_trajectory_clear(trajectory);
+
+  error_destroy(&trajectory->error);
+}
+
+void spline_trajectory_clear(spline_trajectory_t* trajectory) {
+  if (trajectory->num_knots) {
+    free(trajectory->t);
+    free(trajectory->positions);
+    free(trajectory->accelerations);
+    free(trajectory->rotations);
+    free(trajectory->controls);
+
+    trajectory->t = 0;
+    trajectory->positions = 0;
+    trajectory->accelerations = 0;
+    trajectory->rotations = 0;
+    trajectory->controls = 0;
+
+    trajectory->num_knots = 0;
+  }
+
+  error_clear(&trajectory->error);
+}
+
+static void spline_trajectory_quaternion_log(const transform_quaternion_t*
+    quaternion, transform_point_t* v) {
+  double s = sqrt(quaternion->x*quaternion->x+quaternion->y*quaternion->y+
+    quaternion->z*quaternion->z);
+  double k = (s > 0.0) ? atan2(s, quaternion->w)/s : 1.0;
+
+  transform_point_init(v, k*quaternion->x, k*quaternion->y,
+    k*quaternion->z);
+}
+
+static void spline_trajectory_quaternion_exp(const transform_point_t* v,
+    transform_quaternion_t* quaternion) {
+  double theta = sqrt(v->x*v->x+v->y*v->y+v->z*v->z);
+  double k = (theta > 0.0) ? sin(theta)/theta : 1.0;
+
+  transform_quaternion_init(quaternion, cos(theta), k*v->x, k*v->y,
+    k*v->z);
+}
+
+static void spline_trajectory_get_control(spline_trajectory_t* trajectory,
+    size_t i) {
+  transform_quaternion_t q_inv, q_prev, q_next;
+  transform_point_t v_prev, v_next, v;
+
+  transform_quaternion_copy(&q_inv, &trajectory->rotations[i]);
+  transform_quaternion_invert(&q_inv);
+
+  transform_quaternion_copy(&q_prev, &trajectory->rotations[i-1]);
+  transform_quaternion_multiply_left(&q_prev, &q_inv);
+  transform_quaternion_copy(&q_next, &trajectory->rotations[i+1]);
+  transform_quaternion_multiply_left(&q_next, &q_inv);
+
+  spline_trajectory_quaternion_log(&q_prev, &v_prev);
+  spline_trajectory_quaternion_log(&q_next, &v_next);
+  transform_point_init(&v, -0.25*(v_prev.x+v_next.x),
+    -0.25*(v_prev.y+v_next.y), -0.25*(v_prev.z+v_next.z));
+
+  spline_trajectory_quaternion_exp(&v, &trajectory->controls[i]);
+  transform_quaternion_multiply_left(&trajectory->controls[i],
+    &trajectory->rotations[i]);
+}
+
+ssize_t spline_trajectory_fit(spline_trajectory_t* trajectory, const
+    double* timestamps, const transform_pose_t* poses, size_t num_poses) {
+  size_t n = num_poses, i;
+
+  spline_trajectory_clear(trajectory);
+
+  if (n < 2) {
+    error_set(&trajectory->error, SPLINE_TRAJECTORY_ERROR_SAMPLES);
+    return -trajectory->error.code;
+  }
+  for (i = 1; i < n; ++i) {
+    if (!(timestamps[i] > timestamps[i-1])) {
+      error_setf(&trajectory->error, SPLINE_TRAJECTORY_ERROR_SAMPLES,
+        "%lg", timestamps[i]);
+      return -trajectory->error.code;
+    }
+  }
+
+  trajectory->t = malloc(n*sizeof(double));
+  trajectory->positions = malloc(n*sizeof(transform_point_t));
+  trajectory->accelerations = malloc(n*sizeof(transform_point_t));
+  trajectory->rotations = malloc(n*sizeof(transform_quaternion_t));
+  trajectory->controls = malloc(n*sizeof(transform_quaternion_t));
+  trajectory->num_knots = n;
+
+  for (i = 0; i < n; ++i) {
+    trajectory->t[i] = timestamps[i];
+    transform_point_init(&trajectory->positions[i], poses[i].x, poses[i].y,
+      poses[i].z);
+    transform_point_init(&trajectory->accelerations[i], 0.0, 0.0, 0.0);
+    transform_quaternion_init_rotation(&trajectory->rotations[i],
+      poses[i].yaw, poses[i].pitch, poses[i].roll);
+
+    if (i > 0) {
+      transform_quaternion_t* q = &trajectory->rotations[i];
+      const transform_quaternion_t* p = &trajectory->rotations[i-1];
+
+      if (q->w*p->w+q->x*p->x+q->y*p->y+q->z*p->z < 0.0)
+        transform_quaternion_init(q, -q->w, -q->x, -q->y, -q->z);
+    }
+  }
+
+  if (n > 2) {
+    size_t m = n-2, k;
+    double* d = malloc(m*sizeof(double));
+    double* e = malloc(m*sizeof(double));
+    double* b = malloc(3*m*sizeof(double));
+    double* y2 = malloc(3*m*sizeof(double));
+    const transform_point_t* p = trajectory->positions;
+    const double* t = trajectory->t;
+    int result = SPLINE_ERROR_NONE;
+
+    for (k = 0; k < m; ++k) {
+      double h_0 = t[k+1]-t[k], h_1 = t[k+2]-t[k+1];
+
+      d[k] = 2.0*(h_0+h_1);
+      e[k] = h_1;
+
+      b[k] = 6.0*((p[k+2].x-p[k+1].x)/h_1-(p[k+1].x-p[k].x)/h_0);
+      b[m+k] = 6.0*((p[k+2].y-p[k+1].y)/h_1-(p[k+1].y-p[k].y)/h_0);
+      b[2*m+k] = 6.0*((p[k+2].z-p[k+1].z)/h_1-(p[k+1].z-p[k].z)/h_0);
+    }
+
+    for (i = 0; (i < 3) && !result; ++i)
+      result = spline_tridiag_solve(d, e, e, &b[i*m], &y2[i*m], m);
+
+    for (k = 0; k < m; ++k)
+      transform_point_init(&trajectory->accelerations[k+1], y2[k],
+        y2[m+k], y2[2*m+k]);
+
+    free(d);
+    free(e);
+    free(b);
+    free(y2);
+
+    if (result) {
+      spline_trajectory_clear(trajectory);
+      error_set(&trajectory->error, SPLINE_TRAJECTORY_ERROR_INTERPOLATION);
+      return -trajectory->error.code;
+    }
+  }
+
+  transform_quaternion_copy(&trajectory->controls[0],
+    &trajectory->rotations[0]);
+  for (i = 1; i+1 < n; ++i)
+    spline_trajectory_get_control(trajectory, i);
+  transform_quaternion_copy(&trajectory->controls[n-1],
+    &trajectory->rotations[n-1]);
+
+  return n;
+}
+
+ssize_t spline_trajectory_find_segment(spline_trajectory_t* trajectory,
+    double t, size_t* index) {
+  const double* t_k = trajectory->t;
+  size_t n = trajectory->num_knots, j = *index;
+
+  if ((n < 2) || !(t >= t_k[0]) || !(t <= t_k[n-1]))
+    return -SPLINE_TRAJECTORY_ERROR_UNDEFINED;
+
+  if ((j+1 < n) && (t >= t_k[j]) && (t <= t_k[j+1]))
+    return j;
+  else if ((j+2 < n) && (t > t_k[j+1]) && (t <= t_k[j+2]))
+    return ++(*index);
+  else {
+    size_t j_min = 0, j_max = n-1;
+
+    while (j_max-j_min > 1) {
+      size_t j_mid = (j_min+j_max)/2;
+
+      if (t_k[j_mid] > t)
+        j_max = j_mid;
+      else
+        j_min = j_mid;
+    }
+
+    return *index = j_min;
+  }
+}
+
+static void spline_trajectory_eval_rotation(spline_trajectory_t*
+    trajectory, size_t i, double u, transform_quaternion_t* quaternion) {
+  transform_quaternion_t a, b;
+
+  transform_quaternion_slerp(&trajectory->rotations[i],
+    &trajectory->rotations[i+1], u, &a);
+  transform_quaternion_slerp(&trajectory->controls[i],
+    &trajectory->controls[i+1], u, &b);
+  transform_quaternion_slerp(&a, &b, 2.0*u*(1.0-u), quaternion);
+}
+
+ssize_t spline_trajectory_eval(spline_trajectory_t* trajectory, const
+    double* t, transform_t* transforms, size_t num_values, size_t* index) {
+  size_t num_undefined = 0, i, j, k;
+  double t_undefined = 0.0;
+  ssize_t s;
+
+  for (i = 0; i < num_values; ++i) {
+    if ((s = spline_trajectory_find_segment(trajectory, t[i], index)) >= 0) {
+      const transform_point_t* p = trajectory->positions;
+      const transform_point_t* p2 = trajectory->accelerations;
+      double h = trajectory->t[s+1]-trajectory->t[s];
+      double b = (t[i]-trajectory->t[s])/h, a = 1.0-b;
+      double c_a = (a*a*a-a)*h*h/6.0, c_b = (b*b*b-b)*h*h/6.0;
+      transform_quaternion_t q;
+
+      spline_trajectory_eval_rotation(trajectory, s, b, &q);
+      transform_quaternion_to_transform(&q, transforms[i]);
+
+      transforms[i][0][3] = a*p[s].x+b*p[s+1].x+c_a*p2[s].x+c_b*p2[s+1].x;
+      transforms[i][1][3] = a*p[s].y+b*p[s+1].y+c_a*p2[s].y+c_b*p2[s+1].y;
+      transforms[i][2][3] = a*p[s].z+b*p[s+1].z+c_a*p2[s].z+c_b*p2[s+1].z;
+    }
+    else {
+      if (!num_undefined++)
+        t_undefined = t[i];
+
+      for (j = 0; j < 4; ++j)
+        for (k = 0; k < 4; ++k)
+          transforms[i][j][k] = NAN;
+    }
+  }
+
+  if (num_undefined)
+    error_setf(&trajectory->error, SPLINE_TRAJECTORY_ERROR_UNDEFINED,
+      "%lg", t_undefined);
+  else
+    error_clear(&trajectory->error);
+
+  return trajectory->error.code ? -trajectory->error.code : num_values;
+}
+
+ssize_t spline_trajectory_eval_velocity(spline_trajectory_t* trajectory,
+    const double* t, transform_point_t* linear, transform_point_t* angular,
+    size_t num_values, size_t* index) {
+  size_t num_undefined = 0, i;
+  double t_undefined = 0.0;
+  ssize_t s;
+
+  for (i = 0; i < num_values; ++i) {
+    if ((s = spline_trajectory_find_segment(trajectory, t[i], index)) >= 0) {
+      double h = trajectory->t[s+1]-trajectory->t[s];
+      double b = (t[i]-trajectory->t[s])/h, a = 1.0-b;
+
+      if (linear) {
+        const transform_point_t* p = trajectory->positions;
+        const transform_point_t* p2 = trajectory->accelerations;
+        double c_a = -(3.0*a*a-1.0)*h/6.0, c_b = (3.0*b*b-1.0)*h/6.0;
+
+        linear[i].x = (p[s+1].x-p[s].x)/h+c_a*p2[s].x+c_b*p2[s+1].x;
+        linear[i].y = (p[s+1].y-p[s].y)/h+c_a*p2[s].y+c_b*p2[s+1].y;
+        linear[i].z = (p[s+1].z-p[s].z)/h+c_a*p2[s].z+c_b*p2[s+1].z;
+      }
+
+      if (angular) {
+        double u_0 = fmax(b-SPLINE_TRAJECTORY_DIFFERENCE_STEP, 0.0);
+        double u_1 = fmin(b+SPLINE_TRAJECTORY_DIFFERENCE_STEP, 1.0);
+        double dt = (u_1-u_0)*h;
+        transform_quaternion_t q, q_0, q_1, w;
+
+        spline_trajectory_eval_rotation(trajectory, s, b, &q);
+        spline_trajectory_eval_rotation(trajectory, s, u_0, &q_0);
+        spline_trajectory_eval_rotation(trajectory, s, u_1, &q_1);
+
+        transform_quaternion_init(&w, 2.0*(q_1.w-q_0.w)/dt,
+          2.0*(q_1.x-q_0.x)/dt, 2.0*(q_1.y-q_0.y)/dt, 2.0*(q_1.z-q_0.z)/dt);
+        transform_quaternion_invert(&q);
+        transform_quaternion_multiply_left(&q, &w);
+
+        transform_point_init(&angular[i], q.x, q.y, q.z);
+      }
+    }
+    else {
+      if (!num_undefined++)
+        t_undefined = t[i];
+
+      if (linear)
+        transform_point_init(&linear[i], NAN, NAN, NAN);
+      if (angular)
+        transform_point_init(&angular[i], NAN, NAN, NAN);
+    }
+  }
+
+  if (num_undefined)
+    error_setf(&trajectory->error, SPLINE_TRAJECTORY_ERROR_UNDEFINED,
+      "%lg", t_undefined);
+  else
+    error_clear(&trajectory->error);
+
+  return trajectory->error.code ? -trajectory->error.code : num_values;
+}
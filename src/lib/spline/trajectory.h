@@ -0,0 +1,179 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_TRAJECTORY_H
+#define SPLINE_TRAJECTORY_H
+
+/** \file spline/trajectory.h
+  * \ingroup spline
+  * \brief Time-parameterized 6-DoF pose trajectories
+  * \author Ralf Kaestner
+  *
+  * A spline trajectory interpolates timestamped poses by a continuous
+  * function of time. Positions are interpolated by natural cubic splines,
+  * whereas orientations are interpolated by spherical quadrangle (squad)
+  * interpolation of unit quaternions, which is tangent-continuous at the
+  * samples for uniform timestamps. Both share a single vector of time
+  * knots, such that a single segment search serves all components of a
+  * query.
+  */
+
+#include <stdlib.h>
+
+#include "transform/transform.h"
+#include "transform/quaternion.h"
+
+#include "error/error.h"
+
+/** \name Error Codes
+  * \brief Predefined spline trajectory error codes
+  */
+//@{
+#define SPLINE_TRAJECTORY_ERROR_NONE       0
+//!< Success
+#define SPLINE_TRAJECTORY_ERROR_SAMPLES    1
+//!< Invalid trajectory samples
+#define SPLINE_TRAJECTORY_ERROR_INTERPOLATION 2
+//!< Trajectory interpolation failed
+#define SPLINE_TRAJECTORY_ERROR_UNDEFINED  3
+//!< Trajectory undefined at time
+//@}
+
+/** \brief Predefined spline trajectory error descriptions
+  */
+extern const char* spline_trajectory_errors[];
+
+/** \brief Structure defining a spline trajectory
+  */
+typedef struct spline_trajectory_t {
+  double* t;                          //!< The time knots.
+  size_t num_knots;                   //!< The number of time knots.
+
+  transform_point_t* positions;       //!< The positions at the knots.
+  transform_point_t* accelerations;   //!< The second derivatives of the
+                                      //!< positions at the knots.
+  transform_quaternion_t* rotations;  //!< The orientations at the knots.
+  transform_quaternion_t* controls;   //!< The squad control quaternions.
+
+  error_t error;                      //!< The most recent trajectory error.
+} spline_trajectory_t;
+
+/** \brief Initialize an empty spline trajectory
+  * \param[in] trajectory The spline trajectory to be initialized.
+  */
+void spline_trajectory_init(
+  spline_trajectory_t* trajectory);
+
+/** \brief Destroy a spline trajectory
+  * \param[in] trajectory The spline trajectory to be destroyed.
+  */
+void spline_trajectory_destroy(
+  spline_trajectory_t* trajectory);
+
+/** \brief Clear a spline trajectory
+  * \param[in] trajectory The spline trajectory to be cleared.
+  */
+void spline_trajectory_clear(
+  spline_trajectory_t* trajectory);
+
+/** \brief Fit a spline trajectory to timestamped poses
+  * \param[in,out] trajectory The spline trajectory to be fitted.
+  * \param[in] timestamps The strictly increasing timestamps of the poses.
+  * \param[in] poses The poses to be interpolated by the trajectory.
+  * \param[in] num_poses The number of timestamps and poses, which must be
+  *   at least two.
+  * \return The number of time knots of the trajectory or the negative
+  *   error code.
+  *
+  * The second derivatives of the positions vanish at the boundaries. The
+  * signs of the orientation quaternions are chosen such as to interpolate
+  * along the shorter arc between consecutive poses.
+  */
+ssize_t spline_trajectory_fit(
+  spline_trajectory_t* trajectory,
+  const double* timestamps,
+  const transform_pose_t* poses,
+  size_t num_poses);
+
+/** \brief Find the trajectory segment containing a time
+  * \param[in] trajectory The spline trajectory to be searched.
+  * \param[in] t The time for which to find the segment.
+  * \param[in,out] index The segment index at which to start searching. On
+  *   return, the index will be modified to indicate the segment containing
+  *   the time.
+  * \return The index of the segment or the negative error code if the
+  *   time lies outside the range of the time knots.
+  *
+  * This function first tests the segment of the given index and its
+  * successor before resorting to bisection.
+  */
+ssize_t spline_trajectory_find_segment(
+  spline_trajectory_t* trajectory,
+  double t,
+  size_t* index);
+
+/** \brief Evaluate the spline trajectory at an array of times
+  * \param[in] trajectory The spline trajectory to be evaluated.
+  * \param[in] t The times at which to evaluate the trajectory.
+  * \param[out] transforms The transforms representing the poses of the
+  *   trajectory at the given times. For times outside the range of the
+  *   time knots, all transform entries will be NaN.
+  * \param[in] num_values The number of times to be evaluated.
+  * \param[in,out] index The segment index at which to start searching for
+  *   the first time. On return, the index will be modified to indicate the
+  *   segment of the last defined time.
+  * \return The number of evaluated times or the negative error code if
+  *   the trajectory is undefined at any of the times.
+  */
+ssize_t spline_trajectory_eval(
+  spline_trajectory_t* trajectory,
+  const double* t,
+  transform_t* transforms,
+  size_t num_values,
+  size_t* index);
+
+/** \brief Evaluate the velocities of the spline trajectory at an array
+  *   of times
+  * \param[in] trajectory The spline trajectory to be evaluated.
+  * \param[in] t The times at which to evaluate the velocities.
+  * \param[out] linear The linear velocities of the trajectory in world
+  *   coordinates at the given times. May be null.
+  * \param[out] angular The angular velocities of the trajectory in world
+  *   coordinates at the given times. May be null.
+  * \param[in] num_values The number of times to be evaluated.
+  * \param[in,out] index The segment index at which to start searching for
+  *   the first time. On return, the index will be modified to indicate the
+  *   segment of the last defined time.
+  * \return The number of evaluated times or the negative error code if
+  *   the trajectory is undefined at any of the times.
+  *
+  * The linear velocities are the exact derivatives of the position
+  * splines. The angular velocities are obtained from central differences
+  * of the interpolated orientations within the segment.
+  */
+ssize_t spline_trajectory_eval_velocity(
+  spline_trajectory_t* trajectory,
+  const double* t,
+  transform_point_t* linear,
+  transform_point_t* angular,
+  size_t num_values,
+  size_t* index);
+
+#endif
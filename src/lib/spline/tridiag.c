@@ -0,0 +1,219 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "tridiag.h"
+
+#include "spline/spline.h"
+
+typedef struct spline_tridiag_block_t {
+  size_t index_min;
+  size_t index_max;
+  int error;
+} spline_tridiag_block_t;
+
+typedef struct spline_tridiag_arg_t {
+  const double* d;
+  const double* e;
+  const double* c;
+  const double* b;
+  double* x;
+
+  double* g;
+  double* l;
+  double* r;
+  double* x_s;
+
+  spline_tridiag_block_t* blocks;
+  size_t num_blocks;
+} spline_tridiag_arg_t;
+
+int spline_tridiag_solve(const double* d, const double* e, const double* c,
+    const double* b, double* x, size_t n) {
+  if (!n)
+    return SPLINE_ERROR_NONE;
+
+  double* g = malloc(n*sizeof(double));
+  double m = d[0];
+  size_t i;
+
+  if (m == 0.0) {
+    free(g);
+    return SPLINE_ERROR_INTERPOLATION;
+  }
+  x[0] = b[0]/m;
+
+  for (i = 1; i < n; ++i) {
+    g[i-1] = e[i-1]/m;
+    m = d[i]-c[i-1]*g[i-1];
+
+    if (m == 0.0) {
+      free(g);
+      return SPLINE_ERROR_INTERPOLATION;
+    }
+    x[i] = (b[i]-c[i-1]*x[i-1])/m;
+  }
+
+  for (i = n-1; i > 0; --i)
+    x[i-1] -= g[i-1]*x[i];
+
+  free(g);
+  return SPLINE_ERROR_NONE;
+}
+
+static void spline_tridiag_solve_blocks(void* arg, size_t index_min,
+    size_t index_max) {
+  spline_tridiag_arg_t* a = arg;
+  size_t k;
+
+  for (k = index_min; k < index_max; ++k) {
+    spline_tridiag_block_t* block = &a->blocks[k];
+    size_t i_min = block->index_min, i_max = block->index_max, i;
+    int left = (k > 0), right = (k+1 < a->num_blocks);
+
+    double m = a->d[i_min];
+    if (m == 0.0) {
+      block->error = SPLINE_ERROR_INTERPOLATION;
+      continue;
+    }
+    a->x[i_min] = a->b[i_min]/m;
+    a->l[i_min] = left ? -a->c[i_min-1]/m : 0.0;
+
+    for (i = i_min+1; i <= i_max; ++i) {
+      a->g[i-1] = a->e[i-1]/m;
+      m = a->d[i]-a->c[i-1]*a->g[i-1];
+
+      if (m == 0.0) {
+        block->error = SPLINE_ERROR_INTERPOLATION;
+        break;
+      }
+      a->x[i] = (a->b[i]-a->c[i-1]*a->x[i-1])/m;
+      a->l[i] = -a->c[i-1]*a->l[i-1]/m;
+      a->r[i-1] = 0.0;
+    }
+    if (block->error)
+      continue;
+    a->r[i_max] = right ? -a->e[i_max]/m : 0.0;
+
+    for (i = i_max; i > i_min; --i) {
+      a->x[i-1] -= a->g[i-1]*a->x[i];
+      a->l[i-1] -= a->g[i-1]*a->l[i];
+      a->r[i-1] -= a->g[i-1]*a->r[i];
+    }
+  }
+}
+
+static void spline_tridiag_substitute_blocks(void* arg, size_t index_min,
+    size_t index_max) {
+  spline_tridiag_arg_t* a = arg;
+  size_t k;
+
+  for (k = index_min; k < index_max; ++k) {
+    spline_tridiag_block_t* block = &a->blocks[k];
+    double x_l = (k > 0) ? a->x_s[k-1] : 0.0;
+    double x_r = (k+1 < a->num_blocks) ? a->x_s[k] : 0.0;
+    size_t i;
+
+    for (i = block->index_min; i <= block->index_max; ++i)
+      a->x[i] += a->l[i]*x_l+a->r[i]*x_r;
+  }
+}
+
+int spline_tridiag_solve_parallel(thread_pool_t* pool, const double* d,
+    const double* e, const double* c, const double* b, double* x, size_t n) {
+  size_t num_blocks = thread_pool_get_num_threads(pool);
+  if (2*num_blocks > n+1)
+    num_blocks = (n+1)/2;
+  if (num_blocks < 2)
+    return spline_tridiag_solve(d, e, c, b, x, n);
+
+  spline_tridiag_arg_t arg;
+  int result = SPLINE_ERROR_NONE;
+  size_t num_rows = n-(num_blocks-1), i, k;
+
+  arg.d = d;
+  arg.e = e;
+  arg.c = c;
+  arg.b = b;
+  arg.x = x;
+
+  arg.g = malloc(n*sizeof(double));
+  arg.l = malloc(n*sizeof(double));
+  arg.r = malloc(n*sizeof(double));
+  arg.x_s = malloc((num_blocks-1)*sizeof(double));
+
+  arg.blocks = malloc(num_blocks*sizeof(spline_tridiag_block_t));
+  arg.num_blocks = num_blocks;
+
+  for (k = 0, i = 0; k < num_blocks; ++k) {
+    size_t num_block_rows = num_rows/num_blocks+(k < num_rows%num_blocks);
+
+    arg.blocks[k].index_min = i;
+    arg.blocks[k].index_max = i+num_block_rows-1;
+    arg.blocks[k].error = SPLINE_ERROR_NONE;
+
+    i += num_block_rows+1;
+  }
+
+  thread_pool_for(pool, spline_tridiag_solve_blocks, &arg, num_blocks, 1);
+
+  for (k = 0; k < num_blocks; ++k)
+    if (arg.blocks[k].error)
+      result = arg.blocks[k].error;
+
+  if (!result) {
+    size_t num_sep = num_blocks-1;
+    double* d_s = malloc(num_sep*sizeof(double));
+    double* e_s = malloc(num_sep*sizeof(double));
+    double* c_s = malloc(num_sep*sizeof(double));
+    double* b_s = malloc(num_sep*sizeof(double));
+
+    for (k = 0; k < num_sep; ++k) {
+      size_t s = arg.blocks[k].index_max+1;
+
+      d_s[k] = d[s]+c[s-1]*arg.r[s-1]+e[s]*arg.l[s+1];
+      b_s[k] = b[s]-c[s-1]*x[s-1]-e[s]*x[s+1];
+      if (k > 0)
+        c_s[k-1] = c[s-1]*arg.l[s-1];
+      if (k+1 < num_sep)
+        e_s[k] = e[s]*arg.r[s+1];
+    }
+
+    if (!(result = spline_tridiag_solve(d_s, e_s, c_s, b_s, arg.x_s,
+        num_sep))) {
+      for (k = 0; k < num_sep; ++k)
+        x[arg.blocks[k].index_max+1] = arg.x_s[k];
+      thread_pool_for(pool, spline_tridiag_substitute_blocks, &arg,
+        num_blocks, 1);
+    }
+
+    free(d_s);
+    free(e_s);
+    free(c_s);
+    free(b_s);
+  }
+
+  free(arg.g);
+  free(arg.l);
+  free(arg.r);
+  free(arg.x_s);
+  free(arg.blocks);
+
+  return result;
+}
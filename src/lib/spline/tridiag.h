@@ -0,0 +1,95 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_TRIDIAG_H
+#define SPLINE_TRIDIAG_H
+
+/** \file spline/tridiag.h
+  * \ingroup spline
+  * \brief Tridiagonal solvers for cubic spline interpolation
+  * \author Ralf Kaestner
+  *
+  * The tridiagonal solvers operate on systems of equations A*x = b, where
+  * the tridiagonal N x N matrix A is given by its main diagonal
+  * d = (d_1, ..., d_N)^T, its upper sub-diagonal e = (e_1, ..., e_M)^T, and
+  * its lower sub-diagonal c = (c_1, ..., c_M)^T with M = N-1. Since the
+  * systems arising from cubic spline interpolation are diagonally dominant,
+  * the solvers do not perform any pivoting.
+  */
+
+#include <stdlib.h>
+
+#include "thread/pool.h"
+
+/** \brief Solve a tridiagonal system sequentially
+  * \param[in] d The main diagonal of the system, an array of N values.
+  * \param[in] e The upper sub-diagonal of the system, an array of N-1
+  *   values.
+  * \param[in] c The lower sub-diagonal of the system, an array of N-1
+  *   values.
+  * \param[in] b The right-hand side vector of the system, an array of
+  *   N values.
+  * \param[out] x The solution vector of the system, an array of N values.
+  * \param[in] n The size N of the system.
+  * \return The resulting error code.
+  *
+  * This function implements the Thomas algorithm in O(N) computational
+  * time.
+  */
+int spline_tridiag_solve(
+  const double* d,
+  const double* e,
+  const double* c,
+  const double* b,
+  double* x,
+  size_t n);
+
+/** \brief Solve a tridiagonal system in parallel
+  * \param[in] pool The thread pool used for solving the system.
+  * \param[in] d The main diagonal of the system, an array of N values.
+  * \param[in] e The upper sub-diagonal of the system, an array of N-1
+  *   values.
+  * \param[in] c The lower sub-diagonal of the system, an array of N-1
+  *   values.
+  * \param[in] b The right-hand side vector of the system, an array of
+  *   N values.
+  * \param[out] x The solution vector of the system, an array of N values.
+  * \param[in] n The size N of the system.
+  * \return The resulting error code.
+  *
+  * This function implements a partitioned Thomas algorithm. The system is
+  * split into P blocks separated by P-1 interface rows, where P is the
+  * number of threads in the pool. Each block is solved independently for
+  * its right-hand side and its couplings to the neighboring interface
+  * unknowns. The resulting reduced tridiagonal system of size P-1 is solved
+  * sequentially for the interface unknowns, which are finally substituted
+  * back into the blocks in parallel. The result agrees with the sequential
+  * solution up to floating-point round-off.
+  */
+int spline_tridiag_solve_parallel(
+  thread_pool_t* pool,
+  const double* d,
+  const double* e,
+  const double* c,
+  const double* b,
+  double* x,
+  size_t n);
+
+#endif
@@ -46,6 +46,10 @@ void thread_condition_signal(thread_condition_t* condition) {
   pthread_cond_signal(&condition->handle);
 }
 
+void thread_condition_broadcast(thread_condition_t* condition) {
+  pthread_cond_broadcast(&condition->handle);
+}
+
 void thread_condition_lock(thread_condition_t* condition) {
   thread_mutex_lock(&condition->mutex);
 }
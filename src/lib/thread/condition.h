@@ -83,6 +83,15 @@ void thread_condition_destroy(
 void thread_condition_signal(
   thread_condition_t* condition);
 
+/** \brief Broadcast a condition
+  * \param[in] condition The initialized condition to be broadcasted.
+  * 
+  * As opposed to thread_condition_signal(), broadcasting a condition
+  * unblocks all threads currently waiting for the condition.
+  */
+void thread_condition_broadcast(
+  thread_condition_t* condition);
+
 /** \brief Lock a thread condition mutex
   * \param[in] condition The initialized thread condition to lock the
   *   mutex for.
@@ -0,0 +1,170 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <unistd.h>
+
+#include "pool.h"
+
+const char* thread_pool_errors[] = {
+  "Success",
+  "Error creating worker thread",
+};
+
+static void thread_pool_process(thread_pool_t* pool) {
+  while (pool->next_item < pool->num_items) {
+    size_t index_min = pool->next_item;
+    size_t index_max = (pool->num_items-index_min > pool->grain_size) ?
+      index_min+pool->grain_size : pool->num_items;
+    thread_pool_routine_t routine = pool->routine;
+    void* arg = pool->arg;
+
+    pool->next_item = index_max;
+
+    thread_condition_unlock(&pool->condition);
+    routine(arg, index_min, index_max);
+    thread_condition_lock(&pool->condition);
+  }
+}
+
+static void* thread_pool_run(void* arg) {
+  thread_pool_t* pool = arg;
+  size_t generation;
+
+  thread_condition_lock(&pool->condition);
+  generation = pool->generation;
+
+  while (1) {
+    while (!pool->exit_request && (pool->generation == generation))
+      thread_condition_wait(&pool->condition, THREAD_CONDITION_WAIT_FOREVER);
+    if (pool->exit_request)
+      break;
+
+    generation = pool->generation;
+    ++pool->num_busy;
+
+    thread_pool_process(pool);
+
+    --pool->num_busy;
+    if (!pool->num_busy)
+      thread_condition_broadcast(&pool->condition);
+  }
+  thread_condition_unlock(&pool->condition);
+
+  return 0;
+}
+
+int thread_pool_init(thread_pool_t* pool, size_t num_threads) {
+  int result = THREAD_POOL_ERROR_NONE;
+
+  if (!num_threads) {
+    long num_processors = sysconf(_SC_NPROCESSORS_ONLN);
+    num_threads = (num_processors > 0) ? num_processors : 1;
+  }
+
+  pool->threads = 0;
+  pool->num_threads = 0;
+
+  thread_condition_init(&pool->condition);
+
+  pool->routine = 0;
+  pool->arg = 0;
+  pool->num_items = 0;
+  pool->grain_size = 0;
+  pool->next_item = 0;
+
+  pool->num_busy = 0;
+  pool->generation = 0;
+  pool->exit_request = 0;
+
+  if (num_threads > 1) {
+    pool->threads = malloc((num_threads-1)*sizeof(thread_t));
+
+    while (pool->num_threads+1 < num_threads) {
+      if (thread_start(&pool->threads[pool->num_threads], thread_pool_run,
+          0, pool, 0.0)) {
+        result = THREAD_POOL_ERROR_CREATE;
+        break;
+      }
+      ++pool->num_threads;
+    }
+  }
+
+  return result;
+}
+
+void thread_pool_destroy(thread_pool_t* pool) {
+  size_t i;
+
+  thread_condition_lock(&pool->condition);
+  pool->exit_request = 1;
+  thread_condition_broadcast(&pool->condition);
+  thread_condition_unlock(&pool->condition);
+
+  for (i = 0; i < pool->num_threads; ++i)
+    thread_wait_exit(&pool->threads[i]);
+
+  if (pool->threads) {
+    free(pool->threads);
+
+    pool->threads = 0;
+    pool->num_threads = 0;
+  }
+
+  thread_condition_destroy(&pool->condition);
+}
+
+size_t thread_pool_get_num_threads(const thread_pool_t* pool) {
+  return pool->num_threads+1;
+}
+
+void thread_pool_for(thread_pool_t* pool, thread_pool_routine_t routine,
+    void* arg, size_t num_items, size_t grain_size) {
+  size_t num_threads = thread_pool_get_num_threads(pool);
+
+  if (!grain_size)
+    grain_size = (num_items+num_threads-1)/num_threads;
+  if (!grain_size)
+    grain_size = 1;
+
+  if ((num_threads == 1) || (num_items <= grain_size)) {
+    size_t i;
+    for (i = 0; i < num_items; i += grain_size)
+      routine(arg, i, (num_items-i > grain_size) ? i+grain_size : num_items);
+
+    return;
+  }
+
+  thread_condition_lock(&pool->condition);
+
+  pool->routine = routine;
+  pool->arg = arg;
+  pool->num_items = num_items;
+  pool->grain_size = grain_size;
+  pool->next_item = 0;
+  ++pool->generation;
+  thread_condition_broadcast(&pool->condition);
+
+  thread_pool_process(pool);
+
+  while (pool->num_busy)
+    thread_condition_wait(&pool->condition, THREAD_CONDITION_WAIT_FOREVER);
+
+  thread_condition_unlock(&pool->condition);
+}
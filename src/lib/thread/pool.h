@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/** \file thread/pool.h
+  * \ingroup thread
+  * \brief Worker thread pool implementation
+  * \author Ralf Kaestner
+  *
+  * A thread pool maintains a fixed number of worker threads which may be
+  * employed to process a range of independent work items in parallel. The
+  * work items are handed out to the workers in chunks of a given grain size,
+  * and the calling thread participates in processing the range.
+  *
+  * The state of the current work is kept in the pool itself. A pool thus
+  * accepts work from one submitter at a time, and threads sharing a pool
+  * must serialize their calls to thread_pool_for().
+  */
+
+#include <stdlib.h>
+
+#include "thread/thread.h"
+
+/** \name Error Codes
+  * \brief Predefined thread pool error codes
+  */
+//@{
+#define THREAD_POOL_ERROR_NONE         0
+//!< Success
+#define THREAD_POOL_ERROR_CREATE       1
+//!< Error creating worker thread
+//@}
+
+/** \brief Predefined thread pool error descriptions
+  */
+extern const char* thread_pool_errors[];
+
+/** \brief Thread pool work routine
+  *
+  * The work routine is called with the pool's work argument and the
+  * half-open range [index_min, index_max) of work items to be processed.
+  */
+typedef void (*thread_pool_routine_t)(
+  void* arg,
+  size_t index_min,
+  size_t index_max);
+
+/** \brief Structure defining the thread pool
+  */
+typedef struct thread_pool_t {
+  thread_t* threads;              //!< The worker threads.
+  size_t num_threads;             //!< The number of worker threads.
+
+  thread_condition_t condition;   //!< The pool condition and mutex.
+
+  thread_pool_routine_t routine;  //!< The routine of the current work.
+  void* arg;                      //!< The argument of the current work.
+  size_t num_items;               //!< The number of items of the current work.
+  size_t grain_size;              //!< The grain size of the current work.
+  size_t next_item;               //!< The next unprocessed work item.
+
+  size_t num_busy;                //!< The number of busy worker threads.
+  size_t generation;              //!< The generation of the current work.
+  int exit_request;               //!< Flag signaling a pending exit request.
+} thread_pool_t;
+
+/** \brief Initialize a thread pool
+  * \param[in] pool The thread pool to be initialized.
+  * \param[in] num_threads The number of threads which will process work
+  *   items, including the calling thread. If zero, the number of online
+  *   processors will be used.
+  * \return The resulting error code.
+  *
+  * The pool will start num_threads-1 worker threads which idle until
+  * work is submitted through thread_pool_for().
+  */
+int thread_pool_init(
+  thread_pool_t* pool,
+  size_t num_threads);
+
+/** \brief Destroy a thread pool
+  * \param[in] pool The initialized thread pool to be destroyed.
+  *
+  * All worker threads will be requested to exit and joined.
+  */
+void thread_pool_destroy(
+  thread_pool_t* pool);
+
+/** \brief Retrieve the thread pool's number of threads
+  * \param[in] pool The initialized thread pool to retrieve the number of
+  *   threads for.
+  * \return The number of threads processing work items, including the
+  *   calling thread.
+  */
+size_t thread_pool_get_num_threads(
+  const thread_pool_t* pool);
+
+/** \brief Process a range of work items in parallel
+  * \param[in] pool The initialized thread pool to process the work items.
+  * \param[in] routine The work routine to be called for each chunk of
+  *   work items.
+  * \param[in] arg The argument to be passed on to the work routine.
+  * \param[in] num_items The number of work items to be processed.
+  * \param[in] grain_size The maximum number of work items per chunk. If
+  *   zero, the range will be split into one chunk per thread.
+  *
+  * The function blocks until all work items have been processed. The
+  * calling thread participates in processing the work items, such that a
+  * pool of a single thread processes all work items sequentially.
+  *
+  * The function is not reentrant. It must neither be called concurrently
+  * for the same pool nor from within a work routine of that pool.
+  */
+void thread_pool_for(
+  thread_pool_t* pool,
+  thread_pool_routine_t routine,
+  void* arg,
+  size_t num_items,
+  size_t grain_size);
+
+#endif
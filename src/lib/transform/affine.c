@@ -0,0 +1,269 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <math.h>
+
+#include "affine.h"
+
+#include "transform/simd.h"
+
+void transform_affine_init_identity(transform_affine_t affine) {
+  int i, j;
+
+  for (i = 0; i < 3; ++i)
+    for (j = 0; j < 4; ++j)
+      affine[i][j] = (i == j) ? 1.0 : 0.0;
+}
+
+void transform_affine_init_translation(transform_affine_t affine, double t_x,
+    double t_y, double t_z) {
+  transform_affine_init_identity(affine);
+
+  affine[0][3] = t_x;
+  affine[1][3] = t_y;
+  affine[2][3] = t_z;
+}
+
+void transform_affine_init_scaling(transform_affine_t affine, double s_x,
+    double s_y, double s_z) {
+  transform_affine_init_identity(affine);
+
+  affine[0][0] = s_x;
+  affine[1][1] = s_y;
+  affine[2][2] = s_z;
+}
+
+void transform_affine_init_rotation(transform_affine_t affine, double yaw,
+    double pitch, double roll) {
+  double c_y = cos(yaw), s_y = sin(yaw);
+  double c_p = cos(pitch), s_p = sin(pitch);
+  double c_r = cos(roll), s_r = sin(roll);
+
+  affine[0][0] = c_y*c_p;
+  affine[0][1] = c_y*s_p*s_r-s_y*c_r;
+  affine[0][2] = c_y*s_p*c_r+s_y*s_r;
+  affine[0][3] = 0.0;
+
+  affine[1][0] = s_y*c_p;
+  affine[1][1] = s_y*s_p*s_r+c_y*c_r;
+  affine[1][2] = s_y*s_p*c_r-c_y*s_r;
+  affine[1][3] = 0.0;
+
+  affine[2][0] = -s_p;
+  affine[2][1] = c_p*s_r;
+  affine[2][2] = c_p*c_r;
+  affine[2][3] = 0.0;
+}
+
+void transform_affine_init_pose(transform_affine_t affine, const
+    transform_pose_t* pose) {
+  transform_affine_init_rotation(affine, pose->yaw, pose->pitch, pose->roll);
+
+  affine[0][3] = pose->x;
+  affine[1][3] = pose->y;
+  affine[2][3] = pose->z;
+}
+
+void transform_affine_init_transform(transform_affine_t affine, transform_t
+    transform) {
+  int i, j;
+
+  for (i = 0; i < 3; ++i)
+    for (j = 0; j < 4; ++j)
+      affine[i][j] = transform[i][j];
+}
+
+void transform_affine_to_transform(transform_affine_t affine, transform_t
+    transform) {
+  int i, j;
+
+  for (i = 0; i < 3; ++i)
+    for (j = 0; j < 4; ++j)
+      transform[i][j] = affine[i][j];
+
+  transform[3][0] = 0.0;
+  transform[3][1] = 0.0;
+  transform[3][2] = 0.0;
+  transform[3][3] = 1.0;
+}
+
+void transform_affine_copy(transform_affine_t dst, transform_affine_t src) {
+  int i, j;
+
+  for (i = 0; i < 3; ++i)
+    for (j = 0; j < 4; ++j)
+      dst[i][j] = src[i][j];
+}
+
+void transform_affine_print(FILE* stream, transform_affine_t affine) {
+  int i;
+
+  for (i = 0; i < 3; ++i) {
+    fprintf(stream, "%10lg  %10lg  %10lg  %10lg",
+      affine[i][0],
+      affine[i][1],
+      affine[i][2],
+      affine[i][3]);
+  }
+}
+
+void transform_affine_multiply_left(transform_affine_t right,
+    transform_affine_t left) {
+  transform_affine_t result;
+  int i, j;
+
+  for (i = 0; i < 3; ++i) {
+    for (j = 0; j < 4; ++j)
+      result[i][j] = left[i][0]*right[0][j]+left[i][1]*right[1][j]+
+        left[i][2]*right[2][j];
+    result[i][3] += left[i][3];
+  }
+
+  transform_affine_copy(right, result);
+}
+
+int transform_affine_is_rigid(transform_affine_t affine) {
+  int i, j, k;
+
+  for (i = 0; i < 3; ++i) {
+    for (j = i; j < 3; ++j) {
+      double r_ij = 0.0;
+
+      for (k = 0; k < 3; ++k)
+        r_ij += affine[i][k]*affine[j][k];
+      if (fabs(r_ij-(i == j)) > TRANSFORM_RIGID_TOLERANCE)
+        return 0;
+    }
+  }
+
+  return 1;
+}
+
+void transform_affine_invert(transform_affine_t affine) {
+  double t[3] = {affine[0][3], affine[1][3], affine[2][3]};
+  int i, j;
+
+  if (transform_affine_is_rigid(affine)) {
+    for (i = 0; i < 3; ++i) {
+      for (j = i+1; j < 3; ++j) {
+        double a_ij = affine[i][j];
+
+        affine[i][j] = affine[j][i];
+        affine[j][i] = a_ij;
+      }
+    }
+  }
+  else {
+    double a[3][3], det;
+
+    a[0][0] = affine[1][1]*affine[2][2]-affine[1][2]*affine[2][1];
+    a[0][1] = affine[0][2]*affine[2][1]-affine[0][1]*affine[2][2];
+    a[0][2] = affine[0][1]*affine[1][2]-affine[0][2]*affine[1][1];
+    a[1][0] = affine[1][2]*affine[2][0]-affine[1][0]*affine[2][2];
+    a[1][1] = affine[0][0]*affine[2][2]-affine[0][2]*affine[2][0];
+    a[1][2] = affine[0][2]*affine[1][0]-affine[0][0]*affine[1][2];
+    a[2][0] = affine[1][0]*affine[2][1]-affine[1][1]*affine[2][0];
+    a[2][1] = affine[0][1]*affine[2][0]-affine[0][0]*affine[2][1];
+    a[2][2] = affine[0][0]*affine[1][1]-affine[0][1]*affine[1][0];
+
+    det = affine[0][0]*a[0][0]+affine[0][1]*a[1][0]+affine[0][2]*a[2][0];
+
+    for (i = 0; i < 3; ++i)
+      for (j = 0; j < 3; ++j)
+        affine[i][j] = a[i][j]/det;
+  }
+
+  for (i = 0; i < 3; ++i)
+    affine[i][3] = -affine[i][0]*t[0]-affine[i][1]*t[1]-affine[i][2]*t[2];
+}
+
+void transform_affine_translate(transform_affine_t affine, double t_x,
+    double t_y, double t_z) {
+  affine[0][3] += t_x;
+  affine[1][3] += t_y;
+  affine[2][3] += t_z;
+}
+
+void transform_affine_scale(transform_affine_t affine, double s_x, double
+    s_y, double s_z) {
+  int j;
+
+  for (j = 0; j < 4; ++j) {
+    affine[0][j] *= s_x;
+    affine[1][j] *= s_y;
+    affine[2][j] *= s_z;
+  }
+}
+
+void transform_affine_rotate(transform_affine_t affine, double yaw, double
+    pitch, double roll) {
+  transform_affine_t rotation;
+  int i, j;
+
+  transform_affine_init_rotation(rotation, yaw, pitch, roll);
+
+  for (j = 0; j < 4; ++j) {
+    double a_0 = affine[0][j], a_1 = affine[1][j], a_2 = affine[2][j];
+
+    for (i = 0; i < 3; ++i)
+      affine[i][j] = rotation[i][0]*a_0+rotation[i][1]*a_1+
+        rotation[i][2]*a_2;
+  }
+}
+
+void transform_affine_point(transform_affine_t affine, transform_point_t*
+    point) {
+  double x = point->x, y = point->y, z = point->z;
+
+  point->x = affine[0][0]*x+affine[0][1]*y+affine[0][2]*z+affine[0][3];
+  point->y = affine[1][0]*x+affine[1][1]*y+affine[1][2]*z+affine[1][3];
+  point->z = affine[2][0]*x+affine[2][1]*y+affine[2][2]*z+affine[2][3];
+}
+
+void transform_affine_points(transform_affine_t affine, transform_point_t*
+    points, size_t num_points) {
+  transform_affine_points_copy(affine, points, points, num_points);
+}
+
+void transform_affine_points_copy(transform_affine_t affine, const
+    transform_point_t* points, transform_point_t* result, size_t num_points) {
+  double r_00 = affine[0][0], r_01 = affine[0][1],
+    r_02 = affine[0][2], t_0 = affine[0][3];
+  double r_10 = affine[1][0], r_11 = affine[1][1],
+    r_12 = affine[1][2], t_1 = affine[1][3];
+  double r_20 = affine[2][0], r_21 = affine[2][1],
+    r_22 = affine[2][2], t_2 = affine[2][3];
+  size_t i;
+
+  for (i = 0; i < num_points; ++i) {
+    double x = points[i].x, y = points[i].y, z = points[i].z;
+
+    result[i].x = r_00*x+r_01*y+r_02*z+t_0;
+    result[i].y = r_10*x+r_11*y+r_12*z+t_1;
+    result[i].z = r_20*x+r_21*y+r_22*z+t_2;
+  }
+}
+
+void transform_affine_point_buffer(transform_affine_t affine,
+    transform_point_buffer_t* buffer) {
+  transform_simd_get_kernel()((const double (*)[4])affine, buffer->x,
+    buffer->y, buffer->z, buffer->x, buffer->y, buffer->z,
+    buffer->num_points);
+}
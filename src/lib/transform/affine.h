@@ -0,0 +1,244 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_AFFINE_H
+#define TRANSFORM_AFFINE_H
+
+/** \file transform/affine.h
+  * \ingroup transform
+  * \brief Affine transformation interface
+  * \author Ralf Kaestner
+  *
+  * The affine transformation interface represents transformations by the
+  * upper 3x4 block of their matrix, omitting the constant last row
+  * (0, 0, 0, 1). Composition thus requires 36 instead of 64
+  * multiplications, and translations, scalings, and rotations are applied
+  * by updating only the affected matrix entries.
+  */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "transform/transform.h"
+
+/** \brief Structure defining an affine transformation
+  *
+  * An affine transformation is defined as a 3x4 matrix [A t], where the
+  * 3x3 matrix A represents the linear part and the vector t the
+  * translational part of the transformation.
+  */
+typedef double transform_affine_t[3][4];
+
+/** \brief Initialize identity affine transform
+  * \param[in] affine The affine transform to be initialized to identity.
+  */
+void transform_affine_init_identity(
+  transform_affine_t affine);
+
+/** \brief Initialize translation affine transform
+  * \param[in] affine The affine transform to be initialized with a
+  *   translation.
+  * \param[in] t_x The initial translation along the x-axis.
+  * \param[in] t_y The initial translation along the y-axis.
+  * \param[in] t_z The initial translation along the z-axis.
+  */
+void transform_affine_init_translation(
+  transform_affine_t affine,
+  double t_x,
+  double t_y,
+  double t_z);
+
+/** \brief Initialize scaling affine transform
+  * \param[in] affine The affine transform to be initialized with a scaling.
+  * \param[in] s_x The initial scale along the x-axis.
+  * \param[in] s_y The initial scale along the y-axis.
+  * \param[in] s_z The initial scale along the z-axis.
+  */
+void transform_affine_init_scaling(
+  transform_affine_t affine,
+  double s_x,
+  double s_y,
+  double s_z);
+
+/** \brief Initialize rotation affine transform
+  * \param[in] affine The affine transform to be initialized with a
+  *   rotation.
+  * \param[in] yaw The initial rotation about the z-axis in [rad].
+  * \param[in] pitch The initial rotation about the y-axis [rad].
+  * \param[in] roll The initial rotation about the x-axis [rad].
+  */
+void transform_affine_init_rotation(
+  transform_affine_t affine,
+  double yaw,
+  double pitch,
+  double roll);
+
+/** \brief Initialize pose affine transform
+  * \param[in] affine The affine transform to be initialized from a pose.
+  * \param[in] pose The pose to initialize the affine transform from.
+  */
+void transform_affine_init_pose(
+  transform_affine_t affine,
+  const transform_pose_t* pose);
+
+/** \brief Initialize affine transform from transform
+  * \param[in] affine The affine transform to be initialized.
+  * \param[in] transform The transform to initialize the affine transform
+  *   from. The last row of the transform is assumed to be (0, 0, 0, 1)
+  *   and will be ignored.
+  */
+void transform_affine_init_transform(
+  transform_affine_t affine,
+  transform_t transform);
+
+/** \brief Convert affine transform to transform
+  * \param[in] affine The affine transform to be converted.
+  * \param[out] transform The transform holding the converted affine
+  *   transform.
+  */
+void transform_affine_to_transform(
+  transform_affine_t affine,
+  transform_t transform);
+
+/** \brief Copy affine transform
+  * \param[in] dst The destination affine transform to copy to.
+  * \param[in] src The source affine transform to copy from.
+  */
+void transform_affine_copy(
+  transform_affine_t dst,
+  transform_affine_t src);
+
+/** \brief Print affine transform
+  * \param[in] stream The output stream that will be used for printing the
+  *   affine transform.
+  * \param[in] affine The affine transform that will be printed.
+  */
+void transform_affine_print(
+  FILE* stream,
+  transform_affine_t affine);
+
+/** \brief Left-multiply affine transform with another affine transform
+  * \param[in,out] right The affine transform that will be the right-hand
+  *   factor of the multiplication and hold the result.
+  * \param[in] left The affine transform that will be the left-hand factor
+  *   of the multiplication.
+  */
+void transform_affine_multiply_left(
+  transform_affine_t right,
+  transform_affine_t left);
+
+/** \brief Check if an affine transform is rigid
+  * \param[in] affine The affine transform to be checked.
+  * \return One if the linear part of the affine transform is orthonormal
+  *   up to TRANSFORM_RIGID_TOLERANCE, zero otherwise.
+  */
+int transform_affine_is_rigid(
+  transform_affine_t affine);
+
+/** \brief Invert affine transform
+  * \param[in,out] affine The affine transform that will be inverted.
+  *
+  * Rigid transforms are inverted in closed form, whereas the linear
+  * part of any other affine transform is inverted through its adjugate.
+  * The result is undefined for singular transforms.
+  */
+void transform_affine_invert(
+  transform_affine_t affine);
+
+/** \brief Apply translation to affine transform
+  * \param[in,out] affine The affine transform to apply the translation to.
+  * \param[in] t_x The translation along the x-axis.
+  * \param[in] t_y The translation along the y-axis.
+  * \param[in] t_z The translation along the z-axis.
+  *
+  * Only the translational part of the affine transform is updated.
+  */
+void transform_affine_translate(
+  transform_affine_t affine,
+  double t_x,
+  double t_y,
+  double t_z);
+
+/** \brief Apply scaling to affine transform
+  * \param[in,out] affine The affine transform to apply the scaling to.
+  * \param[in] s_x The scale along the x-axis.
+  * \param[in] s_y The scale along the y-axis.
+  * \param[in] s_z The scale along the z-axis.
+  *
+  * Each row of the affine transform is multiplied by its scale.
+  */
+void transform_affine_scale(
+  transform_affine_t affine,
+  double s_x,
+  double s_y,
+  double s_z);
+
+/** \brief Apply rotation to affine transform
+  * \param[in,out] affine The affine transform to apply the rotation to.
+  * \param[in] yaw The rotation about the z-axis in [rad].
+  * \param[in] pitch The rotation about the y-axis [rad].
+  * \param[in] roll The rotation about the x-axis [rad].
+  */
+void transform_affine_rotate(
+  transform_affine_t affine,
+  double yaw,
+  double pitch,
+  double roll);
+
+/** \brief Transform point by affine transform
+  * \param[in] affine The affine transform to apply to the point.
+  * \param[in,out] point The point to be transformed.
+  */
+void transform_affine_point(
+  transform_affine_t affine,
+  transform_point_t* point);
+
+/** \brief Transform array of points by affine transform
+  * \param[in] affine The affine transform to apply to the points.
+  * \param[in,out] points The array of points to be transformed.
+  * \param[in] num_points The number of points in the array.
+  */
+void transform_affine_points(
+  transform_affine_t affine,
+  transform_point_t* points,
+  size_t num_points);
+
+/** \brief Transform array of points by affine transform out of place
+  * \param[in] affine The affine transform to apply to the points.
+  * \param[in] points The array of points to be transformed.
+  * \param[out] result The array of transformed points. The array may be
+  *   identical to the input array, but must not overlap it otherwise.
+  * \param[in] num_points The number of points in the arrays.
+  */
+void transform_affine_points_copy(
+  transform_affine_t affine,
+  const transform_point_t* points,
+  transform_point_t* result,
+  size_t num_points);
+
+/** \brief Transform point buffer by affine transform
+  * \param[in] affine The affine transform to apply to the points.
+  * \param[in,out] buffer The point buffer to be transformed.
+  */
+void transform_affine_point_buffer(
+  transform_affine_t affine,
+  transform_point_buffer_t* buffer);
+
+#endif
@@ -0,0 +1,141 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "buffer.h"
+
+void transform_point_buffer_init(transform_point_buffer_t* buffer) {
+  buffer->x = 0;
+  buffer->y = 0;
+  buffer->z = 0;
+
+  buffer->num_points = 0;
+}
+
+void transform_point_buffer_destroy(transform_point_buffer_t* buffer) {
+  transform_point_buffer_resize(buffer, 0);
+}
+
+void transform_point_buffer_resize(transform_point_buffer_t* buffer, size_t
+    num_points) {
+  if (num_points == buffer->num_points)
+    return;
+
+  if (num_points) {
+    buffer->x = realloc(buffer->x, num_points*sizeof(double));
+    buffer->y = realloc(buffer->y, num_points*sizeof(double));
+    buffer->z = realloc(buffer->z, num_points*sizeof(double));
+  }
+  else {
+    free(buffer->x);
+    free(buffer->y);
+    free(buffer->z);
+
+    buffer->x = 0;
+    buffer->y = 0;
+    buffer->z = 0;
+  }
+
+  buffer->num_points = num_points;
+}
+
+void transform_point_buffer_set_points(transform_point_buffer_t* buffer,
+    const transform_point_t* points, size_t num_points) {
+  size_t i;
+
+  transform_point_buffer_resize(buffer, num_points);
+
+  for (i = 0; i < num_points; ++i) {
+    buffer->x[i] = points[i].x;
+    buffer->y[i] = points[i].y;
+    buffer->z[i] = points[i].z;
+  }
+}
+
+void transform_point_buffer_get_points(const transform_point_buffer_t*
+    buffer, transform_point_t* points) {
+  size_t i;
+
+  for (i = 0; i < buffer->num_points; ++i) {
+    points[i].x = buffer->x[i];
+    points[i].y = buffer->y[i];
+    points[i].z = buffer->z[i];
+  }
+}
+
+void transform_point_float_buffer_init(transform_point_float_buffer_t*
+    buffer) {
+  buffer->x = 0;
+  buffer->y = 0;
+  buffer->z = 0;
+
+  buffer->num_points = 0;
+}
+
+void transform_point_float_buffer_destroy(transform_point_float_buffer_t*
+    buffer) {
+  transform_point_float_buffer_resize(buffer, 0);
+}
+
+void transform_point_float_buffer_resize(transform_point_float_buffer_t*
+    buffer, size_t num_points) {
+  if (num_points == buffer->num_points)
+    return;
+
+  if (num_points) {
+    buffer->x = realloc(buffer->x, num_points*sizeof(float));
+    buffer->y = realloc(buffer->y, num_points*sizeof(float));
+    buffer->z = realloc(buffer->z, num_points*sizeof(float));
+  }
+  else {
+    free(buffer->x);
+    free(buffer->y);
+    free(buffer->z);
+
+    buffer->x = 0;
+    buffer->y = 0;
+    buffer->z = 0;
+  }
+
+  buffer->num_points = num_points;
+}
+
+void transform_point_float_buffer_set_points(transform_point_float_buffer_t*
+    buffer, const transform_point_float_t* points, size_t num_points) {
+  size_t i;
+
+  transform_point_float_buffer_resize(buffer, num_points);
+
+  for (i = 0; i < num_points; ++i) {
+    buffer->x[i] = points[i].x;
+    buffer->y[i] = points[i].y;
+    buffer->z[i] = points[i].z;
+  }
+}
+
+void transform_point_float_buffer_get_points(const
+    transform_point_float_buffer_t* buffer, transform_point_float_t* points) {
+  size_t i;
+
+  for (i = 0; i < buffer->num_points; ++i) {
+    points[i].x = buffer->x[i];
+    points[i].y = buffer->y[i];
+    points[i].z = buffer->z[i];
+  }
+}
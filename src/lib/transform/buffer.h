@@ -0,0 +1,150 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_BUFFER_H
+#define TRANSFORM_BUFFER_H
+
+#include <stdlib.h>
+
+#include "transform/point.h"
+
+/** \file transform/buffer.h
+  * \ingroup transform
+  * \brief Point buffer definition for the linear transformation module
+  * \author Ralf Kaestner
+  *
+  * A point buffer stores the components of an array of points in three
+  * separate arrays, such that consecutive points can be loaded into
+  * vector registers and transformed together. Point buffers are provided
+  * in double and single precision.
+  */
+
+/** \brief Structure defining a point buffer
+  *
+  * A point buffer is defined by the arrays of x, y, and z-components of
+  * its points.
+  */
+typedef struct transform_point_buffer_t {
+  double* x;                   //!< The x-components of the points.
+  double* y;                   //!< The y-components of the points.
+  double* z;                   //!< The z-components of the points.
+
+  size_t num_points;           //!< The number of points in the buffer.
+} transform_point_buffer_t;
+
+/** \brief Initialize an empty point buffer
+  * \param[in] buffer The point buffer to be initialized.
+  */
+void transform_point_buffer_init(
+  transform_point_buffer_t* buffer);
+
+/** \brief Destroy a point buffer
+  * \param[in] buffer The point buffer to be destroyed.
+  */
+void transform_point_buffer_destroy(
+  transform_point_buffer_t* buffer);
+
+/** \brief Resize a point buffer
+  * \param[in] buffer The point buffer to be resized.
+  * \param[in] num_points The new number of points in the buffer. The
+  *   components of points beyond the previous size are undefined.
+  */
+void transform_point_buffer_resize(
+  transform_point_buffer_t* buffer,
+  size_t num_points);
+
+/** \brief Copy an array of points into a point buffer
+  * \param[in] buffer The point buffer which will be resized to hold the
+  *   points.
+  * \param[in] points The array of points to be copied into the buffer.
+  * \param[in] num_points The number of points in the array.
+  */
+void transform_point_buffer_set_points(
+  transform_point_buffer_t* buffer,
+  const transform_point_t* points,
+  size_t num_points);
+
+/** \brief Copy the points of a point buffer into an array
+  * \param[in] buffer The point buffer to copy the points from.
+  * \param[out] points The array of points the buffer will be copied to.
+  *   The array must hold at least the number of points in the buffer.
+  */
+void transform_point_buffer_get_points(
+  const transform_point_buffer_t* buffer,
+  transform_point_t* points);
+
+/** \brief Structure defining a single-precision point buffer
+  *
+  * A single-precision point buffer is defined by the arrays of x, y, and
+  * z-components of its points.
+  */
+typedef struct transform_point_float_buffer_t {
+  float* x;                    //!< The x-components of the points.
+  float* y;                    //!< The y-components of the points.
+  float* z;                    //!< The z-components of the points.
+
+  size_t num_points;           //!< The number of points in the buffer.
+} transform_point_float_buffer_t;
+
+/** \brief Initialize an empty single-precision point buffer
+  * \param[in] buffer The single-precision point buffer to be initialized.
+  */
+void transform_point_float_buffer_init(
+  transform_point_float_buffer_t* buffer);
+
+/** \brief Destroy a single-precision point buffer
+  * \param[in] buffer The single-precision point buffer to be destroyed.
+  */
+void transform_point_float_buffer_destroy(
+  transform_point_float_buffer_t* buffer);
+
+/** \brief Resize a single-precision point buffer
+  * \param[in] buffer The single-precision point buffer to be resized.
+  * \param[in] num_points The new number of points in the buffer. The
+  *   components of points beyond the previous size are undefined.
+  */
+void transform_point_float_buffer_resize(
+  transform_point_float_buffer_t* buffer,
+  size_t num_points);
+
+/** \brief Copy an array of points into a single-precision point buffer
+  * \param[in] buffer The single-precision point buffer which will be
+  *   resized to hold the points.
+  * \param[in] points The array of single-precision points to be copied
+  *   into the buffer.
+  * \param[in] num_points The number of points in the array.
+  */
+void transform_point_float_buffer_set_points(
+  transform_point_float_buffer_t* buffer,
+  const transform_point_float_t* points,
+  size_t num_points);
+
+/** \brief Copy the points of a single-precision point buffer into an array
+  * \param[in] buffer The single-precision point buffer to copy the points
+  *   from.
+  * \param[out] points The array of single-precision points the buffer will
+  *   be copied to. The array must hold at least the number of points in
+  *   the buffer.
+  */
+void transform_point_float_buffer_get_points(
+  const transform_point_float_buffer_t* buffer,
+  transform_point_float_t* points);
+
+#endif
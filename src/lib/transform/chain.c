@@ -0,0 +1,304 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <math.h>
+
+#include "chain.h"
+
+const char* transform_chain_errors[] = {
+  "Success",
+  "Invalid joint",
+  "Invalid joint axis",
+};
+
+void transform_joint_init_dh(transform_joint_t* joint, transform_joint_type_t
+    type, double a, double alpha, double d, double theta) {
+  double cos_alpha = cos(alpha), sin_alpha = sin(alpha);
+
+  joint->type = type;
+  joint->model = transform_joint_model_dh;
+
+  joint->a = a;
+  joint->alpha = alpha;
+  joint->d = d;
+  joint->theta = theta;
+
+  joint->origin[0][0] = 1.0;
+  joint->origin[0][1] = 0.0;
+  joint->origin[0][2] = 0.0;
+  joint->origin[0][3] = a;
+
+  joint->origin[1][0] = 0.0;
+  joint->origin[1][1] = cos_alpha;
+  joint->origin[1][2] = -sin_alpha;
+  joint->origin[1][3] = 0.0;
+
+  joint->origin[2][0] = 0.0;
+  joint->origin[2][1] = sin_alpha;
+  joint->origin[2][2] = cos_alpha;
+  joint->origin[2][3] = 0.0;
+
+  transform_point_init(&joint->axis, 0.0, 0.0, 1.0);
+}
+
+void transform_joint_init_axis(transform_joint_t* joint,
+    transform_joint_type_t type, transform_t origin, const transform_point_t*
+    axis) {
+  double norm = sqrt(axis->x*axis->x+axis->y*axis->y+axis->z*axis->z);
+
+  joint->type = type;
+  joint->model = transform_joint_model_axis;
+
+  joint->a = 0.0;
+  joint->alpha = 0.0;
+  joint->d = 0.0;
+  joint->theta = 0.0;
+
+  transform_affine_init_transform(joint->origin, origin);
+
+  if (norm > 0.0)
+    transform_point_init(&joint->axis, axis->x/norm, axis->y/norm,
+      axis->z/norm);
+  else
+    transform_point_init(&joint->axis, 0.0, 0.0, 0.0);
+}
+
+void transform_joint_get_link(const transform_joint_t* joint, double
+    position, transform_affine_t affine) {
+  const double (*o)[4] = joint->origin;
+  int i, j;
+
+  if (joint->model == transform_joint_model_dh) {
+    double theta = joint->theta, d = joint->d;
+    double cos_theta, sin_theta;
+
+    if (joint->type == transform_joint_revolute)
+      theta += position;
+    else if (joint->type == transform_joint_prismatic)
+      d += position;
+    cos_theta = cos(theta);
+    sin_theta = sin(theta);
+
+    for (j = 0; j < 4; ++j) {
+      affine[0][j] = cos_theta*o[0][j]-sin_theta*o[1][j];
+      affine[1][j] = sin_theta*o[0][j]+cos_theta*o[1][j];
+      affine[2][j] = o[2][j];
+    }
+    affine[2][3] += d;
+  }
+  else if (joint->type == transform_joint_revolute) {
+    double k[3] = {joint->axis.x, joint->axis.y, joint->axis.z};
+    double c = cos(position), s = sin(position), v = 1.0-c;
+    double r[3][3] = {
+      {c+v*k[0]*k[0], v*k[0]*k[1]-s*k[2], v*k[0]*k[2]+s*k[1]},
+      {v*k[1]*k[0]+s*k[2], c+v*k[1]*k[1], v*k[1]*k[2]-s*k[0]},
+      {v*k[2]*k[0]-s*k[1], v*k[2]*k[1]+s*k[0], c+v*k[2]*k[2]},
+    };
+
+    for (i = 0; i < 3; ++i) {
+      for (j = 0; j < 3; ++j)
+        affine[i][j] = o[i][0]*r[0][j]+o[i][1]*r[1][j]+o[i][2]*r[2][j];
+      affine[i][3] = o[i][3];
+    }
+  }
+  else {
+    double t[3] = {0.0, 0.0, 0.0};
+
+    if (joint->type == transform_joint_prismatic) {
+      t[0] = position*joint->axis.x;
+      t[1] = position*joint->axis.y;
+      t[2] = position*joint->axis.z;
+    }
+
+    for (i = 0; i < 3; ++i) {
+      for (j = 0; j < 3; ++j)
+        affine[i][j] = o[i][j];
+      affine[i][3] = o[i][0]*t[0]+o[i][1]*t[1]+o[i][2]*t[2]+o[i][3];
+    }
+  }
+}
+
+void transform_chain_init(transform_chain_t* chain) {
+  chain->joints = 0;
+  chain->positions = 0;
+  chain->links = 0;
+  chain->prefix = 0;
+  chain->num_joints = 0;
+  chain->num_valid = 0;
+
+  error_init(&chain->error, transform_chain_errors);
+}
+
+void transform_chain_destroy(transform_chain_t* chain) {
+  if (chain->joints) {
+    free(chain->joints);
+    free(chain->positions);
+    free(chain->links);
+    free(chain->prefix);
+
+    chain->joints = 0;
+    chain->positions = 0;
+    chain->links = 0;
+    chain->prefix = 0;
+    chain->num_joints = 0;
+    chain->num_valid = 0;
+  }
+
+  error_destroy(&chain->error);
+}
+
+ssize_t transform_chain_add(transform_chain_t* chain, const
+    transform_joint_t* joint) {
+  size_t n = chain->num_joints+1;
+
+  error_clear(&chain->error);
+
+  if ((joint->model == transform_joint_model_axis) &&
+      (joint->type != transform_joint_fixed) &&
+      (joint->axis.x == 0.0) && (joint->axis.y == 0.0) &&
+      (joint->axis.z == 0.0)) {
+    error_set(&chain->error, TRANSFORM_CHAIN_ERROR_AXIS);
+    return -TRANSFORM_CHAIN_ERROR_AXIS;
+  }
+
+  chain->joints = realloc(chain->joints, n*sizeof(transform_joint_t));
+  chain->positions = realloc(chain->positions, n*sizeof(double));
+  chain->links = realloc(chain->links, n*sizeof(transform_affine_t));
+  chain->prefix = realloc(chain->prefix, n*sizeof(transform_affine_t));
+
+  chain->joints[n-1] = *joint;
+  chain->positions[n-1] = 0.0;
+  transform_joint_get_link(joint, 0.0, chain->links[n-1]);
+
+  return chain->num_joints++;
+}
+
+int transform_chain_set_position(transform_chain_t* chain, size_t joint,
+    double position) {
+  error_clear(&chain->error);
+
+  if (joint >= chain->num_joints) {
+    error_set(&chain->error, TRANSFORM_CHAIN_ERROR_JOINT);
+    return TRANSFORM_CHAIN_ERROR_JOINT;
+  }
+
+  if (chain->positions[joint] != position) {
+    chain->positions[joint] = position;
+    transform_joint_get_link(&chain->joints[joint], position,
+      chain->links[joint]);
+
+    if (joint < chain->num_valid)
+      chain->num_valid = joint;
+  }
+
+  return TRANSFORM_CHAIN_ERROR_NONE;
+}
+
+void transform_chain_set_positions(transform_chain_t* chain, const double*
+    positions) {
+  size_t i;
+
+  for (i = 0; i < chain->num_joints; ++i)
+    transform_chain_set_position(chain, i, positions[i]);
+}
+
+int transform_chain_get(transform_chain_t* chain, size_t joint,
+    transform_t transform) {
+  size_t i;
+
+  error_clear(&chain->error);
+
+  if (joint >= chain->num_joints) {
+    error_set(&chain->error, TRANSFORM_CHAIN_ERROR_JOINT);
+    return TRANSFORM_CHAIN_ERROR_JOINT;
+  }
+
+  for (i = chain->num_valid; i <= joint; ++i) {
+    transform_affine_copy(chain->prefix[i], chain->links[i]);
+    if (i > 0)
+      transform_affine_multiply_left(chain->prefix[i], chain->prefix[i-1]);
+  }
+  if (joint >= chain->num_valid)
+    chain->num_valid = joint+1;
+
+  transform_affine_to_transform(chain->prefix[joint], transform);
+
+  return TRANSFORM_CHAIN_ERROR_NONE;
+}
+
+int transform_chain_get_end(transform_chain_t* chain, transform_t
+    transform) {
+  if (!chain->num_joints) {
+    error_set(&chain->error, TRANSFORM_CHAIN_ERROR_JOINT);
+    return TRANSFORM_CHAIN_ERROR_JOINT;
+  }
+
+  return transform_chain_get(chain, chain->num_joints-1, transform);
+}
+
+ssize_t transform_chain_eval(transform_chain_t* chain, const double*
+    positions, transform_t* transforms, size_t num_configurations) {
+  transform_affine_t prefix[TRANSFORM_CHAIN_BLOCK_SIZE];
+  transform_affine_t link;
+  size_t n = chain->num_joints, i, j, k;
+
+  error_clear(&chain->error);
+
+  if (!n) {
+    error_set(&chain->error, TRANSFORM_CHAIN_ERROR_JOINT);
+    return -TRANSFORM_CHAIN_ERROR_JOINT;
+  }
+
+  for (i = 0; i < num_configurations; i += TRANSFORM_CHAIN_BLOCK_SIZE) {
+    size_t num_block = (num_configurations-i > TRANSFORM_CHAIN_BLOCK_SIZE) ?
+      TRANSFORM_CHAIN_BLOCK_SIZE : num_configurations-i;
+    const double* q = &positions[i*n];
+
+    for (j = 0; j < n; ++j) {
+      const transform_joint_t* joint = &chain->joints[j];
+
+      if (joint->type == transform_joint_fixed) {
+        transform_joint_get_link(joint, 0.0, link);
+
+        for (k = 0; k < num_block; ++k) {
+          transform_affine_t affine;
+
+          transform_affine_copy(affine, link);
+          if (j > 0)
+            transform_affine_multiply_left(affine, prefix[k]);
+          transform_affine_copy(prefix[k], affine);
+        }
+      }
+      else {
+        for (k = 0; k < num_block; ++k) {
+          transform_joint_get_link(joint, q[k*n+j], link);
+          if (j > 0)
+            transform_affine_multiply_left(link, prefix[k]);
+          transform_affine_copy(prefix[k], link);
+        }
+      }
+    }
+
+    for (k = 0; k < num_block; ++k)
+      transform_affine_to_transform(prefix[k], transforms[i+k]);
+  }
+
+  return num_configurations;
+}
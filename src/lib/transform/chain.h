@@ -0,0 +1,264 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_CHAIN_H
+#define TRANSFORM_CHAIN_H
+
+/** \file transform/chain.h
+  * \ingroup transform
+  * \brief Kinematic chain for the linear transformation module
+  * \author Ralf Kaestner
+  *
+  * A kinematic chain is a serial sequence of joints, each of which
+  * contributes a link transform depending on its joint position. The
+  * transforms of the links relative to the base of the chain are cached
+  * as prefix products. Changing the position of a joint invalidates the
+  * cached transforms from this joint outward only, such that forward
+  * kinematics after a change to joint k cost N-k affine multiplications.
+  */
+
+#include <stdlib.h>
+
+#include "transform/affine.h"
+
+#include "error/error.h"
+
+/** \name Constants
+  * \brief Predefined kinematic chain constants
+  */
+//@{
+#define TRANSFORM_CHAIN_BLOCK_SIZE         64
+//!< The number of configurations evaluated per block in batch mode
+//@}
+
+/** \name Error Codes
+  * \brief Predefined kinematic chain error codes
+  */
+//@{
+#define TRANSFORM_CHAIN_ERROR_NONE         0
+//!< Success
+#define TRANSFORM_CHAIN_ERROR_JOINT        1
+//!< Invalid joint
+#define TRANSFORM_CHAIN_ERROR_AXIS         2
+//!< Invalid joint axis
+//@}
+
+/** \brief Predefined kinematic chain error descriptions
+  */
+extern const char* transform_chain_errors[];
+
+/** \brief Joint type
+  */
+typedef enum {
+  transform_joint_revolute,       //!< Rotation by the joint position.
+  transform_joint_prismatic,      //!< Translation by the joint position.
+  transform_joint_fixed,          //!< No motion.
+} transform_joint_type_t;
+
+/** \brief Joint model
+  */
+typedef enum {
+  transform_joint_model_dh,       //!< Denavit-Hartenberg parameters.
+  transform_joint_model_axis,     //!< Fixed origin and joint axis.
+} transform_joint_model_t;
+
+/** \brief Structure defining a joint
+  *
+  * A Denavit-Hartenberg joint contributes the link transform
+  * Rot_z(theta) Trans_z(d) Trans_x(a) Rot_x(alpha), where the joint
+  * position is added to theta for revolute and to d for prismatic
+  * joints. A general joint contributes the link transform of its fixed
+  * origin, followed by a rotation about or a translation along its unit
+  * joint axis by the joint position.
+  */
+typedef struct transform_joint_t {
+  transform_joint_type_t type;    //!< The type of the joint.
+  transform_joint_model_t model;  //!< The model of the joint.
+
+  double a;                       //!< The DH link length.
+  double alpha;                   //!< The DH link twist in [rad].
+  double d;                       //!< The DH link offset.
+  double theta;                   //!< The DH joint angle in [rad].
+
+  transform_affine_t origin;      //!< The fixed part of the link transform.
+  transform_point_t axis;         //!< The unit axis of a general joint.
+} transform_joint_t;
+
+/** \brief Structure defining a kinematic chain
+  *
+  * The link transform of joint k maps coordinates in the frame of link k
+  * to coordinates in the frame of link k-1, where link -1 is the base of
+  * the chain. Joints are identified by their index in the chain.
+  */
+typedef struct transform_chain_t {
+  transform_joint_t* joints;      //!< The joints of the chain.
+  double* positions;              //!< The positions of the joints.
+  transform_affine_t* links;      //!< The link transforms of the joints.
+  transform_affine_t* prefix;     //!< The cached base transforms of the links.
+  size_t num_joints;              //!< The number of joints in the chain.
+  size_t num_valid;               //!< The number of valid cached transforms.
+
+  error_t error;                  //!< The most recent kinematic chain error.
+} transform_chain_t;
+
+/** \brief Initialize Denavit-Hartenberg joint
+  * \param[in] joint The joint to be initialized.
+  * \param[in] type The type of the joint.
+  * \param[in] a The link length along the x-axis.
+  * \param[in] alpha The link twist about the x-axis in [rad].
+  * \param[in] d The link offset along the z-axis.
+  * \param[in] theta The joint angle about the z-axis in [rad].
+  */
+void transform_joint_init_dh(
+  transform_joint_t* joint,
+  transform_joint_type_t type,
+  double a,
+  double alpha,
+  double d,
+  double theta);
+
+/** \brief Initialize general joint
+  * \param[in] joint The joint to be initialized.
+  * \param[in] type The type of the joint.
+  * \param[in] origin The affine transform of the joint origin relative to
+  *   the previous link. The last row of the transform is ignored.
+  * \param[in] axis The joint axis in coordinates of the joint origin. The
+  *   axis will be normalized and must therefore be non-zero for revolute
+  *   and prismatic joints.
+  */
+void transform_joint_init_axis(
+  transform_joint_t* joint,
+  transform_joint_type_t type,
+  transform_t origin,
+  const transform_point_t* axis);
+
+/** \brief Compute the link transform of a joint
+  * \param[in] joint The joint to compute the link transform for.
+  * \param[in] position The position of the joint.
+  * \param[out] affine The link transform of the joint at the given
+  *   position.
+  *
+  * Revolute joints require a single sine and cosine evaluation.
+  */
+void transform_joint_get_link(
+  const transform_joint_t* joint,
+  double position,
+  transform_affine_t affine);
+
+/** \brief Initialize an empty kinematic chain
+  * \param[in] chain The kinematic chain to be initialized.
+  */
+void transform_chain_init(
+  transform_chain_t* chain);
+
+/** \brief Destroy a kinematic chain
+  * \param[in] chain The kinematic chain to be destroyed.
+  */
+void transform_chain_destroy(
+  transform_chain_t* chain);
+
+/** \brief Append a joint to the kinematic chain
+  * \param[in,out] chain The kinematic chain to append the joint to.
+  * \param[in] joint The joint to be appended. Its initial position is
+  *   zero.
+  * \return The index of the appended joint or the negative error code.
+  */
+ssize_t transform_chain_add(
+  transform_chain_t* chain,
+  const transform_joint_t* joint);
+
+/** \brief Set the position of a joint
+  * \param[in,out] chain The kinematic chain containing the joint.
+  * \param[in] joint The index of the joint.
+  * \param[in] position The new position of the joint.
+  * \return The resulting error code.
+  *
+  * If the position changes, the link transform of the joint is
+  * recomputed and the cached transforms from this joint outward are
+  * invalidated.
+  */
+int transform_chain_set_position(
+  transform_chain_t* chain,
+  size_t joint,
+  double position);
+
+/** \brief Set the positions of all joints
+  * \param[in,out] chain The kinematic chain to be updated.
+  * \param[in] positions The new positions of the joints, an array
+  *   holding one position per joint of the chain.
+  *
+  * Only the link transforms of joints whose position changes are
+  * recomputed, and only cached transforms outward of the innermost
+  * changed joint are invalidated.
+  */
+void transform_chain_set_positions(
+  transform_chain_t* chain,
+  const double* positions);
+
+/** \brief Retrieve the base transform of a link
+  * \param[in,out] chain The kinematic chain containing the link.
+  * \param[in] joint The index of the joint moving the link.
+  * \param[out] transform The transform mapping coordinates in the frame
+  *   of the link to coordinates in the base frame of the chain.
+  * \return The resulting error code.
+  *
+  * On a cache miss, the transform is composed from the outermost valid
+  * cached transform, requiring one affine multiplication per invalid
+  * link up to the requested one.
+  */
+int transform_chain_get(
+  transform_chain_t* chain,
+  size_t joint,
+  transform_t transform);
+
+/** \brief Retrieve the base transform of the end link
+  * \param[in,out] chain The non-empty kinematic chain.
+  * \param[out] transform The transform mapping coordinates in the frame
+  *   of the end link to coordinates in the base frame of the chain.
+  * \return The resulting error code.
+  */
+int transform_chain_get_end(
+  transform_chain_t* chain,
+  transform_t transform);
+
+/** \brief Evaluate the end transforms of many configurations
+  * \param[in] chain The non-empty kinematic chain to be evaluated.
+  * \param[in] positions The joint positions of the configurations, an
+  *   array holding the N positions of each configuration consecutively,
+  *   where N is the number of joints in the chain.
+  * \param[out] transforms The transforms mapping coordinates in the frame
+  *   of the end link to coordinates in the base frame of the chain, one
+  *   per configuration.
+  * \param[in] num_configurations The number of configurations.
+  * \return The number of evaluated configurations or the negative error
+  *   code.
+  *
+  * Configurations are processed in blocks of TRANSFORM_CHAIN_BLOCK_SIZE,
+  * iterating joints in the outer and configurations in the inner loop,
+  * such that each joint is dispatched once per block. The cached state
+  * of the chain remains unmodified.
+  */
+ssize_t transform_chain_eval(
+  transform_chain_t* chain,
+  const double* positions,
+  transform_t* transforms,
+  size_t num_configurations);
+
+#endif
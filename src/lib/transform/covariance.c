@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "covariance.h"
+
+static void transform_covariance_pack(const double* matrix, size_t dim, double*
+    covariance) {
+  size_t i, j, k = 0;
+
+  for (i = 0; i < dim; ++i)
+    for (j = i; j < dim; ++j)
+      covariance[k++] = matrix[i*dim+j];
+}
+
+static void transform_covariance_unpack(const double* covariance, size_t dim,
+    double* matrix) {
+  size_t i, j, k = 0;
+
+  for (i = 0; i < dim; ++i)
+    for (j = i; j < dim; ++j, ++k)
+      matrix[i*dim+j] = matrix[j*dim+i] = covariance[k];
+}
+
+static void transform_covariance_get_map(const double* m, size_t dim,
+    double* a) {
+  size_t r, s, i, j, k = 0;
+
+  for (r = 0; r < dim; ++r)
+    for (s = r; s < dim; ++s)
+      for (i = 0; i < dim; ++i)
+        for (j = i; j < dim; ++j, ++k) {
+          a[k] = m[r*dim+i]*m[s*dim+j];
+          if (j != i)
+            a[k] += m[r*dim+j]*m[s*dim+i];
+        }
+}
+
+void transform_covariance_init(transform_covariance_t covariance, double
+    (*matrix)[3]) {
+  transform_covariance_pack(matrix[0], 3, covariance);
+}
+
+void transform_covariance_get_matrix(const transform_covariance_t
+    covariance, double (*matrix)[3]) {
+  transform_covariance_unpack(covariance, 3, matrix[0]);
+}
+
+void transform_pose_covariance_init(transform_pose_covariance_t covariance,
+    double (*matrix)[6]) {
+  transform_covariance_pack(matrix[0], 6, covariance);
+}
+
+void transform_pose_covariance_get_matrix(const transform_pose_covariance_t
+    covariance, double (*matrix)[6]) {
+  transform_covariance_unpack(covariance, 6, matrix[0]);
+}
+
+void transform_get_adjoint(transform_t transform, double (*adjoint)[6]) {
+  double t_x = transform[0][3], t_y = transform[1][3], t_z = transform[2][3];
+  int i, j;
+
+  for (j = 0; j < 3; ++j) {
+    double r_0 = transform[0][j], r_1 = transform[1][j],
+      r_2 = transform[2][j];
+
+    for (i = 0; i < 3; ++i) {
+      adjoint[i][j] = adjoint[i+3][j+3] = transform[i][j];
+      adjoint[i+3][j] = 0.0;
+    }
+
+    adjoint[0][j+3] = t_y*r_2-t_z*r_1;
+    adjoint[1][j+3] = t_z*r_0-t_x*r_2;
+    adjoint[2][j+3] = t_x*r_1-t_y*r_0;
+  }
+}
+
+void transform_covariances_rotate(transform_t transform, const
+    transform_covariance_t* covariances, transform_covariance_t* result,
+    size_t num_covariances) {
+  double m[3][3], a[6*6];
+  int i, j;
+
+  for (i = 0; i < 3; ++i)
+    for (j = 0; j < 3; ++j)
+      m[i][j] = transform[i][j];
+  transform_covariance_get_map(m[0], 3, a);
+
+  transform_simd_get_linear_kernel()(a, 0, 6, covariances[0], result[0],
+    num_covariances);
+}
+
+void transform_pose_covariances_transform(transform_t transform, const
+    transform_pose_covariance_t* covariances, transform_pose_covariance_t*
+    result, size_t num_covariances) {
+  double adjoint[6][6], a[21*21];
+
+  transform_get_adjoint(transform, adjoint);
+  transform_covariance_get_map(adjoint[0], 6, a);
+
+  transform_simd_get_linear_kernel()(a, 0, 21, covariances[0], result[0],
+    num_covariances);
+}
+
+void transform_pose_covariances_compose(transform_t transform, const
+    transform_pose_covariance_t covariance, const
+    transform_pose_covariance_t* covariances, transform_pose_covariance_t*
+    result, size_t num_covariances) {
+  double adjoint[6][6], a[21*21];
+
+  transform_get_adjoint(transform, adjoint);
+  transform_covariance_get_map(adjoint[0], 6, a);
+
+  transform_simd_get_linear_kernel()(a, covariance, 21, covariances[0],
+    result[0], num_covariances);
+}
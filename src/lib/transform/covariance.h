@@ -0,0 +1,154 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_COVARIANCE_H
+#define TRANSFORM_COVARIANCE_H
+
+/** \file transform/covariance.h
+  * \ingroup transform
+  * \brief Covariance propagation for the linear transformation module
+  * \author Ralf Kaestner
+  *
+  * Covariance matrices are stored packed, holding the upper triangle of
+  * the symmetric matrix in row-major order. Since the congruence
+  * transformation M*S*M^T is linear in the packed entries of S, it is
+  * expressed as a single matrix acting on packed covariances and applied
+  * to arrays of covariances by the vectorized linear map kernels.
+  *
+  * Pose covariances refer to the perturbation (p, r) of a pose, where p
+  * denotes the translational and r the rotational part, both expressed in
+  * the parent frame of the pose and applied from the left.
+  */
+
+#include <stdlib.h>
+
+#include "transform/transform.h"
+
+/** \brief Structure defining a packed point covariance
+  *
+  * A packed point covariance holds the entries (xx, xy, xz, yy, yz, zz)
+  * of a symmetric 3x3 covariance matrix.
+  */
+typedef double transform_covariance_t[6];
+
+/** \brief Structure defining a packed pose covariance
+  *
+  * A packed pose covariance holds the 21 upper triangular entries of a
+  * symmetric 6x6 covariance matrix in row-major order, where rows and
+  * columns refer to the translations along and the rotations about the
+  * x, y, and z-axis.
+  */
+typedef double transform_pose_covariance_t[21];
+
+/** \brief Initialize packed point covariance from matrix
+  * \param[in] covariance The packed point covariance to be initialized.
+  * \param[in] matrix The symmetric 3x3 covariance matrix, of which only
+  *   the upper triangle will be accessed.
+  */
+void transform_covariance_init(
+  transform_covariance_t covariance,
+  double (*matrix)[3]);
+
+/** \brief Retrieve the matrix of a packed point covariance
+  * \param[in] covariance The packed point covariance.
+  * \param[out] matrix The symmetric 3x3 covariance matrix.
+  */
+void transform_covariance_get_matrix(
+  const transform_covariance_t covariance,
+  double (*matrix)[3]);
+
+/** \brief Initialize packed pose covariance from matrix
+  * \param[in] covariance The packed pose covariance to be initialized.
+  * \param[in] matrix The symmetric 6x6 covariance matrix, of which only
+  *   the upper triangle will be accessed.
+  */
+void transform_pose_covariance_init(
+  transform_pose_covariance_t covariance,
+  double (*matrix)[6]);
+
+/** \brief Retrieve the matrix of a packed pose covariance
+  * \param[in] covariance The packed pose covariance.
+  * \param[out] matrix The symmetric 6x6 covariance matrix.
+  */
+void transform_pose_covariance_get_matrix(
+  const transform_pose_covariance_t covariance,
+  double (*matrix)[6]);
+
+/** \brief Compute the adjoint of a rigid transform
+  * \param[in] transform The rigid transform [R t].
+  * \param[out] adjoint The 6x6 adjoint matrix [R [t]x*R; 0 R], which maps
+  *   pose perturbations in the child frame of the transform to pose
+  *   perturbations in its parent frame.
+  */
+void transform_get_adjoint(
+  transform_t transform,
+  double (*adjoint)[6]);
+
+/** \brief Rotate array of packed point covariances
+  * \param[in] transform The transform, of which the linear part A will be
+  *   applied to the covariances.
+  * \param[in] covariances The array of packed point covariances S.
+  * \param[out] result The array of packed covariances A*S*A^T. The array
+  *   may be identical to the input array, but must not overlap it
+  *   otherwise.
+  * \param[in] num_covariances The number of covariances in the arrays.
+  */
+void transform_covariances_rotate(
+  transform_t transform,
+  const transform_covariance_t* covariances,
+  transform_covariance_t* result,
+  size_t num_covariances);
+
+/** \brief Transform array of packed pose covariances
+  * \param[in] transform The rigid transform T mapping the child frame of
+  *   the poses to another frame.
+  * \param[in] covariances The array of packed pose covariances S of the
+  *   poses in the child frame of the transform.
+  * \param[out] result The array of packed pose covariances Ad(T)*S*Ad(T)^T
+  *   of the poses in the parent frame of the transform. The array may be
+  *   identical to the input array, but must not overlap it otherwise.
+  * \param[in] num_covariances The number of covariances in the arrays.
+  */
+void transform_pose_covariances_transform(
+  transform_t transform,
+  const transform_pose_covariance_t* covariances,
+  transform_pose_covariance_t* result,
+  size_t num_covariances);
+
+/** \brief Propagate packed pose covariances through composition
+  * \param[in] transform The rigid transform T_1 which is left-multiplied
+  *   with the poses T_2.
+  * \param[in] covariance The packed pose covariance S_1 of T_1.
+  * \param[in] covariances The array of packed pose covariances S_2 of the
+  *   poses T_2.
+  * \param[out] result The array of packed pose covariances of the
+  *   composed poses T_1*T_2, given to first order by
+  *   S_1+Ad(T_1)*S_2*Ad(T_1)^T for independent T_1 and T_2. The array may
+  *   be identical to the input array, but must not overlap it otherwise.
+  * \param[in] num_covariances The number of covariances in the arrays.
+  */
+void transform_pose_covariances_compose(
+  transform_t transform,
+  const transform_pose_covariance_t covariance,
+  const transform_pose_covariance_t* covariances,
+  transform_pose_covariance_t* result,
+  size_t num_covariances);
+
+#endif
@@ -0,0 +1,212 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "frame.h"
+
+#include "string/string.h"
+
+const char* transform_frame_errors[] = {
+  "Success",
+  "Invalid or duplicate frame name",
+  "Invalid parent frame",
+  "Invalid frame",
+};
+
+void transform_frame_tree_init(transform_frame_tree_t* tree) {
+  tree->frames = 0;
+  tree->num_frames = 0;
+
+  error_init(&tree->error, transform_frame_errors);
+}
+
+void transform_frame_tree_destroy(transform_frame_tree_t* tree) {
+  size_t i;
+
+  for (i = 0; i < tree->num_frames; ++i)
+    string_destroy(&tree->frames[i].name);
+
+  if (tree->frames) {
+    free(tree->frames);
+
+    tree->frames = 0;
+    tree->num_frames = 0;
+  }
+
+  error_destroy(&tree->error);
+}
+
+ssize_t transform_frame_tree_add(transform_frame_tree_t* tree, const char*
+    name, const char* parent, transform_t transform) {
+  ssize_t parent_index = -1;
+  transform_frame_t* frame;
+
+  error_clear(&tree->error);
+
+  if (string_empty(name)) {
+    error_set(&tree->error, TRANSFORM_FRAME_ERROR_NAME);
+    return -TRANSFORM_FRAME_ERROR_NAME;
+  }
+  else if (transform_frame_tree_find(tree, name) >= 0) {
+    error_setf(&tree->error, TRANSFORM_FRAME_ERROR_NAME, "%s", name);
+    return -TRANSFORM_FRAME_ERROR_NAME;
+  }
+  error_clear(&tree->error);
+
+  if (!string_empty(parent) &&
+      ((parent_index = transform_frame_tree_find(tree, parent)) < 0)) {
+    error_setf(&tree->error, TRANSFORM_FRAME_ERROR_PARENT, "%s", parent);
+    return -TRANSFORM_FRAME_ERROR_PARENT;
+  }
+
+  tree->frames = realloc(tree->frames, (tree->num_frames+1)*
+    sizeof(transform_frame_t));
+  frame = &tree->frames[tree->num_frames];
+
+  string_init_copy(&frame->name, name);
+  frame->parent = parent_index;
+  frame->first_child = -1;
+  frame->next_sibling = -1;
+
+  if (parent_index >= 0) {
+    frame->next_sibling = tree->frames[parent_index].first_child;
+    tree->frames[parent_index].first_child = tree->num_frames;
+  }
+
+  transform_affine_init_transform(frame->transform, transform);
+  frame->world_valid = 0;
+  frame->world_inverse_valid = 0;
+
+  return tree->num_frames++;
+}
+
+ssize_t transform_frame_tree_find(transform_frame_tree_t* tree, const char*
+    name) {
+  size_t i;
+
+  if (string_empty(name)) {
+    error_set(&tree->error, TRANSFORM_FRAME_ERROR_NAME);
+    return -TRANSFORM_FRAME_ERROR_NAME;
+  }
+
+  for (i = 0; i < tree->num_frames; ++i)
+    if (string_equal(tree->frames[i].name, name))
+      return i;
+
+  error_setf(&tree->error, TRANSFORM_FRAME_ERROR_NAME, "%s", name);
+  return -TRANSFORM_FRAME_ERROR_NAME;
+}
+
+static void transform_frame_tree_invalidate(transform_frame_tree_t* tree, size_t
+    frame) {
+  ssize_t child;
+
+  if (!tree->frames[frame].world_valid)
+    return;
+
+  tree->frames[frame].world_valid = 0;
+  tree->frames[frame].world_inverse_valid = 0;
+
+  for (child = tree->frames[frame].first_child; child >= 0;
+      child = tree->frames[child].next_sibling)
+    transform_frame_tree_invalidate(tree, child);
+}
+
+static void transform_frame_tree_validate(transform_frame_tree_t* tree, size_t
+    frame) {
+  transform_frame_t* f = &tree->frames[frame];
+
+  if (f->world_valid)
+    return;
+
+  transform_affine_copy(f->world, f->transform);
+  if (f->parent >= 0) {
+    transform_frame_tree_validate(tree, f->parent);
+    transform_affine_multiply_left(f->world,
+      tree->frames[f->parent].world);
+  }
+
+  f->world_valid = 1;
+  f->world_inverse_valid = 0;
+}
+
+static void transform_frame_tree_validate_inverse(transform_frame_tree_t* tree,
+    size_t frame) {
+  transform_frame_t* f = &tree->frames[frame];
+
+  if (f->world_inverse_valid)
+    return;
+
+  transform_frame_tree_validate(tree, frame);
+  transform_affine_copy(f->world_inverse, f->world);
+  transform_affine_invert(f->world_inverse);
+
+  f->world_inverse_valid = 1;
+}
+
+int transform_frame_tree_set(transform_frame_tree_t* tree, size_t frame,
+    transform_t transform) {
+  error_clear(&tree->error);
+
+  if (frame >= tree->num_frames) {
+    error_set(&tree->error, TRANSFORM_FRAME_ERROR_FRAME);
+    return TRANSFORM_FRAME_ERROR_FRAME;
+  }
+
+  transform_affine_init_transform(tree->frames[frame].transform, transform);
+  transform_frame_tree_invalidate(tree, frame);
+
+  return TRANSFORM_FRAME_ERROR_NONE;
+}
+
+int transform_frame_tree_get_world(transform_frame_tree_t* tree, size_t
+    frame, transform_t transform) {
+  error_clear(&tree->error);
+
+  if (frame >= tree->num_frames) {
+    error_set(&tree->error, TRANSFORM_FRAME_ERROR_FRAME);
+    return TRANSFORM_FRAME_ERROR_FRAME;
+  }
+
+  transform_frame_tree_validate(tree, frame);
+  transform_affine_to_transform(tree->frames[frame].world, transform);
+
+  return TRANSFORM_FRAME_ERROR_NONE;
+}
+
+int transform_frame_tree_get(transform_frame_tree_t* tree, size_t source,
+    size_t target, transform_t transform) {
+  transform_affine_t affine;
+
+  error_clear(&tree->error);
+
+  if ((source >= tree->num_frames) || (target >= tree->num_frames)) {
+    error_set(&tree->error, TRANSFORM_FRAME_ERROR_FRAME);
+    return TRANSFORM_FRAME_ERROR_FRAME;
+  }
+
+  transform_frame_tree_validate(tree, source);
+  transform_frame_tree_validate_inverse(tree, target);
+
+  transform_affine_copy(affine, tree->frames[source].world);
+  transform_affine_multiply_left(affine, tree->frames[target].world_inverse);
+  transform_affine_to_transform(affine, transform);
+
+  return TRANSFORM_FRAME_ERROR_NONE;
+}
@@ -0,0 +1,173 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_FRAME_H
+#define TRANSFORM_FRAME_H
+
+/** \file transform/frame.h
+  * \ingroup transform
+  * \brief Coordinate frame tree for the linear transformation module
+  * \author Ralf Kaestner
+  *
+  * A frame tree maintains named coordinate frames, each of which is
+  * defined by its transform relative to a parent frame. The transforms
+  * of the frames relative to the world frame and their inverses are
+  * composed on demand and cached. Updating the transform of a frame
+  * invalidates the cached transforms of its subtree only.
+  */
+
+#include <stdlib.h>
+
+#include "transform/affine.h"
+
+#include "error/error.h"
+
+/** \name Error Codes
+  * \brief Predefined frame tree error codes
+  */
+//@{
+#define TRANSFORM_FRAME_ERROR_NONE         0
+//!< Success
+#define TRANSFORM_FRAME_ERROR_NAME         1
+//!< Invalid or duplicate frame name
+#define TRANSFORM_FRAME_ERROR_PARENT       2
+//!< Invalid parent frame
+#define TRANSFORM_FRAME_ERROR_FRAME        3
+//!< Invalid frame
+//@}
+
+/** \brief Predefined frame tree error descriptions
+  */
+extern const char* transform_frame_errors[];
+
+/** \brief Structure defining a coordinate frame
+  */
+typedef struct transform_frame_t {
+  char* name;                       //!< The name of the frame.
+  ssize_t parent;                   //!< The index of the parent frame.
+  ssize_t first_child;              //!< The index of the first child frame.
+  ssize_t next_sibling;             //!< The index of the next sibling frame.
+
+  transform_affine_t transform;     //!< The transform relative to the parent.
+  transform_affine_t world;         //!< The cached transform to the world.
+  transform_affine_t world_inverse; //!< The cached inverse world transform.
+
+  int world_valid;                  //!< Validity of the world transform.
+  int world_inverse_valid;          //!< Validity of the inverse transform.
+} transform_frame_t;
+
+/** \brief Structure defining a coordinate frame tree
+  *
+  * Frames are identified by their index in the tree, which may be looked
+  * up by name. Frames without parent are attached to the world frame.
+  */
+typedef struct transform_frame_tree_t {
+  transform_frame_t* frames;        //!< The frames of the tree.
+  size_t num_frames;                //!< The number of frames in the tree.
+
+  error_t error;                    //!< The most recent frame tree error.
+} transform_frame_tree_t;
+
+/** \brief Initialize an empty frame tree
+  * \param[in] tree The frame tree to be initialized.
+  */
+void transform_frame_tree_init(
+  transform_frame_tree_t* tree);
+
+/** \brief Destroy a frame tree
+  * \param[in] tree The frame tree to be destroyed.
+  */
+void transform_frame_tree_destroy(
+  transform_frame_tree_t* tree);
+
+/** \brief Add a frame to the frame tree
+  * \param[in,out] tree The frame tree to add the frame to.
+  * \param[in] name The unique and non-empty name of the frame.
+  * \param[in] parent The name of the parent frame. An empty parent name
+  *   attaches the frame to the world frame.
+  * \param[in] transform The affine transform of the frame relative to
+  *   its parent.
+  * \return The index of the added frame or the negative error code.
+  */
+ssize_t transform_frame_tree_add(
+  transform_frame_tree_t* tree,
+  const char* name,
+  const char* parent,
+  transform_t transform);
+
+/** \brief Find a frame in the frame tree
+  * \param[in] tree The frame tree to search.
+  * \param[in] name The name of the frame to be found.
+  * \return The index of the frame or the negative error code.
+  */
+ssize_t transform_frame_tree_find(
+  transform_frame_tree_t* tree,
+  const char* name);
+
+/** \brief Update the transform of a frame
+  * \param[in,out] tree The frame tree containing the frame.
+  * \param[in] frame The index of the frame to be updated.
+  * \param[in] transform The new affine transform of the frame relative
+  *   to its parent.
+  * \return The resulting error code.
+  *
+  * The cached transforms of the frame and its descendants are
+  * invalidated. Descendants whose cache is already invalid are skipped
+  * together with their subtrees.
+  */
+int transform_frame_tree_set(
+  transform_frame_tree_t* tree,
+  size_t frame,
+  transform_t transform);
+
+/** \brief Retrieve the world transform of a frame
+  * \param[in,out] tree The frame tree containing the frame.
+  * \param[in] frame The index of the frame.
+  * \param[out] transform The transform mapping coordinates in the frame
+  *   to world coordinates.
+  * \return The resulting error code.
+  *
+  * On a cache miss, the world transform is composed from the nearest
+  * ancestor with a valid cache in O(D) for a tree of depth D.
+  */
+int transform_frame_tree_get_world(
+  transform_frame_tree_t* tree,
+  size_t frame,
+  transform_t transform);
+
+/** \brief Retrieve the transform between two frames
+  * \param[in,out] tree The frame tree containing the frames.
+  * \param[in] source The index of the source frame.
+  * \param[in] target The index of the target frame.
+  * \param[out] transform The transform mapping coordinates in the source
+  *   frame to coordinates in the target frame.
+  * \return The resulting error code.
+  *
+  * The transform is composed from the cached world transform of the
+  * source frame and the cached inverse world transform of the target
+  * frame, requiring a single affine multiplication on cache hits.
+  */
+int transform_frame_tree_get(
+  transform_frame_tree_t* tree,
+  size_t source,
+  size_t target,
+  transform_t transform);
+
+#endif
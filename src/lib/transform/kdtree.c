@@ -0,0 +1,579 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <math.h>
+
+#include "kdtree.h"
+
+typedef struct transform_kdtree_task_t {
+  size_t node;
+  size_t index_min;
+  size_t index_max;
+} transform_kdtree_task_t;
+
+typedef struct transform_kdtree_arg_t {
+  transform_kdtree_t* tree;
+  transform_kdtree_task_t* tasks;
+
+  const transform_point_t* queries;
+  size_t k;
+  size_t* indices;
+  double* distances;
+} transform_kdtree_arg_t;
+
+typedef struct transform_kdtree_stack_t {
+  size_t node;
+  double distance;
+} transform_kdtree_stack_t;
+
+const char* transform_kdtree_errors[] = {
+  "Success",
+  "Empty k-d tree",
+  "Non-rigid k-d tree transform",
+};
+
+void transform_kdtree_init(transform_kdtree_t* tree) {
+  tree->points = 0;
+  tree->indices = 0;
+  tree->num_points = 0;
+
+  tree->nodes = 0;
+  tree->num_nodes = 0;
+  tree->leaf_size = TRANSFORM_KDTREE_LEAF_SIZE;
+
+  transform_affine_init_identity(tree->transform);
+  transform_affine_init_identity(tree->inverse);
+  tree->transformed = 0;
+
+  error_init(&tree->error, transform_kdtree_errors);
+}
+
+void transform_kdtree_destroy(transform_kdtree_t* tree) {
+  free(tree->points);
+  free(tree->indices);
+  free(tree->nodes);
+
+  tree->points = 0;
+  tree->indices = 0;
+  tree->num_points = 0;
+
+  tree->nodes = 0;
+  tree->num_nodes = 0;
+
+  error_destroy(&tree->error);
+}
+
+size_t transform_kdtree_get_num_nodes(size_t num_points, size_t leaf_size) {
+  if (!leaf_size)
+    leaf_size = TRANSFORM_KDTREE_LEAF_SIZE;
+
+  if (num_points <= leaf_size)
+    return 1;
+  else
+    return 1+transform_kdtree_get_num_nodes(num_points/2, leaf_size)+
+      transform_kdtree_get_num_nodes(num_points-num_points/2, leaf_size);
+}
+
+static void transform_kdtree_reset(transform_kdtree_t* tree, const
+    transform_point_t* points, size_t num_points, size_t leaf_size) {
+  size_t i;
+
+  tree->leaf_size = leaf_size ? leaf_size : TRANSFORM_KDTREE_LEAF_SIZE;
+
+  if (num_points != tree->num_points) {
+    tree->points = realloc(tree->points, num_points*
+      sizeof(transform_point_t));
+    tree->indices = realloc(tree->indices, num_points*sizeof(size_t));
+    tree->num_points = num_points;
+
+    tree->num_nodes = transform_kdtree_get_num_nodes(num_points,
+      tree->leaf_size);
+    tree->nodes = realloc(tree->nodes, tree->num_nodes*
+      sizeof(transform_kdtree_node_t));
+  }
+  else if (tree->num_nodes != transform_kdtree_get_num_nodes(num_points,
+      tree->leaf_size)) {
+    tree->num_nodes = transform_kdtree_get_num_nodes(num_points,
+      tree->leaf_size);
+    tree->nodes = realloc(tree->nodes, tree->num_nodes*
+      sizeof(transform_kdtree_node_t));
+  }
+
+  for (i = 0; i < num_points; ++i) {
+    tree->points[i] = points[i];
+    tree->indices[i] = i;
+  }
+
+  transform_affine_init_identity(tree->transform);
+  transform_affine_init_identity(tree->inverse);
+  tree->transformed = 0;
+
+  error_clear(&tree->error);
+}
+
+static void transform_kdtree_swap(transform_kdtree_t* tree, ssize_t i,
+    ssize_t j) {
+  transform_point_t point = tree->points[i];
+  size_t index = tree->indices[i];
+
+  tree->points[i] = tree->points[j];
+  tree->indices[i] = tree->indices[j];
+  tree->points[j] = point;
+  tree->indices[j] = index;
+}
+
+static void transform_kdtree_select(transform_kdtree_t* tree, size_t index_min,
+    size_t index_max, size_t k, int axis) {
+  const transform_point_t* p = tree->points;
+  ssize_t i_min = index_min, i_max = index_max-1;
+
+  while (i_max > i_min) {
+    ssize_t i = i_min, j = i_max;
+    double a = (&p[i_min].x)[axis], b = (&p[(i_min+i_max)/2].x)[axis];
+    double c = (&p[i_max].x)[axis];
+    double pivot = fmax(fmin(a, b), fmin(fmax(a, b), c));
+
+    while (i <= j) {
+      while ((&p[i].x)[axis] < pivot)
+        ++i;
+      while ((&p[j].x)[axis] > pivot)
+        --j;
+
+      if (i <= j)
+        transform_kdtree_swap(tree, i++, j--);
+    }
+
+    if ((ssize_t)k <= j)
+      i_max = j;
+    else if ((ssize_t)k >= i)
+      i_min = i;
+    else
+      break;
+  }
+}
+
+static size_t transform_kdtree_split(transform_kdtree_t* tree, size_t node,
+    size_t index_min, size_t index_max) {
+  transform_kdtree_node_t* n = &tree->nodes[node];
+  const transform_point_t* p = tree->points;
+  double min[3] = {INFINITY, INFINITY, INFINITY};
+  double max[3] = {-INFINITY, -INFINITY, -INFINITY};
+  size_t index_mid = index_min+(index_max-index_min)/2, i;
+  int axis;
+
+  for (i = index_min; i < index_max; ++i) {
+    min[0] = fmin(min[0], p[i].x);
+    max[0] = fmax(max[0], p[i].x);
+    min[1] = fmin(min[1], p[i].y);
+    max[1] = fmax(max[1], p[i].y);
+    min[2] = fmin(min[2], p[i].z);
+    max[2] = fmax(max[2], p[i].z);
+  }
+
+  axis = (max[1]-min[1] > max[0]-min[0]) ? 1 : 0;
+  if (max[2]-min[2] > max[axis]-min[axis])
+    axis = 2;
+
+  transform_kdtree_select(tree, index_min, index_max, index_mid, axis);
+
+  n->index_min = index_min;
+  n->index_max = index_max;
+  n->right = 0;
+  n->axis = axis;
+  n->split = (&p[index_mid].x)[axis];
+
+  return index_mid;
+}
+
+static size_t transform_kdtree_build_subtree(transform_kdtree_t* tree, size_t
+    node, size_t index_min, size_t index_max) {
+  size_t index_mid, num_left, num_right;
+
+  if (index_max-index_min <= tree->leaf_size) {
+    transform_kdtree_node_t* n = &tree->nodes[node];
+
+    n->index_min = index_min;
+    n->index_max = index_max;
+    n->right = 0;
+    n->axis = 0;
+    n->split = 0.0;
+
+    return 1;
+  }
+
+  index_mid = transform_kdtree_split(tree, node, index_min, index_max);
+  num_left = transform_kdtree_build_subtree(tree, node+1, index_min,
+    index_mid);
+  tree->nodes[node].right = node+1+num_left;
+  num_right = transform_kdtree_build_subtree(tree, node+1+num_left,
+    index_mid, index_max);
+
+  return 1+num_left+num_right;
+}
+
+size_t transform_kdtree_build(transform_kdtree_t* tree, const
+    transform_point_t* points, size_t num_points, size_t leaf_size) {
+  transform_kdtree_reset(tree, points, num_points, leaf_size);
+
+  return transform_kdtree_build_subtree(tree, 0, 0, num_points);
+}
+
+static void transform_kdtree_build_tasks(transform_kdtree_t* tree, size_t node,
+    size_t index_min, size_t index_max, size_t depth, transform_kdtree_task_t*
+    tasks, size_t* num_tasks) {
+  size_t index_mid;
+
+  if (!depth || (index_max-index_min <= tree->leaf_size)) {
+    tasks[*num_tasks].node = node;
+    tasks[*num_tasks].index_min = index_min;
+    tasks[*num_tasks].index_max = index_max;
+    ++(*num_tasks);
+
+    return;
+  }
+
+  index_mid = transform_kdtree_split(tree, node, index_min, index_max);
+  tree->nodes[node].right = node+1+transform_kdtree_get_num_nodes(
+    index_mid-index_min, tree->leaf_size);
+
+  transform_kdtree_build_tasks(tree, node+1, index_min, index_mid, depth-1,
+    tasks, num_tasks);
+  transform_kdtree_build_tasks(tree, tree->nodes[node].right, index_mid,
+    index_max, depth-1, tasks, num_tasks);
+}
+
+static void transform_kdtree_build_range(void* arg, size_t index_min, size_t
+    index_max) {
+  transform_kdtree_arg_t* a = arg;
+  size_t i;
+
+  for (i = index_min; i < index_max; ++i)
+    transform_kdtree_build_subtree(a->tree, a->tasks[i].node,
+      a->tasks[i].index_min, a->tasks[i].index_max);
+}
+
+size_t transform_kdtree_build_parallel(thread_pool_t* pool,
+    transform_kdtree_t* tree, const transform_point_t* points, size_t
+    num_points, size_t leaf_size) {
+  size_t num_threads = thread_pool_get_num_threads(pool);
+  size_t depth = 2, num_tasks = 0;
+  transform_kdtree_arg_t arg;
+
+  if (num_threads < 2)
+    return transform_kdtree_build(tree, points, num_points, leaf_size);
+
+  while (((size_t)1 << depth) < 4*num_threads)
+    ++depth;
+
+  transform_kdtree_reset(tree, points, num_points, leaf_size);
+
+  arg.tree = tree;
+  arg.tasks = malloc(((size_t)1 << depth)*sizeof(transform_kdtree_task_t));
+
+  transform_kdtree_build_tasks(tree, 0, 0, num_points, depth, arg.tasks,
+    &num_tasks);
+  thread_pool_for(pool, transform_kdtree_build_range, &arg, num_tasks, 1);
+
+  free(arg.tasks);
+
+  return tree->num_nodes;
+}
+
+int transform_kdtree_transform(transform_kdtree_t* tree, transform_t
+    transform) {
+  transform_affine_t affine;
+
+  error_clear(&tree->error);
+
+  transform_affine_init_transform(affine, transform);
+  if (!transform_affine_is_rigid(affine)) {
+    error_set(&tree->error, TRANSFORM_KDTREE_ERROR_TRANSFORM);
+    return TRANSFORM_KDTREE_ERROR_TRANSFORM;
+  }
+
+  transform_affine_multiply_left(tree->transform, affine);
+  transform_affine_copy(tree->inverse, tree->transform);
+  transform_affine_invert(tree->inverse);
+  tree->transformed = 1;
+
+  return TRANSFORM_KDTREE_ERROR_NONE;
+}
+
+static void transform_kdtree_get_query(const transform_kdtree_t* tree, const
+    transform_point_t* query, transform_point_t* point) {
+  const double (*a)[4] = tree->inverse;
+
+  if (tree->transformed) {
+    point->x = a[0][0]*query->x+a[0][1]*query->y+a[0][2]*query->z+a[0][3];
+    point->y = a[1][0]*query->x+a[1][1]*query->y+a[1][2]*query->z+a[1][3];
+    point->z = a[2][0]*query->x+a[2][1]*query->y+a[2][2]*query->z+a[2][3];
+  }
+  else
+    *point = *query;
+}
+
+static void transform_kdtree_heap_push(double* heap_distances, size_t*
+    heap_indices, size_t k, double distance, size_t index) {
+  size_t i = 0;
+
+  for (;;) {
+    size_t left = 2*i+1, right = left+1, j = i;
+
+    if ((left < k) && (heap_distances[left] > distance))
+      j = left;
+    if ((right < k) && (heap_distances[right] > distance) &&
+        (heap_distances[right] > heap_distances[left]))
+      j = right;
+    if (j == i)
+      break;
+
+    heap_distances[i] = heap_distances[j];
+    heap_indices[i] = heap_indices[j];
+    i = j;
+  }
+
+  heap_distances[i] = distance;
+  heap_indices[i] = index;
+}
+
+static void transform_kdtree_search_knn_point(const transform_kdtree_t* tree,
+    const transform_point_t* query, size_t k, size_t* indices, double*
+    distances) {
+  transform_kdtree_stack_t stack[TRANSFORM_KDTREE_MAX_DEPTH];
+  size_t num_stack = 1, i;
+  transform_point_t q;
+
+  transform_kdtree_get_query(tree, query, &q);
+
+  for (i = 0; i < k; ++i) {
+    distances[i] = INFINITY;
+    indices[i] = TRANSFORM_KDTREE_INDEX_NONE;
+  }
+
+  stack[0].node = 0;
+  stack[0].distance = 0.0;
+
+  while (num_stack) {
+    transform_kdtree_stack_t* top = &stack[--num_stack];
+    size_t node = top->node;
+
+    if (top->distance >= distances[0])
+      continue;
+
+    while (tree->nodes[node].right) {
+      const transform_kdtree_node_t* n = &tree->nodes[node];
+      double d = (&q.x)[n->axis]-n->split;
+
+      stack[num_stack].node = (d < 0.0) ? n->right : node+1;
+      stack[num_stack].distance = d*d;
+      ++num_stack;
+
+      node = (d < 0.0) ? node+1 : n->right;
+    }
+
+    for (i = tree->nodes[node].index_min; i < tree->nodes[node].index_max;
+        ++i) {
+      const transform_point_t* p = &tree->points[i];
+      double d_x = p->x-q.x, d_y = p->y-q.y, d_z = p->z-q.z;
+      double d = d_x*d_x+d_y*d_y+d_z*d_z;
+
+      if (d < distances[0])
+        transform_kdtree_heap_push(distances, indices, k, d,
+          tree->indices[i]);
+    }
+  }
+
+  for (i = k; i > 1; --i) {
+    double distance = distances[0];
+    size_t index = indices[0];
+
+    transform_kdtree_heap_push(distances, indices, i-1, distances[i-1],
+      indices[i-1]);
+    distances[i-1] = distance;
+    indices[i-1] = index;
+  }
+
+  for (i = 0; i < k; ++i)
+    distances[i] = sqrt(distances[i]);
+}
+
+static void transform_kdtree_search_knn_range(void* arg, size_t index_min,
+    size_t index_max) {
+  transform_kdtree_arg_t* a = arg;
+  double* distances = a->distances ? 0 : malloc(a->k*sizeof(double));
+  size_t i;
+
+  for (i = index_min; i < index_max; ++i)
+    transform_kdtree_search_knn_point(a->tree, &a->queries[i], a->k,
+      &a->indices[i*a->k], a->distances ? &a->distances[i*a->k] :
+      distances);
+
+  free(distances);
+}
+
+ssize_t transform_kdtree_search_knn(transform_kdtree_t* tree, const
+    transform_point_t* queries, size_t num_queries, size_t k, size_t*
+    indices, double* distances) {
+  transform_kdtree_arg_t arg;
+
+  error_clear(&tree->error);
+
+  if (!tree->num_points) {
+    error_set(&tree->error, TRANSFORM_KDTREE_ERROR_EMPTY);
+    return -TRANSFORM_KDTREE_ERROR_EMPTY;
+  }
+
+  arg.tree = tree;
+  arg.queries = queries;
+  arg.k = k;
+  arg.indices = indices;
+  arg.distances = distances;
+
+  if (k)
+    transform_kdtree_search_knn_range(&arg, 0, num_queries);
+
+  return num_queries;
+}
+
+ssize_t transform_kdtree_search_knn_parallel(thread_pool_t* pool,
+    transform_kdtree_t* tree, const transform_point_t* queries, size_t
+    num_queries, size_t k, size_t* indices, double* distances, size_t
+    grain_size) {
+  transform_kdtree_arg_t arg;
+
+  error_clear(&tree->error);
+
+  if (!tree->num_points) {
+    error_set(&tree->error, TRANSFORM_KDTREE_ERROR_EMPTY);
+    return -TRANSFORM_KDTREE_ERROR_EMPTY;
+  }
+
+  arg.tree = tree;
+  arg.queries = queries;
+  arg.k = k;
+  arg.indices = indices;
+  arg.distances = distances;
+
+  if (k)
+    thread_pool_for(pool, transform_kdtree_search_knn_range, &arg,
+      num_queries, grain_size ? grain_size :
+      TRANSFORM_KDTREE_PARALLEL_GRAIN_SIZE);
+
+  return num_queries;
+}
+
+static void transform_kdtree_neighbors_add(transform_kdtree_neighbors_t*
+    neighbors, size_t index, double distance) {
+  if (neighbors->num_neighbors == neighbors->capacity) {
+    neighbors->capacity = neighbors->capacity ? 2*neighbors->capacity : 64;
+    neighbors->indices = realloc(neighbors->indices, neighbors->capacity*
+      sizeof(size_t));
+    neighbors->distances = realloc(neighbors->distances,
+      neighbors->capacity*sizeof(double));
+  }
+
+  neighbors->indices[neighbors->num_neighbors] = index;
+  neighbors->distances[neighbors->num_neighbors] = distance;
+  ++neighbors->num_neighbors;
+}
+
+ssize_t transform_kdtree_search_radius(transform_kdtree_t* tree, const
+    transform_point_t* queries, size_t num_queries, double radius,
+    transform_kdtree_neighbors_t* neighbors) {
+  transform_kdtree_stack_t stack[TRANSFORM_KDTREE_MAX_DEPTH];
+  double radius_squared = radius*radius;
+  size_t i, j;
+
+  error_clear(&tree->error);
+
+  if (!tree->num_points) {
+    error_set(&tree->error, TRANSFORM_KDTREE_ERROR_EMPTY);
+    return -TRANSFORM_KDTREE_ERROR_EMPTY;
+  }
+
+  neighbors->offsets = realloc(neighbors->offsets, (num_queries+1)*
+    sizeof(size_t));
+  neighbors->num_queries = num_queries;
+  neighbors->num_neighbors = 0;
+
+  for (j = 0; j < num_queries; ++j) {
+    size_t num_stack = 1;
+    transform_point_t q;
+
+    transform_kdtree_get_query(tree, &queries[j], &q);
+    neighbors->offsets[j] = neighbors->num_neighbors;
+
+    stack[0].node = 0;
+    stack[0].distance = 0.0;
+
+    while (num_stack) {
+      transform_kdtree_stack_t* top = &stack[--num_stack];
+      size_t node = top->node;
+
+      if (top->distance > radius_squared)
+        continue;
+
+      while (tree->nodes[node].right) {
+        const transform_kdtree_node_t* n = &tree->nodes[node];
+        double d = (&q.x)[n->axis]-n->split;
+
+        stack[num_stack].node = (d < 0.0) ? n->right : node+1;
+        stack[num_stack].distance = d*d;
+        ++num_stack;
+
+        node = (d < 0.0) ? node+1 : n->right;
+      }
+
+      for (i = tree->nodes[node].index_min; i < tree->nodes[node].index_max;
+          ++i) {
+        const transform_point_t* p = &tree->points[i];
+        double d_x = p->x-q.x, d_y = p->y-q.y, d_z = p->z-q.z;
+        double d = d_x*d_x+d_y*d_y+d_z*d_z;
+
+        if (d <= radius_squared)
+          transform_kdtree_neighbors_add(neighbors, tree->indices[i],
+            sqrt(d));
+      }
+    }
+  }
+  neighbors->offsets[num_queries] = neighbors->num_neighbors;
+
+  return neighbors->num_neighbors;
+}
+
+void transform_kdtree_neighbors_init(transform_kdtree_neighbors_t*
+    neighbors) {
+  neighbors->offsets = 0;
+  neighbors->num_queries = 0;
+
+  neighbors->indices = 0;
+  neighbors->distances = 0;
+  neighbors->num_neighbors = 0;
+  neighbors->capacity = 0;
+}
+
+void transform_kdtree_neighbors_destroy(transform_kdtree_neighbors_t*
+    neighbors) {
+  free(neighbors->offsets);
+  free(neighbors->indices);
+  free(neighbors->distances);
+
+  transform_kdtree_neighbors_init(neighbors);
+}
@@ -0,0 +1,289 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_KDTREE_H
+#define TRANSFORM_KDTREE_H
+
+/** \file transform/kdtree.h
+  * \ingroup transform
+  * \brief K-d tree spatial index for the linear transformation module
+  * \author Ralf Kaestner
+  *
+  * A k-d tree indexes an array of points for nearest-neighbor and radius
+  * queries. The tree is built by recursive median splits along the axis
+  * of largest extent in O(N log N) time. Its nodes are stored in
+  * depth-first order in a single array, such that the left child of a
+  * node immediately follows its parent, and the points are reordered into
+  * a private copy such that each leaf references a contiguous range of
+  * points.
+  *
+  * Since rigid transforms preserve distances, the index of a rigidly
+  * transformed point array does not need to be rebuilt. Instead, the
+  * transform is recorded with the tree and queries are mapped back into
+  * the frame the tree has been built in.
+  *
+  * The parallel build and search submit their work to a thread pool owned
+  * by the caller. As thread_pool_for() accepts one submitter at a time,
+  * no other thread may use the pool until these functions return.
+  */
+
+#include <stdlib.h>
+
+#include "transform/affine.h"
+
+#include "thread/pool.h"
+
+#include "error/error.h"
+
+/** \name Constants
+  * \brief Predefined k-d tree constants
+  */
+//@{
+#define TRANSFORM_KDTREE_LEAF_SIZE         16
+//!< The default maximum number of points per leaf
+#define TRANSFORM_KDTREE_MAX_DEPTH         64
+//!< The maximum depth of a k-d tree
+#define TRANSFORM_KDTREE_PARALLEL_GRAIN_SIZE 256
+//!< The default number of queries answered per parallel work item
+#define TRANSFORM_KDTREE_INDEX_NONE        ((size_t)-1)
+//!< The index reported for missing neighbors
+//@}
+
+/** \name Error Codes
+  * \brief Predefined k-d tree error codes
+  */
+//@{
+#define TRANSFORM_KDTREE_ERROR_NONE        0
+//!< Success
+#define TRANSFORM_KDTREE_ERROR_EMPTY       1
+//!< Empty k-d tree
+#define TRANSFORM_KDTREE_ERROR_TRANSFORM   2
+//!< Non-rigid k-d tree transform
+//@}
+
+/** \brief Predefined k-d tree error descriptions
+  */
+extern const char* transform_kdtree_errors[];
+
+/** \brief Structure defining a k-d tree node
+  *
+  * Inner nodes split their points at a plane orthogonal to one of the
+  * coordinate axes. Points of the left child lie below or on the plane,
+  * points of the right child above or on the plane.
+  */
+typedef struct transform_kdtree_node_t {
+  size_t index_min;               //!< The index of the first point.
+  size_t index_max;               //!< The index past the last point.
+  size_t right;                   //!< The right child, zero for leaves.
+  int axis;                       //!< The axis orthogonal to the plane.
+  double split;                   //!< The coordinate of the plane.
+} transform_kdtree_node_t;
+
+/** \brief Structure defining a k-d tree
+  */
+typedef struct transform_kdtree_t {
+  transform_point_t* points;      //!< The points in tree order.
+  size_t* indices;                //!< The original indices of the points.
+  size_t num_points;              //!< The number of indexed points.
+
+  transform_kdtree_node_t* nodes; //!< The nodes in depth-first order.
+  size_t num_nodes;               //!< The number of nodes.
+  size_t leaf_size;               //!< The maximum number of points per leaf.
+
+  transform_affine_t transform;   //!< The transform applied to the points.
+  transform_affine_t inverse;     //!< The inverse of the transform.
+  int transformed;                //!< Non-zero if the transform is set.
+
+  error_t error;                  //!< The most recent k-d tree error.
+} transform_kdtree_t;
+
+/** \brief Structure holding the results of radius queries
+  *
+  * The neighbors of query i are stored at the positions offsets[i] to
+  * offsets[i+1]-1 of the index and distance arrays.
+  */
+typedef struct transform_kdtree_neighbors_t {
+  size_t* offsets;                //!< The offsets of the query results.
+  size_t num_queries;             //!< The number of queries.
+
+  size_t* indices;                //!< The original indices of the neighbors.
+  double* distances;              //!< The distances of the neighbors.
+  size_t num_neighbors;           //!< The total number of neighbors.
+  size_t capacity;                //!< The capacity of the neighbor arrays.
+} transform_kdtree_neighbors_t;
+
+/** \brief Initialize an empty k-d tree
+  * \param[in] tree The k-d tree to be initialized.
+  */
+void transform_kdtree_init(
+  transform_kdtree_t* tree);
+
+/** \brief Destroy a k-d tree
+  * \param[in] tree The k-d tree to be destroyed.
+  */
+void transform_kdtree_destroy(
+  transform_kdtree_t* tree);
+
+/** \brief Retrieve the number of nodes of a k-d tree
+  * \param[in] num_points The number of points to be indexed.
+  * \param[in] leaf_size The maximum number of points per leaf.
+  * \return The number of nodes of a k-d tree over the given number of
+  *   points.
+  */
+size_t transform_kdtree_get_num_nodes(
+  size_t num_points,
+  size_t leaf_size);
+
+/** \brief Build a k-d tree sequentially
+  * \param[in,out] tree The k-d tree to be built. Any previously indexed
+  *   points and the recorded transform will be discarded, reusing the
+  *   allocated memory.
+  * \param[in] points The array of points to be indexed.
+  * \param[in] num_points The number of points in the array.
+  * \param[in] leaf_size The maximum number of points per leaf. If zero,
+  *   TRANSFORM_KDTREE_LEAF_SIZE will be assumed.
+  * \return The number of nodes of the tree.
+  *
+  * Medians are located by quickselect in expected linear time per level.
+  */
+size_t transform_kdtree_build(
+  transform_kdtree_t* tree,
+  const transform_point_t* points,
+  size_t num_points,
+  size_t leaf_size);
+
+/** \brief Build a k-d tree in parallel
+  * \param[in] pool The thread pool used for building the tree.
+  * \param[in,out] tree The k-d tree to be built. Any previously indexed
+  *   points and the recorded transform will be discarded, reusing the
+  *   allocated memory.
+  * \param[in] points The array of points to be indexed.
+  * \param[in] num_points The number of points in the array.
+  * \param[in] leaf_size The maximum number of points per leaf. If zero,
+  *   TRANSFORM_KDTREE_LEAF_SIZE will be assumed.
+  * \return The number of nodes of the tree.
+  *
+  * The upper levels of the tree are split sequentially until there are
+  * about four subtrees per thread of the pool. The subtrees are then
+  * built in parallel. Since the node layout is determined by the number
+  * of points only, the result is identical to the sequential build.
+  */
+size_t transform_kdtree_build_parallel(
+  thread_pool_t* pool,
+  transform_kdtree_t* tree,
+  const transform_point_t* points,
+  size_t num_points,
+  size_t leaf_size);
+
+/** \brief Apply a rigid transform to the indexed points
+  * \param[in,out] tree The k-d tree whose points will be transformed.
+  * \param[in] transform The rigid transform to be applied to the points.
+  * \return The resulting error code.
+  *
+  * The transform is composed with any transform recorded previously,
+  * leaving the tree structure unmodified. Thus, following an update of
+  * the original points by the same transform, the tree remains valid in
+  * O(1) instead of O(N log N) time.
+  */
+int transform_kdtree_transform(
+  transform_kdtree_t* tree,
+  transform_t transform);
+
+/** \brief Search the k nearest neighbors of many query points
+  * \param[in] tree The k-d tree to be searched.
+  * \param[in] queries The array of query points.
+  * \param[in] num_queries The number of query points.
+  * \param[in] k The number of neighbors to be found per query.
+  * \param[out] indices The original indices of the neighbors, an array
+  *   holding k indices per query point.
+  * \param[out] distances The optional distances of the neighbors, an
+  *   array holding k distances per query point.
+  * \return The number of answered queries or the negative error code.
+  *
+  * The neighbors of each query are sorted by ascending distance. If the
+  * tree holds less than k points, the missing neighbors are reported as
+  * TRANSFORM_KDTREE_INDEX_NONE at infinite distance.
+  */
+ssize_t transform_kdtree_search_knn(
+  transform_kdtree_t* tree,
+  const transform_point_t* queries,
+  size_t num_queries,
+  size_t k,
+  size_t* indices,
+  double* distances);
+
+/** \brief Search the k nearest neighbors of many query points in parallel
+  * \param[in] pool The thread pool used for searching the tree.
+  * \param[in] tree The k-d tree to be searched.
+  * \param[in] queries The array of query points.
+  * \param[in] num_queries The number of query points.
+  * \param[in] k The number of neighbors to be found per query.
+  * \param[out] indices The original indices of the neighbors, an array
+  *   holding k indices per query point.
+  * \param[out] distances The optional distances of the neighbors, an
+  *   array holding k distances per query point.
+  * \param[in] grain_size The number of queries answered per work item of
+  *   the thread pool. If zero, TRANSFORM_KDTREE_PARALLEL_GRAIN_SIZE
+  *   queries will be answered per work item.
+  * \return The number of answered queries or the negative error code.
+  *
+  * The results are identical to transform_kdtree_search_knn().
+  */
+ssize_t transform_kdtree_search_knn_parallel(
+  thread_pool_t* pool,
+  transform_kdtree_t* tree,
+  const transform_point_t* queries,
+  size_t num_queries,
+  size_t k,
+  size_t* indices,
+  double* distances,
+  size_t grain_size);
+
+/** \brief Search the neighbors within a radius of many query points
+  * \param[in] tree The k-d tree to be searched.
+  * \param[in] queries The array of query points.
+  * \param[in] num_queries The number of query points.
+  * \param[in] radius The search radius.
+  * \param[in,out] neighbors The neighbors found within the radius of
+  *   each query point in unspecified order. The arrays of the result will
+  *   be grown as required.
+  * \return The total number of neighbors found or the negative error
+  *   code.
+  */
+ssize_t transform_kdtree_search_radius(
+  transform_kdtree_t* tree,
+  const transform_point_t* queries,
+  size_t num_queries,
+  double radius,
+  transform_kdtree_neighbors_t* neighbors);
+
+/** \brief Initialize an empty radius query result
+  * \param[in] neighbors The radius query result to be initialized.
+  */
+void transform_kdtree_neighbors_init(
+  transform_kdtree_neighbors_t* neighbors);
+
+/** \brief Destroy a radius query result
+  * \param[in] neighbors The radius query result to be destroyed.
+  */
+void transform_kdtree_neighbors_destroy(
+  transform_kdtree_neighbors_t* neighbors);
+
+#endif
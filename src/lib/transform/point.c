@@ -27,6 +27,13 @@ void transform_point_init(transform_point_t* point, double x, double y,
   point->z = z;
 }
 
+void transform_point_float_init(transform_point_float_t* point, float x,
+    float y, float z) {
+  point->x = x;
+  point->y = y;
+  point->z = z;
+}
+
 void transform_point_copy(transform_point_t* dst, const transform_point_t*
     src) {
   dst->x = src->x;
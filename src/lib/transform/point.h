@@ -30,7 +30,8 @@
   * \author Ralf Kaestner
   * 
   * A point in 3-dimensional space consists in three components
-  * describing location.
+  * describing location. Besides double-precision points, single-precision
+  * points are provided for large point clouds.
   */
 
 /** \brief Structure defining a point
@@ -43,6 +44,16 @@ typedef struct transform_point_t {
   double z;                    //!< The z-component of the point.
 } transform_point_t;
 
+/** \brief Structure defining a single-precision point
+  *
+  * A single-precision point is defined by an x, y, and z-component.
+  */
+typedef struct transform_point_float_t {
+  float x;                     //!< The x-component of the point.
+  float y;                     //!< The y-component of the point.
+  float z;                     //!< The z-component of the point.
+} transform_point_float_t;
+
 /** \brief Initialize point
   * \param[in] point The point to be initialized.
   * \param[in] x The initial x-component of the point.
@@ -55,6 +66,18 @@ void transform_point_init(
   double y,
   double z);
 
+/** \brief Initialize single-precision point
+  * \param[in] point The single-precision point to be initialized.
+  * \param[in] x The initial x-component of the point.
+  * \param[in] y The initial y-component of the point.
+  * \param[in] z The initial z-component of the point.
+  */
+void transform_point_float_init(
+  transform_point_float_t* point,
+  float x,
+  float y,
+  float z);
+
 /** \brief Copy point
   * \param[in] dst The destination point to copy to.
   * \param[in] src The source point to copy from.
@@ -0,0 +1,174 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "quat_pose.h"
+
+const char* transform_quat_pose_interpolations[] = {
+  "slerp",
+  "nlerp",
+};
+
+void transform_quat_pose_init_identity(transform_quat_pose_t* pose) {
+  transform_point_init(&pose->translation, 0.0, 0.0, 0.0);
+  transform_quaternion_init_identity(&pose->rotation);
+}
+
+void transform_quat_pose_init_pose(transform_quat_pose_t* quat_pose, const
+    transform_pose_t* pose) {
+  transform_point_init(&quat_pose->translation, pose->x, pose->y, pose->z);
+  transform_quaternion_init_rotation(&quat_pose->rotation, pose->yaw,
+    pose->pitch, pose->roll);
+}
+
+void transform_quat_pose_init_transform(transform_quat_pose_t* pose,
+    transform_t transform) {
+  transform_point_init(&pose->translation, transform[0][3], transform[1][3],
+    transform[2][3]);
+  transform_quaternion_init_transform(&pose->rotation, transform);
+}
+
+void transform_quat_pose_to_pose(const transform_quat_pose_t* quat_pose,
+    transform_pose_t* pose) {
+  pose->x = quat_pose->translation.x;
+  pose->y = quat_pose->translation.y;
+  pose->z = quat_pose->translation.z;
+
+  transform_quaternion_get_rotation(&quat_pose->rotation, &pose->yaw,
+    &pose->pitch, &pose->roll);
+}
+
+void transform_quat_pose_to_transform(const transform_quat_pose_t* pose,
+    transform_t transform) {
+  transform_quaternion_to_transform(&pose->rotation, transform);
+
+  transform[0][3] = pose->translation.x;
+  transform[1][3] = pose->translation.y;
+  transform[2][3] = pose->translation.z;
+}
+
+void transform_quat_pose_copy(transform_quat_pose_t* dst, const
+    transform_quat_pose_t* src) {
+  transform_point_copy(&dst->translation, &src->translation);
+  transform_quaternion_copy(&dst->rotation, &src->rotation);
+}
+
+void transform_quat_pose_print(FILE* stream, const transform_quat_pose_t*
+    pose) {
+  transform_point_print(stream, &pose->translation);
+  fprintf(stream, " ");
+  transform_quaternion_print(stream, &pose->rotation);
+}
+
+void transform_quat_pose_multiply_left(transform_quat_pose_t* right, const
+    transform_quat_pose_t* left) {
+  transform_quaternion_rotate_point(&left->rotation, &right->translation);
+
+  right->translation.x += left->translation.x;
+  right->translation.y += left->translation.y;
+  right->translation.z += left->translation.z;
+
+  transform_quaternion_multiply_left(&right->rotation, &left->rotation);
+}
+
+void transform_quat_pose_invert(transform_quat_pose_t* pose) {
+  transform_quaternion_invert(&pose->rotation);
+  transform_quaternion_rotate_point(&pose->rotation, &pose->translation);
+
+  pose->translation.x = -pose->translation.x;
+  pose->translation.y = -pose->translation.y;
+  pose->translation.z = -pose->translation.z;
+}
+
+void transform_quat_pose_point(const transform_quat_pose_t* pose,
+    transform_point_t* point) {
+  transform_quaternion_rotate_point(&pose->rotation, point);
+
+  point->x += pose->translation.x;
+  point->y += pose->translation.y;
+  point->z += pose->translation.z;
+}
+
+void transform_quat_pose_interpolate(const transform_quat_pose_t* start,
+    const transform_quat_pose_t* end, double u,
+    transform_quat_pose_interpolation_t type, transform_quat_pose_t* result) {
+  result->translation.x = start->translation.x+
+    u*(end->translation.x-start->translation.x);
+  result->translation.y = start->translation.y+
+    u*(end->translation.y-start->translation.y);
+  result->translation.z = start->translation.z+
+    u*(end->translation.z-start->translation.z);
+
+  if (type == transform_quat_pose_interpolation_slerp)
+    transform_quaternion_slerp(&start->rotation, &end->rotation, u,
+      &result->rotation);
+  else
+    transform_quaternion_nlerp(&start->rotation, &end->rotation, u,
+      &result->rotation);
+}
+
+void transform_quat_pose_interpolate_array(const double* timestamps, const
+    transform_quat_pose_t* poses, size_t num_poses, const double* times,
+    transform_quat_pose_t* result, size_t num_times,
+    transform_quat_pose_interpolation_t type) {
+  size_t i, j = 0;
+  double h;
+
+  if (!num_poses)
+    return;
+
+  for (i = 0; i < num_times; ++i) {
+    double t = times[i];
+
+    if ((num_poses < 2) || (t <= timestamps[0])) {
+      transform_quat_pose_copy(&result[i], &poses[0]);
+      continue;
+    }
+    else if (t >= timestamps[num_poses-1]) {
+      transform_quat_pose_copy(&result[i], &poses[num_poses-1]);
+      continue;
+    }
+
+    if ((t < timestamps[j]) || (t > timestamps[j+1])) {
+      if ((j+2 < num_poses) && (t >= timestamps[j+1]) &&
+          (t <= timestamps[j+2]))
+        ++j;
+      else {
+        size_t j_min = 0, j_max = num_poses-1;
+
+        while (j_max-j_min > 1) {
+          size_t j_mid = (j_min+j_max)/2;
+
+          if (timestamps[j_mid] > t)
+            j_max = j_mid;
+          else
+            j_min = j_mid;
+        }
+        j = j_min;
+      }
+    }
+
+    h = timestamps[j+1]-timestamps[j];
+    if (h > 0.0)
+      transform_quat_pose_interpolate(&poses[j], &poses[j+1],
+        (t-timestamps[j])/h, type, &result[i]);
+    else
+      transform_quat_pose_copy(&result[i], &poses[j]);
+  }
+}
@@ -0,0 +1,188 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_QUAT_POSE_H
+#define TRANSFORM_QUAT_POSE_H
+
+/** \file transform/quat_pose.h
+  * \ingroup transform
+  * \brief Quaternion pose definition for the linear transformation module
+  * \author Ralf Kaestner
+  *
+  * A quaternion pose represents location by a translation and orientation
+  * by a unit quaternion. Quaternion poses are composed and inverted
+  * without trigonometric functions, and sequences of timestamped poses
+  * may be interpolated in batch.
+  */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "transform/quaternion.h"
+
+/** \brief Quaternion pose interpolation type
+  */
+typedef enum {
+  transform_quat_pose_interpolation_slerp,  //!< Spherical interpolation.
+  transform_quat_pose_interpolation_nlerp,  //!< Normalized linear
+                                            //!< interpolation.
+} transform_quat_pose_interpolation_t;
+
+/** \brief Predefined quaternion pose interpolation type strings
+  */
+extern const char* transform_quat_pose_interpolations[];
+
+/** \brief Structure defining a quaternion pose
+  *
+  * A quaternion pose is defined by its translation and its rotation.
+  */
+typedef struct transform_quat_pose_t {
+  transform_point_t translation;        //!< The translation of the pose.
+  transform_quaternion_t rotation;      //!< The unit rotation quaternion.
+} transform_quat_pose_t;
+
+/** \brief Initialize identity quaternion pose
+  * \param[in] pose The quaternion pose to be initialized to identity.
+  */
+void transform_quat_pose_init_identity(
+  transform_quat_pose_t* pose);
+
+/** \brief Initialize quaternion pose from pose
+  * \param[in] quat_pose The quaternion pose to be initialized.
+  * \param[in] pose The pose to initialize the quaternion pose from.
+  */
+void transform_quat_pose_init_pose(
+  transform_quat_pose_t* quat_pose,
+  const transform_pose_t* pose);
+
+/** \brief Initialize quaternion pose from transform
+  * \param[in] pose The quaternion pose to be initialized.
+  * \param[in] transform The rigid transform to initialize the quaternion
+  *   pose from.
+  */
+void transform_quat_pose_init_transform(
+  transform_quat_pose_t* pose,
+  transform_t transform);
+
+/** \brief Convert quaternion pose to pose
+  * \param[in] quat_pose The quaternion pose to be converted.
+  * \param[out] pose The pose holding the converted quaternion pose.
+  */
+void transform_quat_pose_to_pose(
+  const transform_quat_pose_t* quat_pose,
+  transform_pose_t* pose);
+
+/** \brief Convert quaternion pose to transform
+  * \param[in] pose The quaternion pose to be converted.
+  * \param[out] transform The transform holding the converted quaternion
+  *   pose.
+  */
+void transform_quat_pose_to_transform(
+  const transform_quat_pose_t* pose,
+  transform_t transform);
+
+/** \brief Copy quaternion pose
+  * \param[in] dst The destination quaternion pose to copy to.
+  * \param[in] src The source quaternion pose to copy from.
+  */
+void transform_quat_pose_copy(
+  transform_quat_pose_t* dst,
+  const transform_quat_pose_t* src);
+
+/** \brief Print quaternion pose
+  * \param[in] stream The output stream that will be used for printing the
+  *   quaternion pose.
+  * \param[in] pose The quaternion pose that will be printed.
+  */
+void transform_quat_pose_print(
+  FILE* stream,
+  const transform_quat_pose_t* pose);
+
+/** \brief Left-multiply quaternion pose with another quaternion pose
+  * \param[in,out] right The quaternion pose that will be the right-hand
+  *   factor of the composition and hold the result.
+  * \param[in] left The quaternion pose that will be the left-hand factor
+  *   of the composition.
+  *
+  * The composition corresponds to the multiplication of the transforms
+  * of the quaternion poses, i.e., the right-hand pose is applied first.
+  */
+void transform_quat_pose_multiply_left(
+  transform_quat_pose_t* right,
+  const transform_quat_pose_t* left);
+
+/** \brief Invert quaternion pose
+  * \param[in,out] pose The quaternion pose that will be inverted.
+  */
+void transform_quat_pose_invert(
+  transform_quat_pose_t* pose);
+
+/** \brief Transform point by quaternion pose
+  * \param[in] pose The quaternion pose to apply to the point.
+  * \param[in,out] point The point to be transformed.
+  */
+void transform_quat_pose_point(
+  const transform_quat_pose_t* pose,
+  transform_point_t* point);
+
+/** \brief Interpolate between two quaternion poses
+  * \param[in] start The quaternion pose at the start of the interpolation.
+  * \param[in] end The quaternion pose at the end of the interpolation.
+  * \param[in] u The interpolation parameter in [0, 1].
+  * \param[in] type The interpolation type applied to the rotations.
+  * \param[out] result The interpolated quaternion pose.
+  *
+  * The translation is interpolated linearly.
+  */
+void transform_quat_pose_interpolate(
+  const transform_quat_pose_t* start,
+  const transform_quat_pose_t* end,
+  double u,
+  transform_quat_pose_interpolation_t type,
+  transform_quat_pose_t* result);
+
+/** \brief Interpolate an array of timestamped quaternion poses
+  * \param[in] timestamps The array of strictly increasing timestamps of
+  *   the quaternion poses.
+  * \param[in] poses The array of quaternion poses to be interpolated.
+  * \param[in] num_poses The number of timestamps and quaternion poses.
+  * \param[in] times The array of times at which to interpolate.
+  * \param[out] result The array of interpolated quaternion poses, one for
+  *   each time.
+  * \param[in] num_times The number of times at which to interpolate.
+  * \param[in] type The interpolation type applied to the rotations.
+  *
+  * Times outside the range of timestamps are clamped to the first or
+  * last pose, respectively. The interval enclosing each time is searched
+  * starting from the interval of the previous time, such that increasing
+  * times are interpolated in O(N+M) for N poses and M times. Should two
+  * consecutive timestamps not be strictly increasing, times within their
+  * interval yield the left pose instead of an interpolated one.
+  */
+void transform_quat_pose_interpolate_array(
+  const double* timestamps,
+  const transform_quat_pose_t* poses,
+  size_t num_poses,
+  const double* times,
+  transform_quat_pose_t* result,
+  size_t num_times,
+  transform_quat_pose_interpolation_t type);
+
+#endif
@@ -0,0 +1,217 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <math.h>
+
+#include "quaternion.h"
+
+#define TRANSFORM_QUATERNION_SLERP_THRESHOLD 0.9995
+
+void transform_quaternion_init(transform_quaternion_t* quaternion, double w,
+    double x, double y, double z) {
+  quaternion->w = w;
+  quaternion->x = x;
+  quaternion->y = y;
+  quaternion->z = z;
+}
+
+void transform_quaternion_init_identity(transform_quaternion_t* quaternion) {
+  transform_quaternion_init(quaternion, 1.0, 0.0, 0.0, 0.0);
+}
+
+void transform_quaternion_init_rotation(transform_quaternion_t* quaternion,
+    double yaw, double pitch, double roll) {
+  double c_y = cos(0.5*yaw), s_y = sin(0.5*yaw);
+  double c_p = cos(0.5*pitch), s_p = sin(0.5*pitch);
+  double c_r = cos(0.5*roll), s_r = sin(0.5*roll);
+
+  quaternion->w = c_r*c_p*c_y+s_r*s_p*s_y;
+  quaternion->x = s_r*c_p*c_y-c_r*s_p*s_y;
+  quaternion->y = c_r*s_p*c_y+s_r*c_p*s_y;
+  quaternion->z = c_r*c_p*s_y-s_r*s_p*c_y;
+}
+
+void transform_quaternion_init_transform(transform_quaternion_t* quaternion,
+    transform_t transform) {
+  double trace = transform[0][0]+transform[1][1]+transform[2][2];
+  double s;
+
+  if (trace > 0.0) {
+    s = 2.0*sqrt(1.0+trace);
+    quaternion->w = 0.25*s;
+    quaternion->x = (transform[2][1]-transform[1][2])/s;
+    quaternion->y = (transform[0][2]-transform[2][0])/s;
+    quaternion->z = (transform[1][0]-transform[0][1])/s;
+  }
+  else if ((transform[0][0] > transform[1][1]) &&
+      (transform[0][0] > transform[2][2])) {
+    s = 2.0*sqrt(1.0+transform[0][0]-transform[1][1]-transform[2][2]);
+    quaternion->w = (transform[2][1]-transform[1][2])/s;
+    quaternion->x = 0.25*s;
+    quaternion->y = (transform[0][1]+transform[1][0])/s;
+    quaternion->z = (transform[0][2]+transform[2][0])/s;
+  }
+  else if (transform[1][1] > transform[2][2]) {
+    s = 2.0*sqrt(1.0+transform[1][1]-transform[0][0]-transform[2][2]);
+    quaternion->w = (transform[0][2]-transform[2][0])/s;
+    quaternion->x = (transform[0][1]+transform[1][0])/s;
+    quaternion->y = 0.25*s;
+    quaternion->z = (transform[1][2]+transform[2][1])/s;
+  }
+  else {
+    s = 2.0*sqrt(1.0+transform[2][2]-transform[0][0]-transform[1][1]);
+    quaternion->w = (transform[1][0]-transform[0][1])/s;
+    quaternion->x = (transform[0][2]+transform[2][0])/s;
+    quaternion->y = (transform[1][2]+transform[2][1])/s;
+    quaternion->z = 0.25*s;
+  }
+}
+
+void transform_quaternion_get_rotation(const transform_quaternion_t*
+    quaternion, double* yaw, double* pitch, double* roll) {
+  double w = quaternion->w, x = quaternion->x, y = quaternion->y,
+    z = quaternion->z;
+  double s_p = 2.0*(w*y-z*x);
+
+  *yaw = atan2(2.0*(w*z+x*y), 1.0-2.0*(y*y+z*z));
+  *pitch = asin(fmin(fmax(s_p, -1.0), 1.0));
+  *roll = atan2(2.0*(w*x+y*z), 1.0-2.0*(x*x+y*y));
+}
+
+void transform_quaternion_to_transform(const transform_quaternion_t*
+    quaternion, transform_t transform) {
+  double w = quaternion->w, x = quaternion->x, y = quaternion->y,
+    z = quaternion->z;
+
+  transform[0][0] = 1.0-2.0*(y*y+z*z);
+  transform[0][1] = 2.0*(x*y-w*z);
+  transform[0][2] = 2.0*(x*z+w*y);
+  transform[0][3] = 0.0;
+
+  transform[1][0] = 2.0*(x*y+w*z);
+  transform[1][1] = 1.0-2.0*(x*x+z*z);
+  transform[1][2] = 2.0*(y*z-w*x);
+  transform[1][3] = 0.0;
+
+  transform[2][0] = 2.0*(x*z-w*y);
+  transform[2][1] = 2.0*(y*z+w*x);
+  transform[2][2] = 1.0-2.0*(x*x+y*y);
+  transform[2][3] = 0.0;
+
+  transform[3][0] = 0.0;
+  transform[3][1] = 0.0;
+  transform[3][2] = 0.0;
+  transform[3][3] = 1.0;
+}
+
+void transform_quaternion_copy(transform_quaternion_t* dst, const
+    transform_quaternion_t* src) {
+  dst->w = src->w;
+  dst->x = src->x;
+  dst->y = src->y;
+  dst->z = src->z;
+}
+
+void transform_quaternion_print(FILE* stream, const transform_quaternion_t*
+    quaternion) {
+  fprintf(stream, "%10lg %10lg %10lg %10lg",
+    quaternion->w,
+    quaternion->x,
+    quaternion->y,
+    quaternion->z);
+}
+
+void transform_quaternion_normalize(transform_quaternion_t* quaternion) {
+  double s = 1.0/sqrt(quaternion->w*quaternion->w+
+    quaternion->x*quaternion->x+quaternion->y*quaternion->y+
+    quaternion->z*quaternion->z);
+
+  quaternion->w *= s;
+  quaternion->x *= s;
+  quaternion->y *= s;
+  quaternion->z *= s;
+}
+
+void transform_quaternion_multiply_left(transform_quaternion_t* right,
+    const transform_quaternion_t* left) {
+  double w = right->w, x = right->x, y = right->y, z = right->z;
+
+  right->w = left->w*w-left->x*x-left->y*y-left->z*z;
+  right->x = left->w*x+left->x*w+left->y*z-left->z*y;
+  right->y = left->w*y-left->x*z+left->y*w+left->z*x;
+  right->z = left->w*z+left->x*y-left->y*x+left->z*w;
+}
+
+void transform_quaternion_invert(transform_quaternion_t* quaternion) {
+  quaternion->x = -quaternion->x;
+  quaternion->y = -quaternion->y;
+  quaternion->z = -quaternion->z;
+}
+
+void transform_quaternion_rotate_point(const transform_quaternion_t*
+    quaternion, transform_point_t* point) {
+  double w = quaternion->w, x = quaternion->x, y = quaternion->y,
+    z = quaternion->z;
+  double t_x = 2.0*(y*point->z-z*point->y);
+  double t_y = 2.0*(z*point->x-x*point->z);
+  double t_z = 2.0*(x*point->y-y*point->x);
+
+  point->x += w*t_x+y*t_z-z*t_y;
+  point->y += w*t_y+z*t_x-x*t_z;
+  point->z += w*t_z+x*t_y-y*t_x;
+}
+
+void transform_quaternion_slerp(const transform_quaternion_t* start, const
+    transform_quaternion_t* end, double u, transform_quaternion_t* result) {
+  double d = start->w*end->w+start->x*end->x+start->y*end->y+
+    start->z*end->z;
+  double theta, sin_theta, a, b;
+
+  if (fabs(d) > TRANSFORM_QUATERNION_SLERP_THRESHOLD) {
+    transform_quaternion_nlerp(start, end, u, result);
+    return;
+  }
+
+  theta = acos(fabs(d));
+  sin_theta = sin(theta);
+  a = sin((1.0-u)*theta)/sin_theta;
+  b = sin(u*theta)/sin_theta;
+  if (d < 0.0)
+    b = -b;
+
+  result->w = a*start->w+b*end->w;
+  result->x = a*start->x+b*end->x;
+  result->y = a*start->y+b*end->y;
+  result->z = a*start->z+b*end->z;
+}
+
+void transform_quaternion_nlerp(const transform_quaternion_t* start, const
+    transform_quaternion_t* end, double u, transform_quaternion_t* result) {
+  double d = start->w*end->w+start->x*end->x+start->y*end->y+
+    start->z*end->z;
+  double a = 1.0-u, b = (d < 0.0) ? -u : u;
+
+  result->w = a*start->w+b*end->w;
+  result->x = a*start->x+b*end->x;
+  result->y = a*start->y+b*end->y;
+  result->z = a*start->z+b*end->z;
+
+  transform_quaternion_normalize(result);
+}
@@ -0,0 +1,195 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_QUATERNION_H
+#define TRANSFORM_QUATERNION_H
+
+/** \file transform/quaternion.h
+  * \ingroup transform
+  * \brief Quaternion definition for the linear transformation module
+  * \author Ralf Kaestner
+  *
+  * A unit quaternion represents a rotation in 3-dimensional space by four
+  * components. Compared to rotation matrices, quaternions are composed
+  * with fewer operations and may be interpolated directly. The Euler
+  * angle conventions follow transform_init_rotation().
+  */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "transform/transform.h"
+
+/** \brief Structure defining a quaternion
+  *
+  * A quaternion is defined by its scalar w-component and its vectorial
+  * x, y, and z-components.
+  */
+typedef struct transform_quaternion_t {
+  double w;                    //!< The w-component of the quaternion.
+  double x;                    //!< The x-component of the quaternion.
+  double y;                    //!< The y-component of the quaternion.
+  double z;                    //!< The z-component of the quaternion.
+} transform_quaternion_t;
+
+/** \brief Initialize quaternion
+  * \param[in] quaternion The quaternion to be initialized.
+  * \param[in] w The initial w-component of the quaternion.
+  * \param[in] x The initial x-component of the quaternion.
+  * \param[in] y The initial y-component of the quaternion.
+  * \param[in] z The initial z-component of the quaternion.
+  */
+void transform_quaternion_init(
+  transform_quaternion_t* quaternion,
+  double w,
+  double x,
+  double y,
+  double z);
+
+/** \brief Initialize identity quaternion
+  * \param[in] quaternion The quaternion to be initialized to identity.
+  */
+void transform_quaternion_init_identity(
+  transform_quaternion_t* quaternion);
+
+/** \brief Initialize quaternion from Euler angles
+  * \param[in] quaternion The quaternion to be initialized with a rotation.
+  * \param[in] yaw The initial rotation about the z-axis in [rad].
+  * \param[in] pitch The initial rotation about the y-axis [rad].
+  * \param[in] roll The initial rotation about the x-axis [rad].
+  */
+void transform_quaternion_init_rotation(
+  transform_quaternion_t* quaternion,
+  double yaw,
+  double pitch,
+  double roll);
+
+/** \brief Initialize quaternion from transform
+  * \param[in] quaternion The quaternion to be initialized.
+  * \param[in] transform The transform whose upper-left 3x3 block is
+  *   assumed to be a rotation matrix.
+  */
+void transform_quaternion_init_transform(
+  transform_quaternion_t* quaternion,
+  transform_t transform);
+
+/** \brief Convert quaternion to Euler angles
+  * \param[in] quaternion The unit quaternion to be converted.
+  * \param[out] yaw The rotation about the z-axis in [rad].
+  * \param[out] pitch The rotation about the y-axis in [rad].
+  * \param[out] roll The rotation about the x-axis in [rad].
+  */
+void transform_quaternion_get_rotation(
+  const transform_quaternion_t* quaternion,
+  double* yaw,
+  double* pitch,
+  double* roll);
+
+/** \brief Convert quaternion to transform
+  * \param[in] quaternion The unit quaternion to be converted.
+  * \param[out] transform The transform holding the rotation represented
+  *   by the quaternion.
+  */
+void transform_quaternion_to_transform(
+  const transform_quaternion_t* quaternion,
+  transform_t transform);
+
+/** \brief Copy quaternion
+  * \param[in] dst The destination quaternion to copy to.
+  * \param[in] src The source quaternion to copy from.
+  */
+void transform_quaternion_copy(
+  transform_quaternion_t* dst,
+  const transform_quaternion_t* src);
+
+/** \brief Print quaternion
+  * \param[in] stream The output stream that will be used for printing the
+  *   quaternion.
+  * \param[in] quaternion The quaternion that will be printed.
+  */
+void transform_quaternion_print(
+  FILE* stream,
+  const transform_quaternion_t* quaternion);
+
+/** \brief Normalize quaternion
+  * \param[in,out] quaternion The quaternion to be normalized to unit
+  *   length.
+  */
+void transform_quaternion_normalize(
+  transform_quaternion_t* quaternion);
+
+/** \brief Left-multiply quaternion with another quaternion
+  * \param[in,out] right The quaternion that will be the right-hand factor
+  *   of the multiplication and hold the result.
+  * \param[in] left The quaternion that will be the left-hand factor of the
+  *   multiplication.
+  */
+void transform_quaternion_multiply_left(
+  transform_quaternion_t* right,
+  const transform_quaternion_t* left);
+
+/** \brief Invert unit quaternion
+  * \param[in,out] quaternion The unit quaternion that will be inverted
+  *   by conjugation.
+  */
+void transform_quaternion_invert(
+  transform_quaternion_t* quaternion);
+
+/** \brief Rotate point by unit quaternion
+  * \param[in] quaternion The unit quaternion to rotate the point by.
+  * \param[in,out] point The point to be rotated.
+  */
+void transform_quaternion_rotate_point(
+  const transform_quaternion_t* quaternion,
+  transform_point_t* point);
+
+/** \brief Spherically interpolate between two unit quaternions
+  * \param[in] start The unit quaternion at the start of the interpolation.
+  * \param[in] end The unit quaternion at the end of the interpolation.
+  * \param[in] u The interpolation parameter in [0, 1].
+  * \param[out] result The interpolated unit quaternion.
+  *
+  * The interpolation follows the shorter arc between the rotations and
+  * proceeds at constant angular velocity. For nearly identical rotations,
+  * it falls back to normalized linear interpolation.
+  */
+void transform_quaternion_slerp(
+  const transform_quaternion_t* start,
+  const transform_quaternion_t* end,
+  double u,
+  transform_quaternion_t* result);
+
+/** \brief Linearly interpolate between two unit quaternions
+  * \param[in] start The unit quaternion at the start of the interpolation.
+  * \param[in] end The unit quaternion at the end of the interpolation.
+  * \param[in] u The interpolation parameter in [0, 1].
+  * \param[out] result The interpolated and normalized unit quaternion.
+  *
+  * The interpolation follows the shorter arc between the rotations, but
+  * its angular velocity is not constant. It is cheaper than spherical
+  * interpolation and accurate for small angles.
+  */
+void transform_quaternion_nlerp(
+  const transform_quaternion_t* start,
+  const transform_quaternion_t* end,
+  double u,
+  transform_quaternion_t* result);
+
+#endif
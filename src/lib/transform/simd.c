@@ -0,0 +1,768 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <math.h>
+#include <pthread.h>
+
+#include "simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRANSFORM_SIMD_X86
+#include <immintrin.h>
+#endif
+
+const char* transform_simd_types[] = {
+  "none",
+  "avx2",
+  "avx512",
+};
+
+const char* transform_simd_precisions[] = {
+  "single",
+  "double",
+};
+
+static pthread_once_t transform_simd_once = PTHREAD_ONCE_INIT;
+
+static transform_simd_type_t transform_simd_type = transform_simd_type_none;
+static transform_simd_kernel_t transform_simd_kernel = 0;
+static transform_simd_float_kernel_t transform_simd_float_kernels[2] = {0, 0};
+static transform_simd_strided_kernel_t transform_simd_strided_kernel = 0;
+static transform_simd_sincos_t transform_simd_sincos_kernel = 0;
+static transform_simd_linear_kernel_t transform_simd_linear_kernel = 0;
+
+static const double transform_simd_pio2[] = {
+  1.57079632673412561417e+00,
+  6.07710050630396597660e-11,
+  2.02226624871116645580e-21,
+};
+
+static const double transform_simd_sin_coefficients[] = {
+  1.58962301576546568060e-10,
+  -2.50507477628578072866e-08,
+  2.75573136213857245213e-06,
+  -1.98412698295895385996e-04,
+  8.33333333332211858878e-03,
+  -1.66666666666666307295e-01,
+};
+
+static const double transform_simd_cos_coefficients[] = {
+  -1.13585365213876817300e-11,
+  2.08757008419747316778e-09,
+  -2.75573141792967388112e-07,
+  2.48015872888517045348e-05,
+  -1.38888888888730564116e-03,
+  4.16666666666665929218e-02,
+};
+
+void transform_simd_points(const double (*transform)[4], const double* x,
+    const double* y, const double* z, double* x_t, double* y_t, double* z_t,
+    size_t num_points) {
+  double r_00 = transform[0][0], r_01 = transform[0][1],
+    r_02 = transform[0][2], t_0 = transform[0][3];
+  double r_10 = transform[1][0], r_11 = transform[1][1],
+    r_12 = transform[1][2], t_1 = transform[1][3];
+  double r_20 = transform[2][0], r_21 = transform[2][1],
+    r_22 = transform[2][2], t_2 = transform[2][3];
+  size_t i;
+
+  for (i = 0; i < num_points; ++i) {
+    double p_x = x[i], p_y = y[i], p_z = z[i];
+
+    x_t[i] = r_00*p_x+r_01*p_y+r_02*p_z+t_0;
+    y_t[i] = r_10*p_x+r_11*p_y+r_12*p_z+t_1;
+    z_t[i] = r_20*p_x+r_21*p_y+r_22*p_z+t_2;
+  }
+}
+
+void transform_simd_float_points(const double (*transform)[4], const float*
+    x, const float* y, const float* z, float* x_t, float* y_t, float* z_t,
+    size_t num_points) {
+  float r_00 = transform[0][0], r_01 = transform[0][1],
+    r_02 = transform[0][2], t_0 = transform[0][3];
+  float r_10 = transform[1][0], r_11 = transform[1][1],
+    r_12 = transform[1][2], t_1 = transform[1][3];
+  float r_20 = transform[2][0], r_21 = transform[2][1],
+    r_22 = transform[2][2], t_2 = transform[2][3];
+  size_t i;
+
+  for (i = 0; i < num_points; ++i) {
+    float p_x = x[i], p_y = y[i], p_z = z[i];
+
+    x_t[i] = r_00*p_x+r_01*p_y+r_02*p_z+t_0;
+    y_t[i] = r_10*p_x+r_11*p_y+r_12*p_z+t_1;
+    z_t[i] = r_20*p_x+r_21*p_y+r_22*p_z+t_2;
+  }
+}
+
+void transform_simd_float_points_double(const double (*transform)[4], const
+    float* x, const float* y, const float* z, float* x_t, float* y_t, float*
+    z_t, size_t num_points) {
+  double r_00 = transform[0][0], r_01 = transform[0][1],
+    r_02 = transform[0][2], t_0 = transform[0][3];
+  double r_10 = transform[1][0], r_11 = transform[1][1],
+    r_12 = transform[1][2], t_1 = transform[1][3];
+  double r_20 = transform[2][0], r_21 = transform[2][1],
+    r_22 = transform[2][2], t_2 = transform[2][3];
+  size_t i;
+
+  for (i = 0; i < num_points; ++i) {
+    double p_x = x[i], p_y = y[i], p_z = z[i];
+
+    x_t[i] = r_00*p_x+r_01*p_y+r_02*p_z+t_0;
+    y_t[i] = r_10*p_x+r_11*p_y+r_12*p_z+t_1;
+    z_t[i] = r_20*p_x+r_21*p_y+r_22*p_z+t_2;
+  }
+}
+
+void transform_simd_points_strided(const double (*transform)[4], char* x,
+    char* y, char* z, size_t stride, size_t num_points) {
+  double r_00 = transform[0][0], r_01 = transform[0][1],
+    r_02 = transform[0][2], t_0 = transform[0][3];
+  double r_10 = transform[1][0], r_11 = transform[1][1],
+    r_12 = transform[1][2], t_1 = transform[1][3];
+  double r_20 = transform[2][0], r_21 = transform[2][1],
+    r_22 = transform[2][2], t_2 = transform[2][3];
+  size_t i;
+
+  for (i = 0; i < num_points; ++i, x += stride, y += stride, z += stride) {
+    double p_x = *(double*)x, p_y = *(double*)y, p_z = *(double*)z;
+
+    *(double*)x = r_00*p_x+r_01*p_y+r_02*p_z+t_0;
+    *(double*)y = r_10*p_x+r_11*p_y+r_12*p_z+t_1;
+    *(double*)z = r_20*p_x+r_21*p_y+r_22*p_z+t_2;
+  }
+}
+
+void transform_simd_sincos(const double* x, double* sin_x, double* cos_x,
+    size_t num_values) {
+  size_t i;
+
+  for (i = 0; i < num_values; ++i) {
+    double x_i = x[i];
+
+    sin_x[i] = sin(x_i);
+    cos_x[i] = cos(x_i);
+  }
+}
+
+void transform_simd_linear(const double* a, const double* c, size_t dim,
+    const double* x, double* y, size_t num_vectors) {
+  double y_j[TRANSFORM_SIMD_LINEAR_MAX_DIMENSION];
+  size_t i, j, k;
+
+  for (j = 0; j < num_vectors; ++j, x += dim, y += dim) {
+    for (k = 0; k < dim; ++k) {
+      const double* a_k = &a[k*dim];
+      double y_k = c ? c[k] : 0.0;
+
+      for (i = 0; i < dim; ++i)
+        y_k += a_k[i]*x[i];
+      y_j[k] = y_k;
+    }
+
+    for (k = 0; k < dim; ++k)
+      y[k] = y_j[k];
+  }
+}
+
+#ifdef TRANSFORM_SIMD_X86
+__attribute__((target("avx2,fma")))
+static void transform_simd_points_avx2(const double (*transform)[4], const
+    double* x, const double* y, const double* z, double* x_t, double* y_t,
+    double* z_t, size_t num_points) {
+  __m256d r_00 = _mm256_set1_pd(transform[0][0]),
+    r_01 = _mm256_set1_pd(transform[0][1]),
+    r_02 = _mm256_set1_pd(transform[0][2]),
+    t_0 = _mm256_set1_pd(transform[0][3]);
+  __m256d r_10 = _mm256_set1_pd(transform[1][0]),
+    r_11 = _mm256_set1_pd(transform[1][1]),
+    r_12 = _mm256_set1_pd(transform[1][2]),
+    t_1 = _mm256_set1_pd(transform[1][3]);
+  __m256d r_20 = _mm256_set1_pd(transform[2][0]),
+    r_21 = _mm256_set1_pd(transform[2][1]),
+    r_22 = _mm256_set1_pd(transform[2][2]),
+    t_2 = _mm256_set1_pd(transform[2][3]);
+  size_t i;
+
+  for (i = 0; i+4 <= num_points; i += 4) {
+    __m256d p_x = _mm256_loadu_pd(&x[i]);
+    __m256d p_y = _mm256_loadu_pd(&y[i]);
+    __m256d p_z = _mm256_loadu_pd(&z[i]);
+
+    _mm256_storeu_pd(&x_t[i], _mm256_fmadd_pd(r_00, p_x,
+      _mm256_fmadd_pd(r_01, p_y, _mm256_fmadd_pd(r_02, p_z, t_0))));
+    _mm256_storeu_pd(&y_t[i], _mm256_fmadd_pd(r_10, p_x,
+      _mm256_fmadd_pd(r_11, p_y, _mm256_fmadd_pd(r_12, p_z, t_1))));
+    _mm256_storeu_pd(&z_t[i], _mm256_fmadd_pd(r_20, p_x,
+      _mm256_fmadd_pd(r_21, p_y, _mm256_fmadd_pd(r_22, p_z, t_2))));
+  }
+
+  transform_simd_points(transform, &x[i], &y[i], &z[i], &x_t[i], &y_t[i],
+    &z_t[i], num_points-i);
+}
+
+__attribute__((target("avx512f")))
+static void transform_simd_points_avx512(const double (*transform)[4], const
+    double* x, const double* y, const double* z, double* x_t, double* y_t,
+    double* z_t, size_t num_points) {
+  __m512d r_00 = _mm512_set1_pd(transform[0][0]),
+    r_01 = _mm512_set1_pd(transform[0][1]),
+    r_02 = _mm512_set1_pd(transform[0][2]),
+    t_0 = _mm512_set1_pd(transform[0][3]);
+  __m512d r_10 = _mm512_set1_pd(transform[1][0]),
+    r_11 = _mm512_set1_pd(transform[1][1]),
+    r_12 = _mm512_set1_pd(transform[1][2]),
+    t_1 = _mm512_set1_pd(transform[1][3]);
+  __m512d r_20 = _mm512_set1_pd(transform[2][0]),
+    r_21 = _mm512_set1_pd(transform[2][1]),
+    r_22 = _mm512_set1_pd(transform[2][2]),
+    t_2 = _mm512_set1_pd(transform[2][3]);
+  size_t i;
+
+  for (i = 0; i < num_points; i += 8) {
+    __mmask8 mask = (num_points-i >= 8) ? 0xff :
+      (__mmask8)((1u << (num_points-i))-1);
+    __m512d p_x = _mm512_maskz_loadu_pd(mask, &x[i]);
+    __m512d p_y = _mm512_maskz_loadu_pd(mask, &y[i]);
+    __m512d p_z = _mm512_maskz_loadu_pd(mask, &z[i]);
+
+    _mm512_mask_storeu_pd(&x_t[i], mask, _mm512_fmadd_pd(r_00, p_x,
+      _mm512_fmadd_pd(r_01, p_y, _mm512_fmadd_pd(r_02, p_z, t_0))));
+    _mm512_mask_storeu_pd(&y_t[i], mask, _mm512_fmadd_pd(r_10, p_x,
+      _mm512_fmadd_pd(r_11, p_y, _mm512_fmadd_pd(r_12, p_z, t_1))));
+    _mm512_mask_storeu_pd(&z_t[i], mask, _mm512_fmadd_pd(r_20, p_x,
+      _mm512_fmadd_pd(r_21, p_y, _mm512_fmadd_pd(r_22, p_z, t_2))));
+  }
+}
+
+__attribute__((target("avx2,fma")))
+static void transform_simd_float_points_avx2(const double (*transform)[4], const
+    float* x, const float* y, const float* z, float* x_t, float* y_t, float*
+    z_t, size_t num_points) {
+  __m256 r_00 = _mm256_set1_ps(transform[0][0]),
+    r_01 = _mm256_set1_ps(transform[0][1]),
+    r_02 = _mm256_set1_ps(transform[0][2]),
+    t_0 = _mm256_set1_ps(transform[0][3]);
+  __m256 r_10 = _mm256_set1_ps(transform[1][0]),
+    r_11 = _mm256_set1_ps(transform[1][1]),
+    r_12 = _mm256_set1_ps(transform[1][2]),
+    t_1 = _mm256_set1_ps(transform[1][3]);
+  __m256 r_20 = _mm256_set1_ps(transform[2][0]),
+    r_21 = _mm256_set1_ps(transform[2][1]),
+    r_22 = _mm256_set1_ps(transform[2][2]),
+    t_2 = _mm256_set1_ps(transform[2][3]);
+  size_t i;
+
+  for (i = 0; i+8 <= num_points; i += 8) {
+    __m256 p_x = _mm256_loadu_ps(&x[i]);
+    __m256 p_y = _mm256_loadu_ps(&y[i]);
+    __m256 p_z = _mm256_loadu_ps(&z[i]);
+
+    _mm256_storeu_ps(&x_t[i], _mm256_fmadd_ps(r_00, p_x,
+      _mm256_fmadd_ps(r_01, p_y, _mm256_fmadd_ps(r_02, p_z, t_0))));
+    _mm256_storeu_ps(&y_t[i], _mm256_fmadd_ps(r_10, p_x,
+      _mm256_fmadd_ps(r_11, p_y, _mm256_fmadd_ps(r_12, p_z, t_1))));
+    _mm256_storeu_ps(&z_t[i], _mm256_fmadd_ps(r_20, p_x,
+      _mm256_fmadd_ps(r_21, p_y, _mm256_fmadd_ps(r_22, p_z, t_2))));
+  }
+
+  transform_simd_float_points(transform, &x[i], &y[i], &z[i], &x_t[i],
+    &y_t[i], &z_t[i], num_points-i);
+}
+
+__attribute__((target("avx2,fma")))
+static void transform_simd_float_points_double_avx2(const
+    double (*transform)[4], const float* x, const float* y, const float* z,
+    float* x_t, float* y_t, float* z_t, size_t num_points) {
+  __m256d r_00 = _mm256_set1_pd(transform[0][0]),
+    r_01 = _mm256_set1_pd(transform[0][1]),
+    r_02 = _mm256_set1_pd(transform[0][2]),
+    t_0 = _mm256_set1_pd(transform[0][3]);
+  __m256d r_10 = _mm256_set1_pd(transform[1][0]),
+    r_11 = _mm256_set1_pd(transform[1][1]),
+    r_12 = _mm256_set1_pd(transform[1][2]),
+    t_1 = _mm256_set1_pd(transform[1][3]);
+  __m256d r_20 = _mm256_set1_pd(transform[2][0]),
+    r_21 = _mm256_set1_pd(transform[2][1]),
+    r_22 = _mm256_set1_pd(transform[2][2]),
+    t_2 = _mm256_set1_pd(transform[2][3]);
+  size_t i;
+
+  for (i = 0; i+4 <= num_points; i += 4) {
+    __m256d p_x = _mm256_cvtps_pd(_mm_loadu_ps(&x[i]));
+    __m256d p_y = _mm256_cvtps_pd(_mm_loadu_ps(&y[i]));
+    __m256d p_z = _mm256_cvtps_pd(_mm_loadu_ps(&z[i]));
+
+    _mm_storeu_ps(&x_t[i], _mm256_cvtpd_ps(_mm256_fmadd_pd(r_00, p_x,
+      _mm256_fmadd_pd(r_01, p_y, _mm256_fmadd_pd(r_02, p_z, t_0)))));
+    _mm_storeu_ps(&y_t[i], _mm256_cvtpd_ps(_mm256_fmadd_pd(r_10, p_x,
+      _mm256_fmadd_pd(r_11, p_y, _mm256_fmadd_pd(r_12, p_z, t_1)))));
+    _mm_storeu_ps(&z_t[i], _mm256_cvtpd_ps(_mm256_fmadd_pd(r_20, p_x,
+      _mm256_fmadd_pd(r_21, p_y, _mm256_fmadd_pd(r_22, p_z, t_2)))));
+  }
+
+  transform_simd_float_points_double(transform, &x[i], &y[i], &z[i],
+    &x_t[i], &y_t[i], &z_t[i], num_points-i);
+}
+
+__attribute__((target("avx512f")))
+static void transform_simd_float_points_avx512(const double (*transform)[4],
+    const float* x, const float* y, const float* z, float* x_t, float* y_t,
+    float* z_t, size_t num_points) {
+  __m512 r_00 = _mm512_set1_ps(transform[0][0]),
+    r_01 = _mm512_set1_ps(transform[0][1]),
+    r_02 = _mm512_set1_ps(transform[0][2]),
+    t_0 = _mm512_set1_ps(transform[0][3]);
+  __m512 r_10 = _mm512_set1_ps(transform[1][0]),
+    r_11 = _mm512_set1_ps(transform[1][1]),
+    r_12 = _mm512_set1_ps(transform[1][2]),
+    t_1 = _mm512_set1_ps(transform[1][3]);
+  __m512 r_20 = _mm512_set1_ps(transform[2][0]),
+    r_21 = _mm512_set1_ps(transform[2][1]),
+    r_22 = _mm512_set1_ps(transform[2][2]),
+    t_2 = _mm512_set1_ps(transform[2][3]);
+  size_t i;
+
+  for (i = 0; i < num_points; i += 16) {
+    __mmask16 mask = (num_points-i >= 16) ? 0xffff :
+      (__mmask16)((1u << (num_points-i))-1);
+    __m512 p_x = _mm512_maskz_loadu_ps(mask, &x[i]);
+    __m512 p_y = _mm512_maskz_loadu_ps(mask, &y[i]);
+    __m512 p_z = _mm512_maskz_loadu_ps(mask, &z[i]);
+
+    _mm512_mask_storeu_ps(&x_t[i], mask, _mm512_fmadd_ps(r_00, p_x,
+      _mm512_fmadd_ps(r_01, p_y, _mm512_fmadd_ps(r_02, p_z, t_0))));
+    _mm512_mask_storeu_ps(&y_t[i], mask, _mm512_fmadd_ps(r_10, p_x,
+      _mm512_fmadd_ps(r_11, p_y, _mm512_fmadd_ps(r_12, p_z, t_1))));
+    _mm512_mask_storeu_ps(&z_t[i], mask, _mm512_fmadd_ps(r_20, p_x,
+      _mm512_fmadd_ps(r_21, p_y, _mm512_fmadd_ps(r_22, p_z, t_2))));
+  }
+}
+
+__attribute__((target("avx512f")))
+static void transform_simd_float_points_double_avx512(const
+    double (*transform)[4], const float* x, const float* y, const float* z,
+    float* x_t, float* y_t, float* z_t, size_t num_points) {
+  __m512d r_00 = _mm512_set1_pd(transform[0][0]),
+    r_01 = _mm512_set1_pd(transform[0][1]),
+    r_02 = _mm512_set1_pd(transform[0][2]),
+    t_0 = _mm512_set1_pd(transform[0][3]);
+  __m512d r_10 = _mm512_set1_pd(transform[1][0]),
+    r_11 = _mm512_set1_pd(transform[1][1]),
+    r_12 = _mm512_set1_pd(transform[1][2]),
+    t_1 = _mm512_set1_pd(transform[1][3]);
+  __m512d r_20 = _mm512_set1_pd(transform[2][0]),
+    r_21 = _mm512_set1_pd(transform[2][1]),
+    r_22 = _mm512_set1_pd(transform[2][2]),
+    t_2 = _mm512_set1_pd(transform[2][3]);
+  size_t i;
+
+  for (i = 0; i+8 <= num_points; i += 8) {
+    __m512d p_x = _mm512_cvtps_pd(_mm256_loadu_ps(&x[i]));
+    __m512d p_y = _mm512_cvtps_pd(_mm256_loadu_ps(&y[i]));
+    __m512d p_z = _mm512_cvtps_pd(_mm256_loadu_ps(&z[i]));
+
+    _mm256_storeu_ps(&x_t[i], _mm512_cvtpd_ps(_mm512_fmadd_pd(r_00, p_x,
+      _mm512_fmadd_pd(r_01, p_y, _mm512_fmadd_pd(r_02, p_z, t_0)))));
+    _mm256_storeu_ps(&y_t[i], _mm512_cvtpd_ps(_mm512_fmadd_pd(r_10, p_x,
+      _mm512_fmadd_pd(r_11, p_y, _mm512_fmadd_pd(r_12, p_z, t_1)))));
+    _mm256_storeu_ps(&z_t[i], _mm512_cvtpd_ps(_mm512_fmadd_pd(r_20, p_x,
+      _mm512_fmadd_pd(r_21, p_y, _mm512_fmadd_pd(r_22, p_z, t_2)))));
+  }
+
+  transform_simd_float_points_double(transform, &x[i], &y[i], &z[i],
+    &x_t[i], &y_t[i], &z_t[i], num_points-i);
+}
+
+__attribute__((target("avx2,fma")))
+static void transform_simd_points_strided_avx2(const double (*transform)[4],
+    char* x, char* y, char* z, size_t stride, size_t num_points) {
+  __m256d r_00 = _mm256_set1_pd(transform[0][0]),
+    r_01 = _mm256_set1_pd(transform[0][1]),
+    r_02 = _mm256_set1_pd(transform[0][2]),
+    t_0 = _mm256_set1_pd(transform[0][3]);
+  __m256d r_10 = _mm256_set1_pd(transform[1][0]),
+    r_11 = _mm256_set1_pd(transform[1][1]),
+    r_12 = _mm256_set1_pd(transform[1][2]),
+    t_1 = _mm256_set1_pd(transform[1][3]);
+  __m256d r_20 = _mm256_set1_pd(transform[2][0]),
+    r_21 = _mm256_set1_pd(transform[2][1]),
+    r_22 = _mm256_set1_pd(transform[2][2]),
+    t_2 = _mm256_set1_pd(transform[2][3]);
+  __m256i index = _mm256_set_epi64x(3*stride, 2*stride, stride, 0);
+  double x_t[4], y_t[4], z_t[4];
+  size_t i, j;
+
+  for (i = 0; i+4 <= num_points; i += 4) {
+    __m256d p_x = _mm256_i64gather_pd((const double*)x, index, 1);
+    __m256d p_y = _mm256_i64gather_pd((const double*)y, index, 1);
+    __m256d p_z = _mm256_i64gather_pd((const double*)z, index, 1);
+
+    _mm256_storeu_pd(x_t, _mm256_fmadd_pd(r_00, p_x,
+      _mm256_fmadd_pd(r_01, p_y, _mm256_fmadd_pd(r_02, p_z, t_0))));
+    _mm256_storeu_pd(y_t, _mm256_fmadd_pd(r_10, p_x,
+      _mm256_fmadd_pd(r_11, p_y, _mm256_fmadd_pd(r_12, p_z, t_1))));
+    _mm256_storeu_pd(z_t, _mm256_fmadd_pd(r_20, p_x,
+      _mm256_fmadd_pd(r_21, p_y, _mm256_fmadd_pd(r_22, p_z, t_2))));
+
+    for (j = 0; j < 4; ++j, x += stride, y += stride, z += stride) {
+      *(double*)x = x_t[j];
+      *(double*)y = y_t[j];
+      *(double*)z = z_t[j];
+    }
+  }
+
+  transform_simd_points_strided(transform, x, y, z, stride, num_points-i);
+}
+
+__attribute__((target("avx512f")))
+static void transform_simd_points_strided_avx512(const double (*transform)[4],
+    char* x, char* y, char* z, size_t stride, size_t num_points) {
+  __m512d r_00 = _mm512_set1_pd(transform[0][0]),
+    r_01 = _mm512_set1_pd(transform[0][1]),
+    r_02 = _mm512_set1_pd(transform[0][2]),
+    t_0 = _mm512_set1_pd(transform[0][3]);
+  __m512d r_10 = _mm512_set1_pd(transform[1][0]),
+    r_11 = _mm512_set1_pd(transform[1][1]),
+    r_12 = _mm512_set1_pd(transform[1][2]),
+    t_1 = _mm512_set1_pd(transform[1][3]);
+  __m512d r_20 = _mm512_set1_pd(transform[2][0]),
+    r_21 = _mm512_set1_pd(transform[2][1]),
+    r_22 = _mm512_set1_pd(transform[2][2]),
+    t_2 = _mm512_set1_pd(transform[2][3]);
+  __m512i index = _mm512_set_epi64(7*stride, 6*stride, 5*stride, 4*stride,
+    3*stride, 2*stride, stride, 0);
+  size_t i;
+
+  for (i = 0; i < num_points; i += 8, x += 8*stride, y += 8*stride,
+      z += 8*stride) {
+    __mmask8 mask = (num_points-i >= 8) ? 0xff :
+      (__mmask8)((1u << (num_points-i))-1);
+    __m512d p_x = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), mask, index,
+      x, 1);
+    __m512d p_y = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), mask, index,
+      y, 1);
+    __m512d p_z = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), mask, index,
+      z, 1);
+
+    _mm512_mask_i64scatter_pd(x, mask, index, _mm512_fmadd_pd(r_00, p_x,
+      _mm512_fmadd_pd(r_01, p_y, _mm512_fmadd_pd(r_02, p_z, t_0))), 1);
+    _mm512_mask_i64scatter_pd(y, mask, index, _mm512_fmadd_pd(r_10, p_x,
+      _mm512_fmadd_pd(r_11, p_y, _mm512_fmadd_pd(r_12, p_z, t_1))), 1);
+    _mm512_mask_i64scatter_pd(z, mask, index, _mm512_fmadd_pd(r_20, p_x,
+      _mm512_fmadd_pd(r_21, p_y, _mm512_fmadd_pd(r_22, p_z, t_2))), 1);
+  }
+}
+
+__attribute__((target("avx2,fma")))
+static void transform_simd_sincos_avx2(const double* x, double* sin_x, double*
+    cos_x, size_t num_values) {
+  const double* s_c = transform_simd_sin_coefficients;
+  const double* c_c = transform_simd_cos_coefficients;
+  __m256d max_argument = _mm256_set1_pd(TRANSFORM_SIMD_SINCOS_MAX_ARGUMENT);
+  __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(~(1ULL << 63)));
+  size_t i;
+
+  for (i = 0; i+4 <= num_values; i += 4) {
+    __m256d x_i = _mm256_loadu_pd(&x[i]);
+    __m256d q, r, z, s, c, swap;
+    __m256i q_i;
+
+    if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_and_pd(x_i, abs_mask),
+        max_argument, _CMP_NLE_UQ))) {
+      transform_simd_sincos(&x[i], &sin_x[i], &cos_x[i], 4);
+      continue;
+    }
+
+    q = _mm256_round_pd(_mm256_mul_pd(x_i, _mm256_set1_pd(M_2_PI)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    r = _mm256_fnmadd_pd(q, _mm256_set1_pd(transform_simd_pio2[0]), x_i);
+    r = _mm256_fnmadd_pd(q, _mm256_set1_pd(transform_simd_pio2[1]), r);
+    r = _mm256_fnmadd_pd(q, _mm256_set1_pd(transform_simd_pio2[2]), r);
+    z = _mm256_mul_pd(r, r);
+
+    s = _mm256_fmadd_pd(_mm256_set1_pd(s_c[0]), z, _mm256_set1_pd(s_c[1]));
+    s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(s_c[2]));
+    s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(s_c[3]));
+    s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(s_c[4]));
+    s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(s_c[5]));
+    s = _mm256_fmadd_pd(_mm256_mul_pd(s, z), r, r);
+
+    c = _mm256_fmadd_pd(_mm256_set1_pd(c_c[0]), z, _mm256_set1_pd(c_c[1]));
+    c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(c_c[2]));
+    c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(c_c[3]));
+    c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(c_c[4]));
+    c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(c_c[5]));
+    c = _mm256_fmadd_pd(_mm256_mul_pd(c, z), z,
+      _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, _mm256_set1_pd(1.0)));
+
+    q_i = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(q));
+    swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(q_i,
+      _mm256_set1_epi64x(1)), _mm256_set1_epi64x(1)));
+
+    _mm256_storeu_pd(&sin_x[i], _mm256_xor_pd(_mm256_blendv_pd(s, c, swap),
+      _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(q_i,
+      _mm256_set1_epi64x(2)), 62))));
+    _mm256_storeu_pd(&cos_x[i], _mm256_xor_pd(_mm256_blendv_pd(c, s, swap),
+      _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(
+      _mm256_add_epi64(q_i, _mm256_set1_epi64x(1)),
+      _mm256_set1_epi64x(2)), 62))));
+  }
+
+  transform_simd_sincos(&x[i], &sin_x[i], &cos_x[i], num_values-i);
+}
+
+__attribute__((target("avx512f")))
+static void transform_simd_sincos_avx512(const double* x, double* sin_x, double*
+    cos_x, size_t num_values) {
+  const double* s_c = transform_simd_sin_coefficients;
+  const double* c_c = transform_simd_cos_coefficients;
+  __m512d max_argument = _mm512_set1_pd(TRANSFORM_SIMD_SINCOS_MAX_ARGUMENT);
+  size_t i;
+
+  for (i = 0; i < num_values; i += 8) {
+    __mmask8 mask = (num_values-i >= 8) ? 0xff :
+      (__mmask8)((1u << (num_values-i))-1);
+    __m512d x_i = _mm512_maskz_loadu_pd(mask, &x[i]);
+    __m512d q, r, z, s, c;
+    __m512i q_i;
+    __mmask8 swap;
+
+    if (_mm512_cmp_pd_mask(_mm512_abs_pd(x_i), max_argument, _CMP_NLE_UQ)) {
+      transform_simd_sincos(&x[i], &sin_x[i], &cos_x[i],
+        (num_values-i >= 8) ? 8 : num_values-i);
+      continue;
+    }
+
+    q = _mm512_roundscale_pd(_mm512_mul_pd(x_i, _mm512_set1_pd(M_2_PI)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    r = _mm512_fnmadd_pd(q, _mm512_set1_pd(transform_simd_pio2[0]), x_i);
+    r = _mm512_fnmadd_pd(q, _mm512_set1_pd(transform_simd_pio2[1]), r);
+    r = _mm512_fnmadd_pd(q, _mm512_set1_pd(transform_simd_pio2[2]), r);
+    z = _mm512_mul_pd(r, r);
+
+    s = _mm512_fmadd_pd(_mm512_set1_pd(s_c[0]), z, _mm512_set1_pd(s_c[1]));
+    s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(s_c[2]));
+    s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(s_c[3]));
+    s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(s_c[4]));
+    s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(s_c[5]));
+    s = _mm512_fmadd_pd(_mm512_mul_pd(s, z), r, r);
+
+    c = _mm512_fmadd_pd(_mm512_set1_pd(c_c[0]), z, _mm512_set1_pd(c_c[1]));
+    c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(c_c[2]));
+    c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(c_c[3]));
+    c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(c_c[4]));
+    c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(c_c[5]));
+    c = _mm512_fmadd_pd(_mm512_mul_pd(c, z), z,
+      _mm512_fnmadd_pd(_mm512_set1_pd(0.5), z, _mm512_set1_pd(1.0)));
+
+    q_i = _mm512_cvtepi32_epi64(_mm512_cvtpd_epi32(q));
+    swap = _mm512_test_epi64_mask(q_i, _mm512_set1_epi64(1));
+
+    _mm512_mask_storeu_pd(&sin_x[i], mask, _mm512_castsi512_pd(
+      _mm512_xor_si512(_mm512_castpd_si512(_mm512_mask_blend_pd(swap, s, c)),
+      _mm512_slli_epi64(_mm512_and_si512(q_i, _mm512_set1_epi64(2)), 62))));
+    _mm512_mask_storeu_pd(&cos_x[i], mask, _mm512_castsi512_pd(
+      _mm512_xor_si512(_mm512_castpd_si512(_mm512_mask_blend_pd(swap, c, s)),
+      _mm512_slli_epi64(_mm512_and_si512(_mm512_add_epi64(q_i,
+      _mm512_set1_epi64(1)), _mm512_set1_epi64(2)), 62))));
+  }
+}
+
+__attribute__((target("avx2,fma")))
+static void transform_simd_linear_avx2(const double* a, const double* c, size_t
+    dim, const double* x, double* y, size_t num_vectors) {
+  double a_t[TRANSFORM_SIMD_LINEAR_MAX_DIMENSION*
+    TRANSFORM_SIMD_LINEAR_MAX_DIMENSION] __attribute__((aligned(32)));
+  double c_t[TRANSFORM_SIMD_LINEAR_MAX_DIMENSION]
+    __attribute__((aligned(32)));
+  size_t num_blocks = (dim+3)/4, num_lanes = 4*num_blocks, i, j, k;
+  __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(dim-4*(num_blocks-1)),
+    _mm256_set_epi64x(3, 2, 1, 0));
+
+  for (i = 0; i < dim; ++i)
+    for (k = 0; k < num_lanes; ++k)
+      a_t[i*num_lanes+k] = (k < dim) ? a[k*dim+i] : 0.0;
+  for (k = 0; k < num_lanes; ++k)
+    c_t[k] = (c && (k < dim)) ? c[k] : 0.0;
+
+  for (j = 0; j < num_vectors; ++j, x += dim, y += dim) {
+    __m256d y_j[TRANSFORM_SIMD_LINEAR_MAX_DIMENSION/4];
+
+    for (k = 0; k < num_blocks; ++k)
+      y_j[k] = _mm256_load_pd(&c_t[4*k]);
+
+    for (i = 0; i < dim; ++i) {
+      __m256d x_i = _mm256_broadcast_sd(&x[i]);
+
+      for (k = 0; k < num_blocks; ++k)
+        y_j[k] = _mm256_fmadd_pd(_mm256_load_pd(&a_t[i*num_lanes+4*k]),
+          x_i, y_j[k]);
+    }
+
+    for (k = 0; k+1 < num_blocks; ++k)
+      _mm256_storeu_pd(&y[4*k], y_j[k]);
+    _mm256_maskstore_pd(&y[4*k], mask, y_j[k]);
+  }
+}
+
+__attribute__((target("avx512f")))
+static void transform_simd_linear_avx512(const double* a, const double* c,
+    size_t dim, const double* x, double* y, size_t num_vectors) {
+  double a_t[TRANSFORM_SIMD_LINEAR_MAX_DIMENSION*
+    TRANSFORM_SIMD_LINEAR_MAX_DIMENSION] __attribute__((aligned(64)));
+  double c_t[TRANSFORM_SIMD_LINEAR_MAX_DIMENSION]
+    __attribute__((aligned(64)));
+  size_t num_blocks = (dim+7)/8, num_lanes = 8*num_blocks, i, j, k;
+  __mmask8 mask = 0xff >> (num_lanes-dim);
+
+  for (i = 0; i < dim; ++i)
+    for (k = 0; k < num_lanes; ++k)
+      a_t[i*num_lanes+k] = (k < dim) ? a[k*dim+i] : 0.0;
+  for (k = 0; k < num_lanes; ++k)
+    c_t[k] = (c && (k < dim)) ? c[k] : 0.0;
+
+  for (j = 0; j < num_vectors; ++j, x += dim, y += dim) {
+    __m512d y_j[TRANSFORM_SIMD_LINEAR_MAX_DIMENSION/8];
+
+    for (k = 0; k < num_blocks; ++k)
+      y_j[k] = _mm512_load_pd(&c_t[8*k]);
+
+    for (i = 0; i < dim; ++i) {
+      __m512d x_i = _mm512_set1_pd(x[i]);
+
+      for (k = 0; k < num_blocks; ++k)
+        y_j[k] = _mm512_fmadd_pd(_mm512_load_pd(&a_t[i*num_lanes+8*k]),
+          x_i, y_j[k]);
+    }
+
+    for (k = 0; k+1 < num_blocks; ++k)
+      _mm512_storeu_pd(&y[8*k], y_j[k]);
+    _mm512_mask_storeu_pd(&y[8*k], mask, y_j[k]);
+  }
+}
+#endif
+
+static transform_simd_type_t transform_simd_get_supported_type(void) {
+#ifdef TRANSFORM_SIMD_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f"))
+    return transform_simd_type_avx512;
+  else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return transform_simd_type_avx2;
+#endif
+
+  return transform_simd_type_none;
+}
+
+static transform_simd_type_t transform_simd_select(transform_simd_type_t
+    type) {
+  transform_simd_type_t supported_type = transform_simd_get_supported_type();
+
+  if (type > supported_type)
+    type = supported_type;
+
+  switch (type) {
+#ifdef TRANSFORM_SIMD_X86
+    case transform_simd_type_avx512:
+      transform_simd_kernel = transform_simd_points_avx512;
+      transform_simd_float_kernels[transform_simd_precision_single] =
+        transform_simd_float_points_avx512;
+      transform_simd_float_kernels[transform_simd_precision_double] =
+        transform_simd_float_points_double_avx512;
+      transform_simd_strided_kernel = transform_simd_points_strided_avx512;
+      transform_simd_sincos_kernel = transform_simd_sincos_avx512;
+      transform_simd_linear_kernel = transform_simd_linear_avx512;
+      break;
+    case transform_simd_type_avx2:
+      transform_simd_kernel = transform_simd_points_avx2;
+      transform_simd_float_kernels[transform_simd_precision_single] =
+        transform_simd_float_points_avx2;
+      transform_simd_float_kernels[transform_simd_precision_double] =
+        transform_simd_float_points_double_avx2;
+      transform_simd_strided_kernel = transform_simd_points_strided_avx2;
+      transform_simd_sincos_kernel = transform_simd_sincos_avx2;
+      transform_simd_linear_kernel = transform_simd_linear_avx2;
+      break;
+#endif
+    default:
+      type = transform_simd_type_none;
+      transform_simd_kernel = transform_simd_points;
+      transform_simd_float_kernels[transform_simd_precision_single] =
+        transform_simd_float_points;
+      transform_simd_float_kernels[transform_simd_precision_double] =
+        transform_simd_float_points_double;
+      transform_simd_strided_kernel = transform_simd_points_strided;
+      transform_simd_sincos_kernel = transform_simd_sincos;
+      transform_simd_linear_kernel = transform_simd_linear;
+  }
+  transform_simd_type = type;
+
+  return type;
+}
+
+static void transform_simd_init(void) {
+  transform_simd_select(transform_simd_type_avx512);
+}
+
+transform_simd_type_t transform_simd_get_type(void) {
+  pthread_once(&transform_simd_once, transform_simd_init);
+
+  return transform_simd_type;
+}
+
+transform_simd_type_t transform_simd_set_type(transform_simd_type_t type) {
+  pthread_once(&transform_simd_once, transform_simd_init);
+
+  return transform_simd_select(type);
+}
+
+transform_simd_kernel_t transform_simd_get_kernel(void) {
+  pthread_once(&transform_simd_once, transform_simd_init);
+
+  return transform_simd_kernel;
+}
+
+transform_simd_float_kernel_t transform_simd_get_float_kernel(
+    transform_simd_precision_t precision) {
+  pthread_once(&transform_simd_once, transform_simd_init);
+
+  return transform_simd_float_kernels[precision];
+}
+
+transform_simd_strided_kernel_t transform_simd_get_strided_kernel(void) {
+  pthread_once(&transform_simd_once, transform_simd_init);
+
+  return transform_simd_strided_kernel;
+}
+
+transform_simd_sincos_t transform_simd_get_sincos(void) {
+  pthread_once(&transform_simd_once, transform_simd_init);
+
+  return transform_simd_sincos_kernel;
+}
+
+transform_simd_linear_kernel_t transform_simd_get_linear_kernel(void) {
+  pthread_once(&transform_simd_once, transform_simd_init);
+
+  return transform_simd_linear_kernel;
+}
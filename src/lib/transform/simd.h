@@ -0,0 +1,315 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_SIMD_H
+#define TRANSFORM_SIMD_H
+
+/** \file transform/simd.h
+  * \ingroup transform
+  * \brief Vectorized transformation kernels
+  * \author Ralf Kaestner
+  *
+  * The point transformation kernels apply the affine part of a transform
+  * to points stored as separate arrays of x, y, and z-components, given
+  * in double or single precision. For single-precision points, the
+  * transform may be applied in either precision. Strided kernels gather
+  * and scatter double-precision components in place from arbitrary
+  * records. The sine and cosine kernels evaluate both functions for arrays
+  * of angles, as required for constructing rotations in batch. The linear
+  * map kernels apply a common matrix to arrays of small vectors, such as
+  * packed covariance matrices. Besides portable
+  * kernels, AVX2 and AVX-512 kernels process 4 and 8 values per
+  * instruction, respectively. The kernels are selected at runtime
+  * according to the instruction sets supported by the CPU. All kernels
+  * agree up to floating-point round-off.
+  */
+
+#include <stdlib.h>
+
+/** \name Constants
+  * \brief Predefined vectorized kernel constants
+  */
+//@{
+#define TRANSFORM_SIMD_SINCOS_MAX_ARGUMENT 1e6
+//!< The maximum magnitude of angles reduced by the vectorized kernels
+#define TRANSFORM_SIMD_LINEAR_MAX_DIMENSION 24
+//!< The maximum dimension of vectors mapped by the linear kernels
+//@}
+
+/** \brief Vector instruction set type
+  */
+typedef enum {
+  transform_simd_type_none,       //!< Portable kernels only.
+  transform_simd_type_avx2,       //!< AVX2 and FMA kernels.
+  transform_simd_type_avx512,     //!< AVX-512 kernels.
+} transform_simd_type_t;
+
+/** \brief Predefined vector instruction set type strings
+  */
+extern const char* transform_simd_types[];
+
+/** \brief Arithmetic precision type
+  */
+typedef enum {
+  transform_simd_precision_single,  //!< Single-precision arithmetic.
+  transform_simd_precision_double,  //!< Double-precision arithmetic.
+} transform_simd_precision_t;
+
+/** \brief Predefined arithmetic precision type strings
+  */
+extern const char* transform_simd_precisions[];
+
+/** \brief Point transformation kernel type
+  * \param[in] transform The transformation matrix, of which the first
+  *   three rows will be applied.
+  * \param[in] x The x-components of the input points.
+  * \param[in] y The y-components of the input points.
+  * \param[in] z The z-components of the input points.
+  * \param[out] x_t The x-components of the transformed points.
+  * \param[out] y_t The y-components of the transformed points.
+  * \param[out] z_t The z-components of the transformed points.
+  * \param[in] num_points The number of points to be transformed.
+  *
+  * The output arrays may be identical to the input arrays, but must not
+  * overlap them otherwise.
+  */
+typedef void (*transform_simd_kernel_t)(
+  const double (*transform)[4],
+  const double* x,
+  const double* y,
+  const double* z,
+  double* x_t,
+  double* y_t,
+  double* z_t,
+  size_t num_points);
+
+/** \brief Single-precision point transformation kernel type
+  * \param[in] transform The transformation matrix, of which the first
+  *   three rows will be applied.
+  * \param[in] x The x-components of the input points.
+  * \param[in] y The y-components of the input points.
+  * \param[in] z The z-components of the input points.
+  * \param[out] x_t The x-components of the transformed points.
+  * \param[out] y_t The y-components of the transformed points.
+  * \param[out] z_t The z-components of the transformed points.
+  * \param[in] num_points The number of points to be transformed.
+  *
+  * Single-precision kernels round the transformation matrix to single
+  * precision and process twice as many points per instruction as their
+  * double-precision counterparts. Double-precision kernels convert the
+  * points to double precision and round the results. The output arrays
+  * may be identical to the input arrays, but must not overlap them
+  * otherwise.
+  */
+typedef void (*transform_simd_float_kernel_t)(
+  const double (*transform)[4],
+  const float* x,
+  const float* y,
+  const float* z,
+  float* x_t,
+  float* y_t,
+  float* z_t,
+  size_t num_points);
+
+/** \brief Strided point transformation kernel type
+  * \param[in] transform The transformation matrix, of which the first
+  *   three rows will be applied.
+  * \param[in,out] x The address of the x-component of the first point.
+  * \param[in,out] y The address of the y-component of the first point.
+  * \param[in,out] z The address of the z-component of the first point.
+  * \param[in] stride The distance between consecutive points in [byte].
+  * \param[in] num_points The number of points to be transformed.
+  *
+  * The components of consecutive points are located at multiples of the
+  * stride from the given addresses and transformed in place. The AVX2
+  * kernel gathers the components of 4 points, whereas the AVX-512 kernel
+  * gathers and scatters the components of 8 points per instruction.
+  */
+typedef void (*transform_simd_strided_kernel_t)(
+  const double (*transform)[4],
+  char* x,
+  char* y,
+  char* z,
+  size_t stride,
+  size_t num_points);
+
+/** \brief Sine and cosine kernel type
+  * \param[in] x The angles for which to evaluate sine and cosine in [rad].
+  * \param[out] sin_x The sines of the angles.
+  * \param[out] cos_x The cosines of the angles.
+  * \param[in] num_values The number of angles.
+  *
+  * The vectorized kernels reduce the angles to [-pi/4, pi/4] and evaluate
+  * minimax polynomials. Angles exceeding TRANSFORM_SIMD_SINCOS_MAX_ARGUMENT
+  * in magnitude are passed to the standard library functions instead.
+  */
+typedef void (*transform_simd_sincos_t)(
+  const double* x,
+  double* sin_x,
+  double* cos_x,
+  size_t num_values);
+
+/** \brief Linear map kernel type
+  * \param[in] a The D x D matrix of the linear map in row-major order.
+  * \param[in] c The optional offset vector of the map, an array of D
+  *   values.
+  * \param[in] dim The positive dimension D of the vectors, which must not
+  *   exceed TRANSFORM_SIMD_LINEAR_MAX_DIMENSION.
+  * \param[in] x The input vectors, an array holding the D components of
+  *   each vector consecutively.
+  * \param[out] y The mapped vectors A*x+c, an array holding the D
+  *   components of each vector consecutively.
+  * \param[in] num_vectors The number of vectors to be mapped.
+  *
+  * The vectorized kernels accumulate the columns of the matrix, scaled by
+  * the broadcast components of an input vector, into the lanes of the
+  * output vector. The output array may be identical to the input array,
+  * but must not overlap it otherwise.
+  */
+typedef void (*transform_simd_linear_kernel_t)(
+  const double* a,
+  const double* c,
+  size_t dim,
+  const double* x,
+  double* y,
+  size_t num_vectors);
+
+/** \brief Retrieve the vector instruction set type in use
+  * \return The vector instruction set type used by the kernels. Unless
+  *   set explicitly, this is the most capable type supported by the CPU.
+  */
+transform_simd_type_t transform_simd_get_type(void);
+
+/** \brief Set the vector instruction set type in use
+  * \param[in] type The requested vector instruction set type.
+  * \return The vector instruction set type which will actually be used.
+  *   This is the requested type or, if the CPU does not support it, the
+  *   most capable type supported.
+  *
+  * The most capable type is selected once on first use of any kernel.
+  * Changing the type thereafter is not synchronized with threads which
+  * retrieve or run kernels at the same time.
+  */
+transform_simd_type_t transform_simd_set_type(
+  transform_simd_type_t type);
+
+/** \brief Retrieve the point transformation kernel in use
+  * \return The point transformation kernel for the vector instruction
+  *   set type in use.
+  */
+transform_simd_kernel_t transform_simd_get_kernel(void);
+
+/** \brief Retrieve the single-precision point transformation kernel in use
+  * \param[in] precision The arithmetic precision of the kernel.
+  * \return The single-precision point transformation kernel for the
+  *   vector instruction set type in use.
+  */
+transform_simd_float_kernel_t transform_simd_get_float_kernel(
+  transform_simd_precision_t precision);
+
+/** \brief Retrieve the strided point transformation kernel in use
+  * \return The strided point transformation kernel for the vector
+  *   instruction set type in use.
+  */
+transform_simd_strided_kernel_t transform_simd_get_strided_kernel(void);
+
+/** \brief Retrieve the sine and cosine kernel in use
+  * \return The sine and cosine kernel for the vector instruction set type
+  *   in use.
+  */
+transform_simd_sincos_t transform_simd_get_sincos(void);
+
+/** \brief Retrieve the linear map kernel in use
+  * \return The linear map kernel for the vector instruction set type in
+  *   use.
+  */
+transform_simd_linear_kernel_t transform_simd_get_linear_kernel(void);
+
+/** \brief Portable point transformation kernel
+  * \see transform_simd_kernel_t
+  */
+void transform_simd_points(
+  const double (*transform)[4],
+  const double* x,
+  const double* y,
+  const double* z,
+  double* x_t,
+  double* y_t,
+  double* z_t,
+  size_t num_points);
+
+/** \brief Portable single-precision point transformation kernel
+  * \see transform_simd_float_kernel_t
+  */
+void transform_simd_float_points(
+  const double (*transform)[4],
+  const float* x,
+  const float* y,
+  const float* z,
+  float* x_t,
+  float* y_t,
+  float* z_t,
+  size_t num_points);
+
+/** \brief Portable mixed-precision point transformation kernel
+  * \see transform_simd_float_kernel_t
+  */
+void transform_simd_float_points_double(
+  const double (*transform)[4],
+  const float* x,
+  const float* y,
+  const float* z,
+  float* x_t,
+  float* y_t,
+  float* z_t,
+  size_t num_points);
+
+/** \brief Portable strided point transformation kernel
+  * \see transform_simd_strided_kernel_t
+  */
+void transform_simd_points_strided(
+  const double (*transform)[4],
+  char* x,
+  char* y,
+  char* z,
+  size_t stride,
+  size_t num_points);
+
+/** \brief Portable sine and cosine kernel
+  * \see transform_simd_sincos_t
+  */
+void transform_simd_sincos(
+  const double* x,
+  double* sin_x,
+  double* cos_x,
+  size_t num_values);
+
+/** \brief Portable linear map kernel
+  * \see transform_simd_linear_kernel_t
+  */
+void transform_simd_linear(
+  const double* a,
+  const double* c,
+  size_t dim,
+  const double* x,
+  double* y,
+  size_t num_vectors);
+
+#endif
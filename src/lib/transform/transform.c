@@ -20,11 +20,21 @@
 
 #include <math.h>
 
-#include <gsl/gsl_blas.h>
-#include <gsl/gsl_linalg.h>
-
 #include "transform.h"
 
+#include "transform/affine.h"
+
+typedef struct transform_points_arg_t {
+  double (*transform)[4];
+
+  const transform_point_t* points;
+  transform_point_t* result;
+
+  const transform_point_buffer_t* buffer;
+  transform_point_buffer_t* result_buffer;
+  transform_simd_kernel_t kernel;
+} transform_points_arg_t;
+
 void transform_init_identity(transform_t transform) {
   int i, j;
 
@@ -58,24 +68,67 @@ void transform_init_scaling(transform_t transform, double s_x, double s_y,
 
 void transform_init_rotation(transform_t transform, double yaw, double pitch,
     double roll) {
-  transform_init_identity(transform);
-
-  transform[0][0] = cos(yaw)*cos(pitch);
-  transform[0][1] = cos(yaw)*sin(pitch)*sin(roll)-sin(yaw)*cos(roll);
-  transform[0][2] = cos(yaw)*sin(pitch)*cos(roll)+sin(yaw)*sin(roll);
-
-  transform[1][0] = sin(yaw)*cos(pitch);
-  transform[1][1] = sin(yaw)*sin(pitch)*sin(roll)+cos(yaw)*cos(roll);
-  transform[1][2] = sin(yaw)*sin(pitch)*cos(roll)-cos(yaw)*sin(roll);
+  transform_affine_init_rotation(transform, yaw, pitch, roll);
 
-  transform[2][0] = -sin(pitch);
-  transform[2][1] = cos(pitch)*sin(roll);
-  transform[2][2] = cos(pitch)*cos(roll);
+  transform[3][0] = 0.0;
+  transform[3][1] = 0.0;
+  transform[3][2] = 0.0;
+  transform[3][3] = 1.0;
 }
 
 void transform_init_pose(transform_t transform, const transform_pose_t* pose) {
   transform_init_rotation(transform, pose->yaw, pose->pitch, pose->roll);
-  transform_translate(transform, pose->x, pose->y, pose->z);
+
+  transform[0][3] = pose->x;
+  transform[1][3] = pose->y;
+  transform[2][3] = pose->z;
+}
+
+void transform_init_poses(transform_t* transforms, const transform_pose_t*
+    poses, size_t num_poses) {
+  double angles[3*TRANSFORM_POSES_BLOCK_SIZE];
+  double sin_a[3*TRANSFORM_POSES_BLOCK_SIZE];
+  double cos_a[3*TRANSFORM_POSES_BLOCK_SIZE];
+  transform_simd_sincos_t sincos_kernel = transform_simd_get_sincos();
+  size_t i, j;
+
+  for (i = 0; i < num_poses; i += TRANSFORM_POSES_BLOCK_SIZE) {
+    size_t n = (num_poses-i > TRANSFORM_POSES_BLOCK_SIZE) ?
+      TRANSFORM_POSES_BLOCK_SIZE : num_poses-i;
+    const double* s_y = sin_a, * s_p = &sin_a[n], * s_r = &sin_a[2*n];
+    const double* c_y = cos_a, * c_p = &cos_a[n], * c_r = &cos_a[2*n];
+
+    for (j = 0; j < n; ++j) {
+      angles[j] = poses[i+j].yaw;
+      angles[n+j] = poses[i+j].pitch;
+      angles[2*n+j] = poses[i+j].roll;
+    }
+    sincos_kernel(angles, sin_a, cos_a, 3*n);
+
+    for (j = 0; j < n; ++j) {
+      double (*t)[4] = transforms[i+j];
+
+      t[0][0] = c_y[j]*c_p[j];
+      t[0][1] = c_y[j]*s_p[j]*s_r[j]-s_y[j]*c_r[j];
+      t[0][2] = c_y[j]*s_p[j]*c_r[j]+s_y[j]*s_r[j];
+      t[0][3] = poses[i+j].x;
+
+      t[1][0] = s_y[j]*c_p[j];
+      t[1][1] = s_y[j]*s_p[j]*s_r[j]+c_y[j]*c_r[j];
+      t[1][2] = s_y[j]*s_p[j]*c_r[j]-c_y[j]*s_r[j];
+      t[1][3] = poses[i+j].y;
+
+      t[2][0] = -s_p[j];
+      t[2][1] = c_p[j]*s_r[j];
+      t[2][2] = c_p[j]*c_r[j];
+      t[2][3] = poses[i+j].z;
+
+      t[3][0] = 0.0;
+      t[3][1] = 0.0;
+      t[3][2] = 0.0;
+      t[3][3] = 1.0;
+    }
+  }
 }
 
 void transform_copy(transform_t dst, transform_t src) {
@@ -114,74 +167,217 @@ void transform_multiply_left(transform_t right, transform_t left) {
   transform_copy(right, result);
 }
 
-void transform_invert(transform_t transform) {
-  gsl_matrix* A = gsl_matrix_calloc(4, 4);
-  gsl_matrix* A_inv = gsl_matrix_calloc(4, 4);
-  gsl_permutation* perm = gsl_permutation_alloc(4);
-  int i, j, signum;
+int transform_is_affine(transform_t transform) {
+  return (transform[3][0] == 0.0) && (transform[3][1] == 0.0) &&
+    (transform[3][2] == 0.0) && (transform[3][3] == 1.0);
+}
 
-  for (i = 0; i < 4; ++i)
-    for (j = 0; j < 4; ++j)
-      gsl_matrix_set(A, i, j, transform[i][j]);
-    
-  gsl_linalg_LU_decomp(A, perm, &signum);
-  gsl_linalg_LU_invert(A, perm, A_inv);
-  
-  for (i = 0; i < 4; ++i)
-    for (j = 0; j < 4; ++j)
-      transform[i][j] = gsl_matrix_get(A_inv, i, j);
-    
-  gsl_matrix_free(A);
-  gsl_matrix_free(A_inv);
-  gsl_permutation_free(perm);
+int transform_is_rigid(transform_t transform) {
+  return transform_is_affine(transform) &&
+    transform_affine_is_rigid(transform);
+}
+
+static void transform_invert_general(transform_t transform) {
+  transform_t a;
+  double p;
+  int i, j, k, pivot;
+
+  transform_copy(a, transform);
+  transform_init_identity(transform);
+
+  for (k = 0; k < 4; ++k) {
+    pivot = k;
+    for (i = k+1; i < 4; ++i)
+      if (fabs(a[i][k]) > fabs(a[pivot][k]))
+        pivot = i;
+
+    if (pivot != k) {
+      for (j = 0; j < 4; ++j) {
+        p = a[k][j];
+        a[k][j] = a[pivot][j];
+        a[pivot][j] = p;
+
+        p = transform[k][j];
+        transform[k][j] = transform[pivot][j];
+        transform[pivot][j] = p;
+      }
+    }
+
+    p = 1.0/a[k][k];
+    for (j = 0; j < 4; ++j) {
+      a[k][j] *= p;
+      transform[k][j] *= p;
+    }
+
+    for (i = 0; i < 4; ++i) {
+      if ((i != k) && (a[i][k] != 0.0)) {
+        p = a[i][k];
+        for (j = 0; j < 4; ++j) {
+          a[i][j] -= p*a[k][j];
+          transform[i][j] -= p*transform[k][j];
+        }
+      }
+    }
+  }
+}
+
+void transform_invert(transform_t transform) {
+  if (transform_is_affine(transform))
+    transform_affine_invert(transform);
+  else
+    transform_invert_general(transform);
 }
 
 void transform_translate(transform_t transform, double t_x, double t_y,
     double t_z) {
-  transform_t translation;
+  int j;
 
-  transform_init_translation(translation, t_x, t_y, t_z);
-  transform_multiply_left(transform, translation);
+  for (j = 0; j < 4; ++j) {
+    transform[0][j] += t_x*transform[3][j];
+    transform[1][j] += t_y*transform[3][j];
+    transform[2][j] += t_z*transform[3][j];
+  }
 }
 
 void transform_scale(transform_t transform, double s_x, double s_y,
     double s_z) {
-  transform_t scaling;
-
-  transform_init_scaling(scaling, s_x, s_y, s_z);
-  transform_multiply_left(transform, scaling);
+  transform_affine_scale(transform, s_x, s_y, s_z);
 }
 
 void transform_rotate(transform_t transform, double yaw, double pitch,
     double roll) {
-  transform_t rotation;
-
-  transform_init_rotation(rotation, yaw, pitch, roll);
-  transform_multiply_left(transform, rotation);
+  transform_affine_rotate(transform, yaw, pitch, roll);
 }
 
 void transform_point(transform_t transform, transform_point_t* point) {
-  int i, j;
+  transform_affine_point(transform, point);
+}
 
-  double point_a[3] = {point->x, point->y, point->z};
-  double result[3];
+void transform_points(transform_t transform, transform_point_t* points,
+    size_t num_points) {
+  transform_affine_points(transform, points, num_points);
+}
 
-  for (i = 0; i < 3; ++i) {
-    result[i] = 0.0;
-    for (j = 0; j < 3; ++j)
-      result[i] += transform[i][j]*point_a[j];
-    result[i] += transform[i][3];
-  }
+void transform_points_copy(transform_t transform, const transform_point_t*
+    points, transform_point_t* result, size_t num_points) {
+  transform_affine_points_copy(transform, points, result, num_points);
+}
+
+static void transform_points_copy_range(void* arg, size_t index_min,
+    size_t index_max) {
+  transform_points_arg_t* a = arg;
 
-  point->x = result[0];
-  point->y = result[1];
-  point->z = result[2];
+  transform_affine_points_copy(a->transform, &a->points[index_min],
+    &a->result[index_min], index_max-index_min);
 }
 
-void transform_points(transform_t transform, transform_point_t* points,
-    size_t num_points) {
-  int i;
+void transform_points_copy_parallel(thread_pool_t* pool, transform_t
+    transform, const transform_point_t* points, transform_point_t* result,
+    size_t num_points, size_t grain_size) {
+  transform_points_arg_t arg;
+
+  arg.transform = transform;
+  arg.points = points;
+  arg.result = result;
+
+  thread_pool_for(pool, transform_points_copy_range, &arg, num_points,
+    grain_size ? grain_size : TRANSFORM_PARALLEL_GRAIN_SIZE);
+}
+
+void transform_points_strided(transform_t transform, void* records, size_t
+    x_offset, size_t y_offset, size_t z_offset, size_t stride, size_t
+    num_points) {
+  char* base = records;
+
+  transform_simd_get_strided_kernel()((const double (*)[4])transform,
+    base+x_offset, base+y_offset, base+z_offset, stride, num_points);
+}
+
+void transform_point_buffer(transform_t transform, transform_point_buffer_t*
+    buffer) {
+  transform_simd_get_kernel()((const double (*)[4])transform, buffer->x,
+    buffer->y, buffer->z, buffer->x, buffer->y, buffer->z,
+    buffer->num_points);
+}
+
+void transform_point_buffer_copy(transform_t transform, const
+    transform_point_buffer_t* buffer, transform_point_buffer_t* result) {
+  transform_point_buffer_resize(result, buffer->num_points);
+
+  transform_simd_get_kernel()((const double (*)[4])transform, buffer->x,
+    buffer->y, buffer->z, result->x, result->y, result->z,
+    buffer->num_points);
+}
+
+static void transform_point_buffer_copy_range(void* arg, size_t
+    index_min, size_t index_max) {
+  transform_points_arg_t* a = arg;
+
+  a->kernel((const double (*)[4])a->transform, &a->buffer->x[index_min],
+    &a->buffer->y[index_min], &a->buffer->z[index_min],
+    &a->result_buffer->x[index_min], &a->result_buffer->y[index_min],
+    &a->result_buffer->z[index_min], index_max-index_min);
+}
+
+void transform_point_buffer_copy_parallel(thread_pool_t* pool, transform_t
+    transform, const transform_point_buffer_t* buffer,
+    transform_point_buffer_t* result, size_t grain_size) {
+  transform_points_arg_t arg;
+
+  transform_point_buffer_resize(result, buffer->num_points);
+
+  arg.transform = transform;
+  arg.buffer = buffer;
+  arg.result_buffer = result;
+  arg.kernel = transform_simd_get_kernel();
+
+  thread_pool_for(pool, transform_point_buffer_copy_range, &arg,
+    buffer->num_points, grain_size ? grain_size :
+    TRANSFORM_PARALLEL_GRAIN_SIZE);
+}
+
+void transform_points_float(transform_t transform, transform_point_float_t*
+    points, size_t num_points, transform_simd_precision_t precision) {
+  size_t i;
+
+  if (precision == transform_simd_precision_single) {
+    float r_00 = transform[0][0], r_01 = transform[0][1],
+      r_02 = transform[0][2], t_0 = transform[0][3];
+    float r_10 = transform[1][0], r_11 = transform[1][1],
+      r_12 = transform[1][2], t_1 = transform[1][3];
+    float r_20 = transform[2][0], r_21 = transform[2][1],
+      r_22 = transform[2][2], t_2 = transform[2][3];
+
+    for (i = 0; i < num_points; ++i) {
+      float x = points[i].x, y = points[i].y, z = points[i].z;
+
+      points[i].x = r_00*x+r_01*y+r_02*z+t_0;
+      points[i].y = r_10*x+r_11*y+r_12*z+t_1;
+      points[i].z = r_20*x+r_21*y+r_22*z+t_2;
+    }
+  }
+  else {
+    double r_00 = transform[0][0], r_01 = transform[0][1],
+      r_02 = transform[0][2], t_0 = transform[0][3];
+    double r_10 = transform[1][0], r_11 = transform[1][1],
+      r_12 = transform[1][2], t_1 = transform[1][3];
+    double r_20 = transform[2][0], r_21 = transform[2][1],
+      r_22 = transform[2][2], t_2 = transform[2][3];
+
+    for (i = 0; i < num_points; ++i) {
+      double x = points[i].x, y = points[i].y, z = points[i].z;
+
+      points[i].x = r_00*x+r_01*y+r_02*z+t_0;
+      points[i].y = r_10*x+r_11*y+r_12*z+t_1;
+      points[i].z = r_20*x+r_21*y+r_22*z+t_2;
+    }
+  }
+}
 
-  for (i = 0; i < num_points; ++i)
-    transform_point(transform, &points[i]);
+void transform_point_float_buffer(transform_t transform,
+    transform_point_float_buffer_t* buffer, transform_simd_precision_t
+    precision) {
+  transform_simd_get_float_kernel(precision)((const double (*)[4])transform,
+    buffer->x, buffer->y, buffer->z, buffer->x, buffer->y, buffer->z,
+    buffer->num_points);
 }
@@ -44,6 +44,22 @@
 
 #include "transform/point.h"
 #include "transform/pose.h"
+#include "transform/buffer.h"
+#include "transform/simd.h"
+
+#include "thread/pool.h"
+
+/** \name Constants
+  * \brief Predefined transformation constants
+  */
+//@{
+#define TRANSFORM_RIGID_TOLERANCE          1e-12
+//!< The tolerated deviation of a rotation matrix from orthonormality
+#define TRANSFORM_POSES_BLOCK_SIZE         256
+//!< The number of poses converted per block by transform_init_poses()
+#define TRANSFORM_PARALLEL_GRAIN_SIZE      65536
+//!< The default number of points transformed per parallel work item
+//@}
 
 /** \brief Structure defining a transformation
   * 
@@ -101,6 +117,22 @@ void transform_init_pose(
   transform_t transform,
   const transform_pose_t* pose);
 
+/** \brief Initialize array of pose transforms
+  * \param[out] transforms The array of transforms to be initialized from
+  *   the poses.
+  * \param[in] poses The array of poses to initialize the transforms from.
+  * \param[in] num_poses The number of poses in the array.
+  *
+  * The sines and cosines of the angles are evaluated once per angle by
+  * the vectorized kernel selected for the CPU, see transform/simd.h, and
+  * the translations are written directly. The poses are processed in
+  * blocks of TRANSFORM_POSES_BLOCK_SIZE.
+  */
+void transform_init_poses(
+  transform_t* transforms,
+  const transform_pose_t* poses,
+  size_t num_poses);
+
 /** \brief Copy transform
   * \param[in] dst The destination transform to copy to.
   * \param[in] src The source transform to copy from.
@@ -128,8 +160,30 @@ void transform_multiply_left(
   transform_t right,
   transform_t left);
 
+/** \brief Check if a transform is affine
+  * \param[in] transform The transform to be checked.
+  * \return One if the last row of the transform equals (0, 0, 0, 1),
+  *   zero otherwise.
+  */
+int transform_is_affine(
+  transform_t transform);
+
+/** \brief Check if a transform is rigid
+  * \param[in] transform The transform to be checked.
+  * \return One if the transform is affine and its upper-left 3x3 block
+  *   is orthonormal up to TRANSFORM_RIGID_TOLERANCE, zero otherwise.
+  */
+int transform_is_rigid(
+  transform_t transform);
+
 /** \brief Invert transform
   * \param[in,out] transform The transform that will be inverted.
+  *
+  * The inverse of a rigid transform [R t] is computed in closed form as
+  * [R^T -R^T*t]. The linear part of any other affine transform is inverted
+  * through its adjugate, and non-affine transforms fall back to a
+  * Gauss-Jordan elimination with partial pivoting. The result is undefined
+  * for singular transforms.
   */
 void transform_invert(
   transform_t transform);
@@ -173,6 +227,10 @@ void transform_rotate(
 /** \brief Transform point
   * \param[in] transform The transform to apply to the point.
   * \param[in,out] point The point to be transformed.
+  *
+  * Points are transformed by the first three rows of the transform only,
+  * i.e., the transform is assumed to be affine. The same applies to the
+  * transformation of point arrays and buffers.
   */
 void transform_point(
   transform_t transform,
@@ -188,4 +246,144 @@ void transform_points(
   transform_point_t* points,
   size_t num_points);
 
+/** \brief Transform array of points out of place
+  * \param[in] transform The transform to apply to the points.
+  * \param[in] points The array of points to be transformed.
+  * \param[out] result The array of transformed points. The array may be
+  *   identical to the input array, but must not overlap it otherwise.
+  * \param[in] num_points The number of points in the arrays.
+  */
+void transform_points_copy(
+  transform_t transform,
+  const transform_point_t* points,
+  transform_point_t* result,
+  size_t num_points);
+
+/** \brief Transform array of points out of place in parallel
+  * \param[in] pool The thread pool used for transforming the points.
+  * \param[in] transform The transform to apply to the points.
+  * \param[in] points The array of points to be transformed.
+  * \param[out] result The array of transformed points. The array may be
+  *   identical to the input array, but must not overlap it otherwise.
+  * \param[in] num_points The number of points in the arrays.
+  * \param[in] grain_size The number of points transformed per work item
+  *   of the thread pool. If zero, TRANSFORM_PARALLEL_GRAIN_SIZE points
+  *   will be transformed per work item.
+  *
+  * Work items are claimed by the threads of the pool as they complete
+  * their previous items, such that the load is balanced for grain sizes
+  * well below the number of points per thread. Arrays of at most one
+  * grain are transformed by the calling thread. The pool must not be used
+  * by other callers while the points are transformed.
+  */
+void transform_points_copy_parallel(
+  thread_pool_t* pool,
+  transform_t transform,
+  const transform_point_t* points,
+  transform_point_t* result,
+  size_t num_points,
+  size_t grain_size);
+
+/** \brief Transform array of strided point records
+  * \param[in] transform The transform to apply to the points.
+  * \param[in,out] records The base address of the array of records, each
+  *   of which holds the double-precision components of a point.
+  * \param[in] x_offset The offset of the x-component within a record in
+  *   [byte].
+  * \param[in] y_offset The offset of the y-component within a record in
+  *   [byte].
+  * \param[in] z_offset The offset of the z-component within a record in
+  *   [byte].
+  * \param[in] stride The size of a record in [byte].
+  * \param[in] num_points The number of records in the array.
+  *
+  * The components are transformed in place within the records, leaving
+  * any other record fields untouched. The components are gathered and
+  * scattered by the vectorized kernel selected for the CPU, see
+  * transform/simd.h.
+  */
+void transform_points_strided(
+  transform_t transform,
+  void* records,
+  size_t x_offset,
+  size_t y_offset,
+  size_t z_offset,
+  size_t stride,
+  size_t num_points);
+
+/** \brief Transform point buffer
+  * \param[in] transform The transform to apply to the points.
+  * \param[in,out] buffer The point buffer to be transformed.
+  *
+  * The points of the buffer are transformed by the vectorized kernel
+  * selected for the CPU, see transform/simd.h. Being laid out in separate
+  * component arrays, large numbers of points should preferably be
+  * transformed in a point buffer.
+  */
+void transform_point_buffer(
+  transform_t transform,
+  transform_point_buffer_t* buffer);
+
+/** \brief Transform point buffer out of place
+  * \param[in] transform The transform to apply to the points.
+  * \param[in] buffer The point buffer to be transformed.
+  * \param[out] result The point buffer which will be resized to hold the
+  *   transformed points.
+  */
+void transform_point_buffer_copy(
+  transform_t transform,
+  const transform_point_buffer_t* buffer,
+  transform_point_buffer_t* result);
+
+/** \brief Transform point buffer out of place in parallel
+  * \param[in] pool The thread pool used for transforming the points.
+  * \param[in] transform The transform to apply to the points.
+  * \param[in] buffer The point buffer to be transformed.
+  * \param[out] result The point buffer which will be resized to hold the
+  *   transformed points.
+  * \param[in] grain_size The number of points transformed per work item
+  *   of the thread pool. If zero, TRANSFORM_PARALLEL_GRAIN_SIZE points
+  *   will be transformed per work item.
+  *
+  * Each work item is transformed by the vectorized kernel selected for
+  * the CPU. As for transform_points_copy_parallel(), concurrent callers
+  * must not share the pool.
+  */
+void transform_point_buffer_copy_parallel(
+  thread_pool_t* pool,
+  transform_t transform,
+  const transform_point_buffer_t* buffer,
+  transform_point_buffer_t* result,
+  size_t grain_size);
+
+/** \brief Transform array of single-precision points
+  * \param[in] transform The transform to apply to the points.
+  * \param[in,out] points The array of single-precision points to be
+  *   transformed.
+  * \param[in] num_points The number of points in the array.
+  * \param[in] precision The arithmetic precision in which the transform
+  *   will be applied.
+  */
+void transform_points_float(
+  transform_t transform,
+  transform_point_float_t* points,
+  size_t num_points,
+  transform_simd_precision_t precision);
+
+/** \brief Transform single-precision point buffer
+  * \param[in] transform The transform to apply to the points.
+  * \param[in,out] buffer The single-precision point buffer to be
+  *   transformed.
+  * \param[in] precision The arithmetic precision in which the transform
+  *   will be applied.
+  *
+  * The points of the buffer are transformed by the vectorized kernel
+  * selected for the CPU and the requested precision. In single precision,
+  * the kernels process twice as many points per instruction.
+  */
+void transform_point_float_buffer(
+  transform_t transform,
+  transform_point_float_buffer_t* buffer,
+  transform_simd_precision_t precision);
+
 #endif
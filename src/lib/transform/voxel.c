@@ -0,0 +1,508 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <math.h>
+
+#include "voxel.h"
+
+#define TRANSFORM_VOXEL_KEY_NONE           UINT64_MAX
+#define TRANSFORM_VOXEL_KEY_BITS           21
+
+typedef struct transform_voxel_block_t {
+  size_t index_min;
+  size_t index_max;
+
+  transform_point_t min;
+  transform_point_t max;
+  size_t num_finite;
+
+  uint64_t key_or;
+  uint64_t key_and;
+  int error;
+
+  size_t histogram[256];
+  size_t offset;
+} transform_voxel_block_t;
+
+typedef struct transform_voxel_arg_t {
+  transform_voxel_grid_t* grid;
+  const double (*transform)[4];
+
+  const transform_point_t* points;
+  transform_point_t* result;
+
+  double scale;
+  double origin[3];
+  int shift;
+
+  transform_voxel_block_t* blocks;
+  size_t num_blocks;
+} transform_voxel_arg_t;
+
+const char* transform_voxel_errors[] = {
+  "Success",
+  "Invalid voxel size",
+  "Voxel grid range exceeded",
+};
+
+void transform_voxel_grid_init(transform_voxel_grid_t* grid, double
+    voxel_size, transform_voxel_mode_t mode) {
+  grid->voxel_size = voxel_size;
+  grid->mode = mode;
+
+  grid->keys = 0;
+  grid->indices = 0;
+  grid->sorted_keys = 0;
+  grid->sorted_indices = 0;
+  grid->capacity = 0;
+
+  transform_point_init(&grid->min, INFINITY, INFINITY, INFINITY);
+  transform_point_init(&grid->max, -INFINITY, -INFINITY, -INFINITY);
+
+  error_init(&grid->error, transform_voxel_errors);
+}
+
+void transform_voxel_grid_destroy(transform_voxel_grid_t* grid) {
+  if (grid->capacity) {
+    free(grid->keys);
+    free(grid->indices);
+    free(grid->sorted_keys);
+    free(grid->sorted_indices);
+
+    grid->keys = 0;
+    grid->indices = 0;
+    grid->sorted_keys = 0;
+    grid->sorted_indices = 0;
+    grid->capacity = 0;
+  }
+
+  error_destroy(&grid->error);
+}
+
+static void transform_voxel_get_point(const double (*transform)[4], const
+    transform_point_t* point, transform_point_t* result) {
+  if (transform) {
+    result->x = transform[0][0]*point->x+transform[0][1]*point->y+
+      transform[0][2]*point->z+transform[0][3];
+    result->y = transform[1][0]*point->x+transform[1][1]*point->y+
+      transform[1][2]*point->z+transform[1][3];
+    result->z = transform[2][0]*point->x+transform[2][1]*point->y+
+      transform[2][2]*point->z+transform[2][3];
+  }
+  else
+    *result = *point;
+}
+
+static void transform_voxel_for(thread_pool_t* pool, thread_pool_routine_t
+    routine, void* arg, size_t num_blocks) {
+  if (pool && (num_blocks > 1))
+    thread_pool_for(pool, routine, arg, num_blocks, 1);
+  else
+    routine(arg, 0, num_blocks);
+}
+
+static transform_voxel_block_t* transform_voxel_get_blocks(thread_pool_t* pool,
+    size_t num_points, size_t* num_blocks) {
+  transform_voxel_block_t* blocks;
+  size_t k;
+
+  *num_blocks = 1;
+  if (pool) {
+    *num_blocks = num_points/TRANSFORM_VOXEL_PARALLEL_MIN_POINTS;
+    if (*num_blocks > thread_pool_get_num_threads(pool))
+      *num_blocks = thread_pool_get_num_threads(pool);
+    if (!*num_blocks)
+      *num_blocks = 1;
+  }
+
+  blocks = malloc(*num_blocks*sizeof(transform_voxel_block_t));
+  for (k = 0; k < *num_blocks; ++k) {
+    blocks[k].index_min = k*num_points/(*num_blocks);
+    blocks[k].index_max = (k+1)*num_points/(*num_blocks);
+  }
+
+  return blocks;
+}
+
+static void transform_voxel_get_bounds_range(void* arg, size_t index_min, size_t
+    index_max) {
+  transform_voxel_arg_t* a = arg;
+  size_t i, k;
+
+  for (k = index_min; k < index_max; ++k) {
+    transform_voxel_block_t* block = &a->blocks[k];
+
+    block->num_finite = 0;
+    transform_point_init(&block->min, INFINITY, INFINITY, INFINITY);
+    transform_point_init(&block->max, -INFINITY, -INFINITY, -INFINITY);
+
+    for (i = block->index_min; i < block->index_max; ++i) {
+      const transform_point_t* p = &a->points[i];
+
+      if (isfinite(p->x) && isfinite(p->y) && isfinite(p->z)) {
+        block->min.x = fmin(block->min.x, p->x);
+        block->min.y = fmin(block->min.y, p->y);
+        block->min.z = fmin(block->min.z, p->z);
+        block->max.x = fmax(block->max.x, p->x);
+        block->max.y = fmax(block->max.y, p->y);
+        block->max.z = fmax(block->max.z, p->z);
+
+        ++block->num_finite;
+      }
+    }
+  }
+}
+
+static size_t transform_voxel_merge_bounds(const transform_voxel_block_t*
+    blocks, size_t num_blocks, transform_point_t* min, transform_point_t* max) {
+  size_t num_finite = 0, k;
+
+  transform_point_init(min, INFINITY, INFINITY, INFINITY);
+  transform_point_init(max, -INFINITY, -INFINITY, -INFINITY);
+
+  for (k = 0; k < num_blocks; ++k) {
+    min->x = fmin(min->x, blocks[k].min.x);
+    min->y = fmin(min->y, blocks[k].min.y);
+    min->z = fmin(min->z, blocks[k].min.z);
+    max->x = fmax(max->x, blocks[k].max.x);
+    max->y = fmax(max->y, blocks[k].max.y);
+    max->z = fmax(max->z, blocks[k].max.z);
+
+    num_finite += blocks[k].num_finite;
+  }
+
+  return num_finite;
+}
+
+static size_t transform_voxel_get_bounds_pool(thread_pool_t* pool, const
+    transform_point_t* points, size_t num_points, transform_point_t* min,
+    transform_point_t* max) {
+  transform_voxel_arg_t arg;
+  size_t num_finite;
+
+  arg.points = points;
+  arg.blocks = transform_voxel_get_blocks(pool, num_points, &arg.num_blocks);
+
+  transform_voxel_for(pool, transform_voxel_get_bounds_range, &arg,
+    arg.num_blocks);
+  num_finite = transform_voxel_merge_bounds(arg.blocks, arg.num_blocks, min,
+    max);
+
+  free(arg.blocks);
+
+  return num_finite;
+}
+
+size_t transform_voxel_get_bounds(const transform_point_t* points, size_t
+    num_points, transform_point_t* min, transform_point_t* max) {
+  return transform_voxel_get_bounds_pool(0, points, num_points, min, max);
+}
+
+size_t transform_voxel_get_bounds_parallel(thread_pool_t* pool, const
+    transform_point_t* points, size_t num_points, transform_point_t* min,
+    transform_point_t* max) {
+  return transform_voxel_get_bounds_pool(pool, points, num_points, min,
+    max);
+}
+
+static void transform_voxel_get_keys_range(void* arg, size_t index_min, size_t
+    index_max) {
+  transform_voxel_arg_t* a = arg;
+  transform_voxel_grid_t* grid = a->grid;
+  double offset = 1 << (TRANSFORM_VOXEL_KEY_BITS-1);
+  size_t i, k;
+
+  for (k = index_min; k < index_max; ++k) {
+    transform_voxel_block_t* block = &a->blocks[k];
+
+    block->num_finite = 0;
+    transform_point_init(&block->min, INFINITY, INFINITY, INFINITY);
+    transform_point_init(&block->max, -INFINITY, -INFINITY, -INFINITY);
+    block->key_or = 0;
+    block->key_and = TRANSFORM_VOXEL_KEY_NONE;
+    block->error = TRANSFORM_VOXEL_ERROR_NONE;
+
+    for (i = block->index_min; i < block->index_max; ++i) {
+      uint64_t key = TRANSFORM_VOXEL_KEY_NONE;
+      transform_point_t p;
+
+      transform_voxel_get_point(a->transform, &a->points[i], &p);
+
+      if (isfinite(p.x) && isfinite(p.y) && isfinite(p.z)) {
+        double v_x = floor(p.x*a->scale)-a->origin[0];
+        double v_y = floor(p.y*a->scale)-a->origin[1];
+        double v_z = floor(p.z*a->scale)-a->origin[2];
+
+        if ((fabs(v_x) > TRANSFORM_VOXEL_MAX_INDEX) ||
+            (fabs(v_y) > TRANSFORM_VOXEL_MAX_INDEX) ||
+            (fabs(v_z) > TRANSFORM_VOXEL_MAX_INDEX))
+          block->error = TRANSFORM_VOXEL_ERROR_RANGE;
+        else
+          key = ((uint64_t)(v_x+offset) << (2*TRANSFORM_VOXEL_KEY_BITS)) |
+            ((uint64_t)(v_y+offset) << TRANSFORM_VOXEL_KEY_BITS) |
+            (uint64_t)(v_z+offset);
+
+        block->min.x = fmin(block->min.x, p.x);
+        block->min.y = fmin(block->min.y, p.y);
+        block->min.z = fmin(block->min.z, p.z);
+        block->max.x = fmax(block->max.x, p.x);
+        block->max.y = fmax(block->max.y, p.y);
+        block->max.z = fmax(block->max.z, p.z);
+
+        ++block->num_finite;
+      }
+
+      grid->keys[i] = key;
+      grid->indices[i] = i;
+
+      block->key_or |= key;
+      block->key_and &= key;
+    }
+  }
+}
+
+static void transform_voxel_count_digits_range(void* arg, size_t index_min,
+    size_t index_max) {
+  transform_voxel_arg_t* a = arg;
+  const uint64_t* keys = a->grid->keys;
+  size_t i, k;
+
+  for (k = index_min; k < index_max; ++k) {
+    transform_voxel_block_t* block = &a->blocks[k];
+
+    for (i = 0; i < 256; ++i)
+      block->histogram[i] = 0;
+    for (i = block->index_min; i < block->index_max; ++i)
+      ++block->histogram[(keys[i] >> a->shift) & 0xff];
+  }
+}
+
+static void transform_voxel_scatter_digits_range(void* arg, size_t index_min,
+    size_t index_max) {
+  transform_voxel_arg_t* a = arg;
+  transform_voxel_grid_t* grid = a->grid;
+  size_t i, k;
+
+  for (k = index_min; k < index_max; ++k) {
+    transform_voxel_block_t* block = &a->blocks[k];
+
+    for (i = block->index_min; i < block->index_max; ++i) {
+      size_t j = block->histogram[(grid->keys[i] >> a->shift) & 0xff]++;
+
+      grid->sorted_keys[j] = grid->keys[i];
+      grid->sorted_indices[j] = grid->indices[i];
+    }
+  }
+}
+
+static void transform_voxel_sort(thread_pool_t* pool, transform_voxel_arg_t*
+    arg, uint64_t digits) {
+  transform_voxel_grid_t* grid = arg->grid;
+  size_t i, k;
+
+  for (arg->shift = 0; arg->shift < 64; arg->shift += 8) {
+    size_t offset = 0;
+    uint64_t* keys;
+    size_t* indices;
+
+    if (!((digits >> arg->shift) & 0xff))
+      continue;
+
+    transform_voxel_for(pool, transform_voxel_count_digits_range, arg,
+      arg->num_blocks);
+
+    for (i = 0; i < 256; ++i) {
+      for (k = 0; k < arg->num_blocks; ++k) {
+        size_t count = arg->blocks[k].histogram[i];
+
+        arg->blocks[k].histogram[i] = offset;
+        offset += count;
+      }
+    }
+
+    transform_voxel_for(pool, transform_voxel_scatter_digits_range, arg,
+      arg->num_blocks);
+
+    keys = grid->keys;
+    indices = grid->indices;
+    grid->keys = grid->sorted_keys;
+    grid->indices = grid->sorted_indices;
+    grid->sorted_keys = keys;
+    grid->sorted_indices = indices;
+  }
+}
+
+static void transform_voxel_reduce_range(void* arg, size_t index_min, size_t
+    index_max) {
+  transform_voxel_arg_t* a = arg;
+  const transform_voxel_grid_t* grid = a->grid;
+  const uint64_t* keys = grid->keys;
+  const size_t* indices = grid->indices;
+  size_t i, j, k;
+
+  for (k = index_min; k < index_max; ++k) {
+    transform_voxel_block_t* block = &a->blocks[k];
+
+    block->num_finite = 0;
+
+    for (i = block->index_min; i < block->index_max; i = j) {
+      const transform_point_t* p_0 = &a->points[indices[i]];
+      double s_x = 0.0, s_y = 0.0, s_z = 0.0;
+      transform_point_t c;
+
+      for (j = i+1; (j < block->index_max) && (keys[j] == keys[i]); ++j) {
+        if (a->result && (grid->mode == transform_voxel_centroid)) {
+          const transform_point_t* p = &a->points[indices[j]];
+
+          s_x += p->x-p_0->x;
+          s_y += p->y-p_0->y;
+          s_z += p->z-p_0->z;
+        }
+      }
+
+      if (a->result) {
+        transform_point_init(&c, p_0->x+s_x/(j-i), p_0->y+s_y/(j-i),
+          p_0->z+s_z/(j-i));
+        transform_voxel_get_point(a->transform, &c,
+          &a->result[block->offset+block->num_finite]);
+      }
+      ++block->num_finite;
+    }
+  }
+}
+
+static ssize_t transform_voxel_grid_run(thread_pool_t* pool,
+    transform_voxel_grid_t* grid, const double (*transform)[4], const
+    transform_point_t* points, size_t num_points, transform_point_t* result) {
+  transform_voxel_arg_t arg;
+  uint64_t key_or = 0, key_and = TRANSFORM_VOXEL_KEY_NONE;
+  size_t num_keys, num_voxels = 0, i, k;
+  int error = TRANSFORM_VOXEL_ERROR_NONE;
+
+  error_clear(&grid->error);
+
+  if (!(grid->voxel_size > 0.0) || !isfinite(1.0/grid->voxel_size)) {
+    error_set(&grid->error, TRANSFORM_VOXEL_ERROR_SIZE);
+    return -TRANSFORM_VOXEL_ERROR_SIZE;
+  }
+
+  if (num_points > grid->capacity) {
+    grid->keys = realloc(grid->keys, num_points*sizeof(uint64_t));
+    grid->indices = realloc(grid->indices, num_points*sizeof(size_t));
+    grid->sorted_keys = realloc(grid->sorted_keys, num_points*
+      sizeof(uint64_t));
+    grid->sorted_indices = realloc(grid->sorted_indices, num_points*
+      sizeof(size_t));
+    grid->capacity = num_points;
+  }
+
+  arg.grid = grid;
+  arg.transform = transform;
+  arg.points = points;
+  arg.result = 0;
+  arg.scale = 1.0/grid->voxel_size;
+  arg.origin[0] = arg.origin[1] = arg.origin[2] = 0.0;
+
+  for (i = 0; i < num_points; ++i) {
+    transform_point_t p;
+
+    transform_voxel_get_point(transform, &points[i], &p);
+    if (isfinite(p.x) && isfinite(p.y) && isfinite(p.z)) {
+      arg.origin[0] = floor(p.x*arg.scale);
+      arg.origin[1] = floor(p.y*arg.scale);
+      arg.origin[2] = floor(p.z*arg.scale);
+      break;
+    }
+  }
+
+  arg.blocks = transform_voxel_get_blocks(pool, num_points, &arg.num_blocks);
+  transform_voxel_for(pool, transform_voxel_get_keys_range, &arg,
+    arg.num_blocks);
+
+  num_keys = transform_voxel_merge_bounds(arg.blocks, arg.num_blocks,
+    &grid->min, &grid->max);
+  for (k = 0; k < arg.num_blocks; ++k) {
+    key_or |= arg.blocks[k].key_or;
+    key_and &= arg.blocks[k].key_and;
+    if (arg.blocks[k].error)
+      error = arg.blocks[k].error;
+  }
+
+  if (!error) {
+    transform_voxel_sort(pool, &arg, key_or & ~key_and);
+
+    for (k = 0; k < arg.num_blocks; ++k) {
+      size_t index_min = k*num_keys/arg.num_blocks;
+
+      while ((index_min > 0) && (index_min < num_keys) &&
+          (grid->keys[index_min] == grid->keys[index_min-1]))
+        ++index_min;
+
+      arg.blocks[k].index_min = index_min;
+      if (k > 0)
+        arg.blocks[k-1].index_max = index_min;
+    }
+    arg.blocks[arg.num_blocks-1].index_max = num_keys;
+
+    transform_voxel_for(pool, transform_voxel_reduce_range, &arg,
+      arg.num_blocks);
+    for (k = 0; k < arg.num_blocks; ++k) {
+      arg.blocks[k].offset = num_voxels;
+      num_voxels += arg.blocks[k].num_finite;
+    }
+
+    arg.result = result;
+    transform_voxel_for(pool, transform_voxel_reduce_range, &arg,
+      arg.num_blocks);
+  }
+  else
+    error_set(&grid->error, error);
+
+  free(arg.blocks);
+
+  return grid->error.code ? -grid->error.code : num_voxels;
+}
+
+ssize_t transform_voxel_grid_filter(transform_voxel_grid_t* grid, const
+    transform_point_t* points, size_t num_points, transform_point_t* result) {
+  return transform_voxel_grid_run(0, grid, 0, points, num_points, result);
+}
+
+ssize_t transform_voxel_grid_filter_parallel(thread_pool_t* pool,
+    transform_voxel_grid_t* grid, const transform_point_t* points, size_t
+    num_points, transform_point_t* result) {
+  return transform_voxel_grid_run(pool, grid, 0, points, num_points,
+    result);
+}
+
+ssize_t transform_voxel_grid_filter_transform(transform_voxel_grid_t* grid,
+    transform_t transform, const transform_point_t* points, size_t
+    num_points, transform_point_t* result) {
+  return transform_voxel_grid_run(0, grid, (const double (*)[4])transform,
+    points, num_points, result);
+}
+
+ssize_t transform_voxel_grid_filter_transform_parallel(thread_pool_t* pool,
+    transform_voxel_grid_t* grid, transform_t transform, const
+    transform_point_t* points, size_t num_points, transform_point_t*
+    result) {
+  return transform_voxel_grid_run(pool, grid, (const double (*)[4])
+    transform, points, num_points, result);
+}
@@ -0,0 +1,235 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_VOXEL_H
+#define TRANSFORM_VOXEL_H
+
+/** \file transform/voxel.h
+  * \ingroup transform
+  * \brief Voxel grid filter for the linear transformation module
+  * \author Ralf Kaestner
+  *
+  * A voxel grid filter downsamples an array of points by partitioning
+  * space into cubic voxels and reducing the points within each voxel to
+  * their centroid or to the first of them. The points are bucketed by
+  * sorting their voxel keys with a least-significant digit radix sort,
+  * skipping digits on which all keys agree. All passes over the points
+  * may be distributed across the threads of a pool. The pool is taken
+  * from the caller, and concurrent callers must not share it, since its
+  * work is submitted through thread_pool_for().
+  *
+  * The filter optionally transforms the points before downsampling. Since
+  * affine transforms preserve centroids, the points are transformed for
+  * computing their voxel keys and bounding box only, and only the reduced
+  * points are written, such that the array of points is read twice and
+  * never written in full.
+  */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "transform/transform.h"
+
+#include "thread/pool.h"
+
+#include "error/error.h"
+
+/** \name Constants
+  * \brief Predefined voxel grid constants
+  */
+//@{
+#define TRANSFORM_VOXEL_MAX_INDEX          ((1 << 20)-1)
+//!< The maximum voxel distance from the voxel of the first point
+#define TRANSFORM_VOXEL_PARALLEL_MIN_POINTS 16384
+//!< The minimum number of points processed by each thread of a pool
+//@}
+
+/** \name Error Codes
+  * \brief Predefined voxel grid error codes
+  */
+//@{
+#define TRANSFORM_VOXEL_ERROR_NONE         0
+//!< Success
+#define TRANSFORM_VOXEL_ERROR_SIZE         1
+//!< Invalid voxel size
+#define TRANSFORM_VOXEL_ERROR_RANGE        2
+//!< Voxel grid range exceeded
+//@}
+
+/** \brief Predefined voxel grid error descriptions
+  */
+extern const char* transform_voxel_errors[];
+
+/** \brief Voxel reduction mode
+  */
+typedef enum {
+  transform_voxel_centroid,       //!< Centroid of the points in a voxel.
+  transform_voxel_first,          //!< First point in a voxel.
+} transform_voxel_mode_t;
+
+/** \brief Structure defining a voxel grid filter
+  *
+  * The filter retains its working memory between invocations.
+  */
+typedef struct transform_voxel_grid_t {
+  double voxel_size;              //!< The edge length of the voxels.
+  transform_voxel_mode_t mode;    //!< The reduction mode of the filter.
+
+  uint64_t* keys;                 //!< The voxel keys of the points.
+  size_t* indices;                //!< The indices of the points.
+  uint64_t* sorted_keys;          //!< The sorting buffer of the keys.
+  size_t* sorted_indices;         //!< The sorting buffer of the indices.
+  size_t capacity;                //!< The capacity of the buffers.
+
+  transform_point_t min;          //!< The minimum of the filtered points.
+  transform_point_t max;          //!< The maximum of the filtered points.
+
+  error_t error;                  //!< The most recent voxel grid error.
+} transform_voxel_grid_t;
+
+/** \brief Initialize a voxel grid filter
+  * \param[in] grid The voxel grid filter to be initialized.
+  * \param[in] voxel_size The edge length of the voxels.
+  * \param[in] mode The reduction mode of the filter.
+  */
+void transform_voxel_grid_init(
+  transform_voxel_grid_t* grid,
+  double voxel_size,
+  transform_voxel_mode_t mode);
+
+/** \brief Destroy a voxel grid filter
+  * \param[in] grid The voxel grid filter to be destroyed.
+  */
+void transform_voxel_grid_destroy(
+  transform_voxel_grid_t* grid);
+
+/** \brief Downsample an array of points
+  * \param[in,out] grid The voxel grid filter to be applied.
+  * \param[in] points The array of points to be downsampled.
+  * \param[in] num_points The number of points in the array.
+  * \param[out] result The array of reduced points, which must provide
+  *   space for num_points points and must not overlap the input array.
+  * \return The number of reduced points or the negative error code.
+  *
+  * The reduced points are ordered by voxel. Points with non-finite
+  * components are discarded. On success, the bounding box of the finite
+  * points is recorded with the filter.
+  */
+ssize_t transform_voxel_grid_filter(
+  transform_voxel_grid_t* grid,
+  const transform_point_t* points,
+  size_t num_points,
+  transform_point_t* result);
+
+/** \brief Downsample an array of points in parallel
+  * \param[in] pool The thread pool used for downsampling the points.
+  * \param[in,out] grid The voxel grid filter to be applied.
+  * \param[in] points The array of points to be downsampled.
+  * \param[in] num_points The number of points in the array.
+  * \param[out] result The array of reduced points, which must provide
+  *   space for num_points points and must not overlap the input array.
+  * \return The number of reduced points or the negative error code.
+  *
+  * The result is identical to transform_voxel_grid_filter().
+  */
+ssize_t transform_voxel_grid_filter_parallel(
+  thread_pool_t* pool,
+  transform_voxel_grid_t* grid,
+  const transform_point_t* points,
+  size_t num_points,
+  transform_point_t* result);
+
+/** \brief Transform and downsample an array of points
+  * \param[in,out] grid The voxel grid filter to be applied.
+  * \param[in] transform The affine transform to apply to the points
+  *   before downsampling.
+  * \param[in] points The array of points to be transformed and
+  *   downsampled.
+  * \param[in] num_points The number of points in the array.
+  * \param[out] result The array of reduced transformed points, which must
+  *   provide space for num_points points and must not overlap the input
+  *   array.
+  * \return The number of reduced points or the negative error code.
+  *
+  * The voxels are aligned with the target frame of the transform, and
+  * the recorded bounding box refers to the transformed points.
+  */
+ssize_t transform_voxel_grid_filter_transform(
+  transform_voxel_grid_t* grid,
+  transform_t transform,
+  const transform_point_t* points,
+  size_t num_points,
+  transform_point_t* result);
+
+/** \brief Transform and downsample an array of points in parallel
+  * \param[in] pool The thread pool used for processing the points.
+  * \param[in,out] grid The voxel grid filter to be applied.
+  * \param[in] transform The affine transform to apply to the points
+  *   before downsampling.
+  * \param[in] points The array of points to be transformed and
+  *   downsampled.
+  * \param[in] num_points The number of points in the array.
+  * \param[out] result The array of reduced transformed points, which must
+  *   provide space for num_points points and must not overlap the input
+  *   array.
+  * \return The number of reduced points or the negative error code.
+  *
+  * The result is identical to transform_voxel_grid_filter_transform().
+  */
+ssize_t transform_voxel_grid_filter_transform_parallel(
+  thread_pool_t* pool,
+  transform_voxel_grid_t* grid,
+  transform_t transform,
+  const transform_point_t* points,
+  size_t num_points,
+  transform_point_t* result);
+
+/** \brief Compute the bounding box of an array of points
+  * \param[in] points The array of points.
+  * \param[in] num_points The number of points in the array.
+  * \param[out] min The minimum components of the finite points.
+  * \param[out] max The maximum components of the finite points.
+  * \return The number of finite points in the array.
+  *
+  * If the array contains no finite points, the minimum will be positive
+  * and the maximum negative infinity.
+  */
+size_t transform_voxel_get_bounds(
+  const transform_point_t* points,
+  size_t num_points,
+  transform_point_t* min,
+  transform_point_t* max);
+
+/** \brief Compute the bounding box of an array of points in parallel
+  * \param[in] pool The thread pool used for processing the points.
+  * \param[in] points The array of points.
+  * \param[in] num_points The number of points in the array.
+  * \param[out] min The minimum components of the finite points.
+  * \param[out] max The maximum components of the finite points.
+  * \return The number of finite points in the array.
+  */
+size_t transform_voxel_get_bounds_parallel(
+  thread_pool_t* pool,
+  const transform_point_t* points,
+  size_t num_points,
+  transform_point_t* min,
+  transform_point_t* max);
+
+#endif